@@ -1,3 +1,8 @@
+newoption {
+	trigger = "profiler",
+	description = "Compile in the CPU profiler and its window",
+}
+
 workspace "voxel-game"
 	architecture "x86_64"
 	configurations { "Debug", "Release" }
@@ -35,6 +40,7 @@ project "voxel-game"
 		"glfw3.lib",
 		"imgui.lib",
 		"stb.lib",
+		"ws2_32.lib",
 	}
 
 	targetdir "bin"
@@ -49,3 +55,90 @@ project "voxel-game"
 	filter "configurations:Release"
 		optimize "on"
 		symbols "off"
+
+	filter "options:profiler"
+		defines { "ENABLE_PROFILER" }
+
+project "tests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+
+	files {
+		"tests/*.cpp",
+		"tests/*.h",
+		"src/renderer/ResolutionController.cpp",
+		"src/utility/ChunkAllocator.cpp",
+		"src/utility/Config.cpp",
+		"src/utility/Frustum.cpp",
+		"src/utility/IO.cpp",
+		"src/utility/JobSystem.cpp",
+		"src/utility/Noise.cpp",
+		"src/world/ChunkCompression.cpp",
+		"src/world/ChunkLighting.cpp",
+		"src/world/ChunkLoadQueue.cpp",
+		"src/world/ChunkStore.cpp",
+		"src/world/CoarseDepth.cpp",
+	}
+
+	includedirs {
+		"vendor/fastnoiselite/include",
+		"vendor/glm/include",
+		"vendor/toml++/include",
+	}
+
+	targetdir "bin"
+	objdir "obj/%{cfg.buildcfg}/%{prj.name}"
+
+	filter "configurations:Debug"
+		targetname "%{prj.name}d"
+		optimize "off"
+		symbols "on"
+
+	filter "configurations:Release"
+		optimize "on"
+		symbols "off"
+
+project "benchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+
+	files {
+		"tests/benchmarks/*.cpp",
+	}
+
+	targetdir "bin"
+	objdir "obj/%{cfg.buildcfg}/%{prj.name}"
+
+	filter "configurations:Debug"
+		targetname "%{prj.name}d"
+		optimize "off"
+		symbols "on"
+
+	filter "configurations:Release"
+		optimize "on"
+		symbols "off"
+
+project "captures"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	dependson { "voxel-game" }
+
+	files {
+		"tests/captures/*.cpp",
+	}
+
+	targetdir "bin"
+	objdir "obj/%{cfg.buildcfg}/%{prj.name}"
+	debugdir "."
+
+	filter "configurations:Debug"
+		targetname "%{prj.name}d"
+		optimize "off"
+		symbols "on"
+
+	filter "configurations:Release"
+		optimize "on"
+		symbols "off"
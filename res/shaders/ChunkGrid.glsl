@@ -0,0 +1,32 @@
+#ifndef __CHUNK_GRID_GLSL__
+#define __CHUNK_GRID_GLSL__
+
+struct ChunkDirectoryHeaderData
+{
+	// xyz -> coordinate of the first chunk
+	ivec4 Origin;
+
+	// xyz -> size of the grid in chunks
+	ivec4 Size;
+};
+
+layout(binding = 1, std430) readonly buffer ChunkDirectoryStorage
+{
+	ChunkDirectoryHeaderData ChunkDirectoryHeader;
+
+	// x -> offset of the chunk data, -1 if it is not loaded or empty, -2 if it is solid, y -> LOD or the material of a solid chunk,
+	// z -> offset of the baked lighting, w -> offset of the first leaf
+	ivec4 ChunkDirectory[];
+};
+
+const int EMPTY_CHUNK_OFFSET = -1;
+const int SOLID_CHUNK_OFFSET = -2;
+
+ivec4 GetChunkDirectoryEntry(ivec3 localCoordinate)
+{
+	ivec3 size = ChunkDirectoryHeader.Size.xyz;
+
+	return ChunkDirectory[(localCoordinate.y * size.z + localCoordinate.z) * size.x + localCoordinate.x];
+}
+
+#endif // __CHUNK_GRID_GLSL__
@@ -0,0 +1,102 @@
+#ifndef __COARSE_DEPTH_GLSL__
+#define __COARSE_DEPTH_GLSL__
+
+#include "ChunkGrid.glsl"
+
+layout(binding = 2, std430) readonly buffer CoarseOccupancyStorage
+{
+	// The dilated coarse occupancy of every chunk of the directory, indexed the same way. x -> low 32 cells, y -> high 32 cells.
+	uvec2 CoarseOccupancy[];
+};
+
+// Distance the rays of an 8*8 tile may start at, -1 if none of them can hit anything
+layout(binding = 2, r32f) uniform image2D u_coarseDistance;
+
+const int COARSE_CELL_SIZE = 8;
+const int COARSE_CELLS_PER_CHUNK = 4;
+
+// Marches the coarse cells along the central ray of a bundle and stops at the first dilated occupied cell.
+// Mirrored on the CPU by 'TraceCoarseDistance' in 'CoarseDepth.h', they must be kept in sync.
+float TraceCoarseDistance(vec3 rayOrigin, vec3 rayDirection, float sinHalfAngle)
+{
+	ivec3 gridOrigin = ChunkDirectoryHeader.Origin.xyz;
+	ivec3 gridSize = ChunkDirectoryHeader.Size.xyz;
+
+	// The dilation reaches one cell past the grid
+	ivec3 firstCell = gridOrigin * COARSE_CELLS_PER_CHUNK - 1;
+	ivec3 cellCount = gridSize * COARSE_CELLS_PER_CHUNK + 2;
+
+	vec3 rayDirectionInverse = vec3(1.0) / rayDirection;
+	vec3 t0 = (vec3(firstCell) * COARSE_CELL_SIZE - rayOrigin) * rayDirectionInverse;
+	vec3 t1 = (vec3(firstCell + cellCount) * COARSE_CELL_SIZE - rayOrigin) * rayDirectionInverse;
+	vec3 tMin = min(t0, t1);
+	vec3 tMax = max(t0, t1);
+
+	float nearest = max(max(tMin.x, tMin.y), tMin.z);
+	float furthest = min(min(tMax.x, tMax.y), tMax.z);
+	if(furthest < 0.0 || nearest > furthest)
+	{
+		return -1.0;
+	}
+
+	// Beyond this distance a ray of the bundle may pass further than a cell from the central ray
+	float maxDistance = (sinHalfAngle > 0.0) ? float(COARSE_CELL_SIZE) / sinHalfAngle : 1e30;
+
+	float distance = max(nearest, 0.0);
+
+	vec3 entryPoint = rayOrigin + rayDirection * distance;
+	ivec3 cell = clamp(ivec3(floor(entryPoint / COARSE_CELL_SIZE)), firstCell, firstCell + cellCount - 1);
+
+	ivec3 stepDirection = ivec3(sign(rayDirection));
+
+	vec3 deltaDistance = abs(vec3(COARSE_CELL_SIZE) / rayDirection);
+	vec3 nextDistance = (vec3(cell + max(stepDirection, ivec3(0))) * COARSE_CELL_SIZE - rayOrigin) / rayDirection;
+	nextDistance = mix(nextDistance, vec3(1e30), equal(stepDirection, ivec3(0)));
+
+	ivec3 innerMin = gridOrigin * COARSE_CELLS_PER_CHUNK;
+	ivec3 innerMax = (gridOrigin + gridSize) * COARSE_CELLS_PER_CHUNK - 1;
+
+	while(true)
+	{
+		if(distance > maxDistance)
+		{
+			return maxDistance;
+		}
+
+		ivec3 localCell = cell - firstCell;
+		if(any(lessThan(localCell, ivec3(0))) || any(greaterThanEqual(localCell, cellCount)))
+		{
+			return -1.0;
+		}
+
+		// The cells around the grid read the closest cell inside, whose neighbourhood covers theirs within the grid
+		ivec3 innerCell = clamp(cell, innerMin, innerMax) - innerMin;
+		ivec3 chunk = innerCell / COARSE_CELLS_PER_CHUNK;
+		ivec3 cellInChunk = innerCell % COARSE_CELLS_PER_CHUNK;
+
+		uvec2 occupancy = CoarseOccupancy[(chunk.y * gridSize.z + chunk.z) * gridSize.x + chunk.x];
+		uint bitIndex = uint((cellInChunk.z * COARSE_CELLS_PER_CHUNK + cellInChunk.y) * COARSE_CELLS_PER_CHUNK + cellInChunk.x);
+		uint bits = (bitIndex < 32) ? occupancy.x : occupancy.y;
+		if((bits & (1u << (bitIndex % 32))) != 0)
+		{
+			return distance;
+		}
+
+		if(min(min(nextDistance.x, nextDistance.y), nextDistance.z) > furthest)
+		{
+			return -1.0;
+		}
+
+		int axis = (nextDistance.x < nextDistance.y)
+			? ((nextDistance.x < nextDistance.z) ? 0 : 2)
+			: ((nextDistance.y < nextDistance.z) ? 1 : 2);
+
+		distance = nextDistance[axis];
+		nextDistance[axis] += deltaDistance[axis];
+		cell[axis] += stepDirection[axis];
+	}
+
+	return -1.0;
+}
+
+#endif // __COARSE_DEPTH_GLSL__
@@ -79,4 +79,51 @@ bool GetVoxel(ivec3 coordinate, uint offset, uint lod)
 	return true;
 }
 
+// Descends from a node to one of its leaves, preferring the upper children since they are more likely to be on the surface.
+// Returns the index of the leaf, which holds the material.
+uint GetNodeLeaf(uint headIndex, uint parentIndex, uint childIndexInParent, uint nodeHalfSize)
+{
+	while(nodeHalfSize > 0)
+	{
+		uint childMask = GetByte(headIndex);
+		uint upperChildMask = childMask & 0xCC;
+
+		uint childIndex = uint(findMSB(upperChildMask != 0 ? upperChildMask : childMask));
+
+		uint skipCount =
+			PopCountByte(GetByte(parentIndex), childIndexInParent + 1, 8) + // The number of children on the same layer after the current.
+			PopCountRange(parentIndex + 1, headIndex) + // The number of nodes between the head and parent.
+			PopCountByte(childMask, 0, childIndex) + // The number of children of head.
+			1; // The head.
+
+		childIndexInParent = childIndex;
+
+		parentIndex = headIndex;
+		headIndex += skipCount;
+
+		nodeHalfSize /= 2;
+	}
+
+	return headIndex;
+}
+
+// Reads the lighting baked by 'BakeChunkLighting' in 'ChunkLighting.cpp', 3 bytes per leaf.
+// x -> sky visibility, y -> the occlusion of the corners interpolated at a point inside the voxel
+vec2 GetLeafLighting(uint lightingIndex, vec3 pointInVoxel)
+{
+	float skyVisibility = float(GetByte(lightingIndex)) / 255.0;
+	uint cornerOcclusion = GetByte(lightingIndex + 1) | (GetByte(lightingIndex + 2) << 8);
+
+	float occlusion = 0.0;
+	for(uint corner = 0; corner < 8; ++corner)
+	{
+		vec3 cornerOffset = vec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+		vec3 weights = mix(1.0 - pointInVoxel, pointInVoxel, cornerOffset);
+
+		occlusion += weights.x * weights.y * weights.z * float((cornerOcclusion >> (corner * 2)) & 3) / 3.0;
+	}
+
+	return vec2(skyVisibility, occlusion);
+}
+
 #endif // __OCTREE_GLSL__
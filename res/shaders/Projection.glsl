@@ -0,0 +1,35 @@
+#ifndef __PROJECTION_GLSL__
+#define __PROJECTION_GLSL__
+
+layout(binding = 0, std140) uniform ProjectionProperties
+{
+	mat4 View;
+	mat4 ViewInv;
+	mat4 Proj;
+	mat4 ProjInv;
+} u_projectionProperties;
+
+layout(binding = 1, std140) uniform ScreenProperties
+{
+	uvec2 Size;
+	// The first pixel of the traced rectangle
+	uvec2 Offset;
+	// The position of the rays in their pixels, between 0 and 1
+	vec2 Jitter;
+} u_screenProperties;
+
+vec3 GetRayDirection(vec2 uv)
+{
+	uv = uv * 2.0 - 1.0;
+
+	vec4 pointNDSH = vec4(uv, -1.0, 1.0);
+
+	vec4 eyeDir = u_projectionProperties.ProjInv * pointNDSH;
+	eyeDir.w = 0.0;
+
+	vec3 worldDir = (u_projectionProperties.ViewInv * eyeDir).xyz;
+
+	return normalize(worldDir);
+}
+
+#endif // __PROJECTION_GLSL__
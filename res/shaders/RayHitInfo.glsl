@@ -7,6 +7,9 @@ struct RayHitInfo
 	vec4 Point;
 	vec2 UV;
 	uint Normal;
+	uint Material;
+	// x -> sky visibility, y -> ambient occlusion
+	vec2 Lighting;
 };
 
 const uint NormalXY = 2;
@@ -3,11 +3,12 @@
 layout(location = 0) in vec2 UV;
 layout(location = 0) out vec4 Color;
 
-layout(binding = 0) uniform sampler2D u_renderedTexture;
+// The reconstructed frame at the window's resolution
+layout(binding = 4) uniform sampler2D u_outputTexture;
 
 void main()
 {
-	vec3 color = texture(u_renderedTexture, UV).rgb;
+	vec3 color = texture(u_outputTexture, UV).rgb;
 
 	Color = vec4(color, 1.0);
 }
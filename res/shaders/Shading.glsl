@@ -15,18 +15,41 @@ const float NormalLightStrength[3] = {
 	0.6,
 };
 
-float CalculateLightStrength(uint normal)
+// The light left on surfaces which can't see the sky or in fully occluded corners
+const float MinSkyVisibilityLight = 0.25;
+const float MinOcclusionLight = 0.45;
+
+// Indexed by the voxel's material, matches 'Material' in 'Chunk.h'. xyz -> tint, w -> how much of the texture's own color is kept
+const vec4 MaterialColors[7] = {
+	vec4(1.00, 1.00, 1.00, 1.00), // Air
+	vec4(0.55, 0.55, 0.58, 0.00), // Stone
+	vec4(0.55, 0.40, 0.25, 0.00), // Dirt
+	vec4(1.00, 1.00, 1.00, 1.00), // Grass
+	vec4(0.90, 0.82, 0.55, 0.00), // Sand
+	vec4(0.45, 0.30, 0.15, 0.00), // Wood
+	vec4(0.25, 0.55, 0.20, 0.00), // Leaves
+};
+
+float CalculateLightStrength(RayHitInfo hitInfo)
 {
-	return NormalLightStrength[normal];
+	return
+		NormalLightStrength[hitInfo.Normal] *
+		mix(MinSkyVisibilityLight, 1.0, hitInfo.Lighting.x) *
+		mix(MinOcclusionLight, 1.0, hitInfo.Lighting.y);
 }
 
 vec3 Shade(RayHitInfo hitInfo)
 {
-	float lightStrength = CalculateLightStrength(hitInfo.Normal);
+	float lightStrength = CalculateLightStrength(hitInfo);
 
 	vec3 light = (SunLight.xyz * SunLight.w + SkyLight.xyz * SkyLight.w) * lightStrength;
 	vec3 textureColor = texture(u_terrain, hitInfo.UV).rgb;
 
+	// Other materials reuse the detail of the texture
+	vec4 materialColor = MaterialColors[min(hitInfo.Material, uint(MaterialColors.length() - 1))];
+	float luminance = dot(textureColor, vec3(0.299, 0.587, 0.114));
+	textureColor = mix(vec3(luminance * 2.0) * materialColor.rgb, textureColor, materialColor.w);
+
 	return textureColor * light;
 }
 
@@ -0,0 +1,23 @@
+@echo off
+rem Runs the capture tests on Mesa's software rasterizer, so CI machines without a GPU render the same images.
+rem Usage: RunCaptureTests.bat <directory of the x64 Mesa DLLs> [--update]
+if "%~1"=="" (
+	echo Usage: %~nx0 ^<directory of the x64 Mesa DLLs^> [--update]
+	exit /b 1
+)
+
+pushd %~dp0\..\
+
+rem Mesa's opengl32.dll, libEGL.dll and osmesa.dll next to the game take precedence over the system's drivers
+copy /y "%~1\*.dll" bin\ >nul || (popd & exit /b 1)
+
+set GALLIUM_DRIVER=llvmpipe
+rem llvmpipe only reports OpenGL 4.5 without the override
+set MESA_GL_VERSION_OVERRIDE=4.6
+set MESA_GLSL_VERSION_OVERRIDE=460
+
+bin\captures.exe %2
+set RESULT=%ERRORLEVEL%
+
+popd
+exit /b %RESULT%
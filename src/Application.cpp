@@ -1,14 +1,22 @@
 #include "Application.h"
 
+#include "Benchmark.h"
+#include "RenderCapture.h"
+#include "renderer/GpuTimer.h"
 #include "renderer/GUI.h"
+#include "renderer/ProfilerWindow.h"
 #include "renderer/Renderer.h"
 #include "renderer/Window.h"
 #include "world/Camera.h"
+#include "world/CameraPath.h"
 #include "world/Chunk.h"
 #include "world/World.h"
 #include "utility/ChunkAllocator.h"
 #include "utility/Config.h"
 #include "utility/Input.h"
+#include "utility/IO.h"
+#include "utility/JobSystem.h"
+#include "utility/Profiler.h"
 #include "utility/Time.h"
 #include "scripts/CameraController.h"
 
@@ -17,22 +25,93 @@
 #include <glm/ext.hpp>
 #include <imgui/imgui.h>
 
-Application::Application()
+#include <cstdio>
+#include <optional>
+#include <span>
+
+namespace
+{
+	/**
+	 * @brief The time between two recorded camera keyframes in seconds.
+	 */
+	constexpr float CameraPathTimeStep = 1.0f / 60.0f;
+}
+
+Application::Application(const LaunchOptions& options)
+	: m_options(options)
 {
 	Config::Load();
+	JobSystem::Initialize();
+	PROFILE_THREAD_NAME("Main");
+
+	// Captures render offscreen at the full resolution, the dynamic resolution would make them depend on the frame times
+	WindowSettings windowSettings = WindowSettings::LoadFromConfig();
+	RendererSettings rendererSettings = RendererSettings::LoadFromConfig();
+	if(!m_options.CapturePath.empty())
+	{
+		windowSettings.IsVisible = false;
+		rendererSettings.Resolution.TargetFrameTime = 0.0f;
+		rendererSettings.Resolution.MaxScale = 1.0f;
+	}
 
-	m_window = std::make_unique<Window>(WindowSettings::LoadFromConfig());
-	m_renderer = std::make_unique<Renderer>(RendererSettings::LoadFromConfig(), *m_window);
+	// The workers read the renderer's files while the window and its context are created
+	FileBatch rendererFiles = Renderer::ReadFiles();
+	m_window = std::make_unique<Window>(windowSettings);
+	m_renderer = std::make_unique<Renderer>(rendererSettings, *m_window, rendererFiles);
 	Input::Initialize(*m_window);
 	GUI::Initialize(*m_window);
 
-	m_world = std::make_unique<World>(WorldSettings::LoadFromConfig(), m_renderer->GetChunkAllocator());
+#if defined(ENABLE_PROFILER)
+	ProfilerWindow::Initialize(m_options.TracePath.empty() ? std::filesystem::path("trace.json") : m_options.TracePath);
+#endif
+
+	// A replay needs the world it was recorded in, a capture views it from the start of the path
+	WorldSettings worldSettings = WorldSettings::LoadFromConfig();
+	if(!m_options.CapturePath.empty())
+	{
+		std::optional<CameraKeyframe> view;
+		if(!m_options.ReplayPath.empty())
+		{
+			CameraPath path = CameraPath::Load(m_options.ReplayPath);
+			worldSettings.Seed = path.GetSeed();
+			view = path.Sample(0.0f);
+		}
+
+		m_capture = std::make_unique<RenderCapture>(CaptureSettings::LoadFromConfig(), m_options.CapturePath, m_options.GoldenPath, view);
+		GUI::IsVisible = false;
+
+		m_renderer->GetGpuTimer().OnFrameResolved += [&] (std::span<const GpuPassTime> times) -> void
+			{
+				m_capture->RecordGpuTimes(times);
+			};
+	}
+	else if(!m_options.ReplayPath.empty())
+	{
+		m_benchmark = std::make_unique<Benchmark>(CameraPath::Load(m_options.ReplayPath));
+		worldSettings.Seed = m_benchmark->GetPath().GetSeed();
+
+		m_renderer->GetGpuTimer().OnFrameResolved += [&] (std::span<const GpuPassTime> times) -> void
+			{
+				m_benchmark->RecordGpuTimes(times);
+			};
+	}
+
+	m_world = std::make_unique<World>(worldSettings, m_renderer->GetChunkAllocator());
+
+	if(!m_options.RecordPath.empty())
+	{
+		m_recordedPath = std::make_unique<CameraPath>(CameraPathTimeStep, m_world->GetSeed());
+	}
 
 	m_cameraController = std::make_unique<CameraController>(m_world->GetCamera());
 }
 
 Application::~Application()
 {
+	// The world's jobs must finish before the workers stop.
+	m_world.reset();
+	JobSystem::Shutdown();
+
 	GUI::Destroy();
 	Config::Save();
 }
@@ -42,21 +121,81 @@ auto Application::Run() -> void
 	Time::Reset();
 	while(!m_window->GetShouldClose())
 	{
+		PROFILE_SCOPE("Frame");
+
 		Time::Tick();
 		Input::Poll();
+		Config::Update();
 
 		m_renderer->BeginFrame();
 
 		if(GUI::IsVisible)
 		{
+			PROFILE_SCOPE("GUI");
+
 			GUI::OnGui(m_window->GetSize());
 		}
 
-		m_cameraController->Update();
+		if(m_capture != nullptr)
+		{
+			if(!m_capture->Update(*m_world, *m_renderer))
+			{
+				break;
+			}
+		}
+		else if(m_benchmark != nullptr)
+		{
+			if(!m_benchmark->Update(*m_world))
+			{
+				break;
+			}
+		}
+		else
+		{
+			m_cameraController->Update();
+		}
+
+		if(m_recordedPath != nullptr)
+		{
+			m_recordedPath->Record(Time::GetElapsedTime(), m_world->GetCamera());
+		}
 
 		m_renderer->UpdateProjectionData(m_world->GetCamera());
 		m_world->Update();
 
 		m_renderer->EndFrame();
 	}
+
+	if(m_recordedPath != nullptr)
+	{
+		m_recordedPath->Save(m_options.RecordPath);
+	}
+
+	if(m_benchmark != nullptr)
+	{
+		m_benchmark->WriteReport(m_options.ReportPath);
+
+		printf("Benchmark report written to '%s'\n", m_options.ReportPath.string().c_str());
+	}
+
+	if(!m_options.TracePath.empty())
+	{
+#if defined(ENABLE_PROFILER)
+		if(Profiler::WriteChromeTrace(m_options.TracePath))
+		{
+			printf("Profiler trace written to '%s'\n", m_options.TracePath.string().c_str());
+		}
+		else
+		{
+			printf("Couldn't write the profiler trace to '%s'\n", m_options.TracePath.string().c_str());
+		}
+#else
+		printf("The profiler isn't compiled in, regenerate the project with 'premake5 --profiler'\n");
+#endif
+	}
+}
+
+auto Application::GetExitCode() const noexcept -> int
+{
+	return (m_capture != nullptr && !m_capture->HasPassed()) ? 1 : 0;
 }
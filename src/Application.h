@@ -1,7 +1,12 @@
 #pragma once
 
+#include "LaunchOptions.h"
+
 #include <memory>
 
+class Benchmark;
+class CameraPath;
+class RenderCapture;
 class Renderer;
 class Window;
 class World;
@@ -10,7 +15,7 @@ class CameraController;
 class Application
 {
 public:
-	Application();
+	Application(const LaunchOptions& options);
 	~Application();
 
 	Application(const Application&) = delete;
@@ -21,9 +26,21 @@ public:
 
 	auto Run() -> void;
 
+	/**
+	 * @brief Retrieves the exit code of the process.
+	 *
+	 * @return 1 if a capture failed, otherwise 0.
+	 */
+	[[nodiscard]] auto GetExitCode() const noexcept -> int;
+
 private:
 	std::unique_ptr<Window> m_window;
 	std::unique_ptr<Renderer> m_renderer;
 	std::unique_ptr<World> m_world;
 	std::unique_ptr<CameraController> m_cameraController;
+
+	LaunchOptions m_options;
+	std::unique_ptr<CameraPath> m_recordedPath;
+	std::unique_ptr<Benchmark> m_benchmark;
+	std::unique_ptr<RenderCapture> m_capture;
 };
@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+
+#include "utility/Time.h"
+
+#include <toml++/toml.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <string_view>
+
+namespace
+{
+	/**
+	 * @brief Picks a percentile of sorted values by the nearest rank.
+	 *
+	 * @param values The sorted values, must not be empty.
+	 * @param percentile The percentile in the range [0, 1].
+	 *
+	 * @return The value at the percentile.
+	 */
+	auto GetPercentile(const std::vector<float>& values, float percentile) -> double
+	{
+		size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<float>(values.size())));
+
+		return static_cast<double>(values[std::clamp<size_t>(rank, 1u, values.size()) - 1u]);
+	}
+
+	/**
+	 * @brief Summarizes a series of times.
+	 *
+	 * @param times The times.
+	 *
+	 * @return The mean, the 50th, 90th and 99th percentiles and the maximum, empty if there are no times.
+	 */
+	auto GetTimeSummary(std::vector<float> times) -> toml::table
+	{
+		std::ranges::sort(times);
+
+		toml::table summary;
+		if(!times.empty())
+		{
+			summary.insert("mean", static_cast<double>(std::accumulate(times.begin(), times.end(), 0.0f)) / static_cast<double>(times.size()));
+			summary.insert("p50", GetPercentile(times, 0.5f));
+			summary.insert("p90", GetPercentile(times, 0.9f));
+			summary.insert("p99", GetPercentile(times, 0.99f));
+			summary.insert("max", static_cast<double>(times.back()));
+		}
+
+		return summary;
+	}
+}
+
+Benchmark::Benchmark(CameraPath path)
+	: m_path(std::move(path))
+{
+
+}
+
+auto Benchmark::Update(World& world) -> bool
+{
+	// The first frame's time includes the loading before the replay started
+	if(m_isStarted)
+	{
+		m_frameTimes.push_back(Time::GetDeltaTime<float, std::milli>());
+		m_time += Time::GetDeltaTime();
+	}
+
+	m_isStarted = true;
+	m_statistics = world.GetStatistics();
+
+	if(!m_populateTime.has_value() && m_statistics.LoadedChunkCount > 0u && m_statistics.PendingChunkCount == 0u)
+	{
+		m_populateTime = m_time;
+	}
+
+	std::optional<CameraKeyframe> keyframe = m_path.Sample(m_time);
+	if(!keyframe.has_value())
+	{
+		return false;
+	}
+
+	world.GetCamera().Position = keyframe->Position;
+	world.GetCamera().Rotation = keyframe->Rotation;
+
+	return true;
+}
+
+auto Benchmark::RecordGpuTimes(std::span<const GpuPassTime> times) -> void
+{
+	for(const GpuPassTime& time : times)
+	{
+		auto it = std::ranges::find(m_gpuTimes, std::string_view(time.Name), &std::pair<std::string, std::vector<float>>::first);
+		if(it == m_gpuTimes.end())
+		{
+			it = m_gpuTimes.emplace(m_gpuTimes.end(), time.Name, std::vector<float>());
+		}
+
+		it->second.push_back(time.Milliseconds);
+	}
+}
+
+auto Benchmark::WriteReport(const std::filesystem::path& path) const -> void
+{
+	double duration = std::max(static_cast<double>(m_time), 1e-6);
+
+	toml::table report{
+		{ "seed", m_path.GetSeed() },
+		{ "duration", duration },
+		{ "frameCount", static_cast<int64_t>(m_frameTimes.size()) },
+		{ "frameTimeMs", GetTimeSummary(m_frameTimes) },
+		{ "chunksGeneratedPerSecond", static_cast<double>(m_statistics.GeneratedChunkCount) / duration },
+		{ "chunksLoadedPerSecond", static_cast<double>(m_statistics.GeneratedChunkCount + m_statistics.RestoredChunkCount) / duration },
+		// -1 if the view never had every chunk in range loaded
+		{ "timeToPopulate", m_populateTime.has_value() ? static_cast<double>(*m_populateTime) : -1.0 },
+	};
+
+	// Left out without a renderer or without timer queries, so the reports of those runs don't show zeros
+	if(!m_gpuTimes.empty())
+	{
+		toml::table gpuTimes;
+		for(const auto& [name, times] : m_gpuTimes)
+		{
+			gpuTimes.insert(name, GetTimeSummary(times));
+		}
+
+		report.insert("gpuPassTimeMs", std::move(gpuTimes));
+	}
+
+	std::ofstream file(path);
+
+	file << toml::json_formatter{ report } << std::endl;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "renderer/GpuTimer.h"
+#include "world/CameraPath.h"
+#include "world/World.h"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Replays a camera path and measures the frame times and the chunk streaming along it.
+ */
+class Benchmark
+{
+public:
+	/**
+	 * @brief Prepares the replay.
+	 *
+	 * The world must have been created with the seed of the path.
+	 *
+	 * @param path The camera path.
+	 */
+	explicit Benchmark(CameraPath path);
+
+	/**
+	 * @brief Records the last frame and moves the camera to the next point of the path.
+	 *
+	 * Must be called once per frame before the world is updated.
+	 *
+	 * @param world The world the path is replayed in.
+	 *
+	 * @return 'false' once the path ended, otherwise 'true'.
+	 */
+	auto Update(World& world) -> bool;
+
+	/**
+	 * @brief Records the GPU times of a frame's render passes.
+	 *
+	 * @param times The times of the passes, see @ref GpuTimer::OnFrameResolved.
+	 */
+	auto RecordGpuTimes(std::span<const GpuPassTime> times) -> void;
+
+	/**
+	 * @brief Writes the frame time percentiles, the chunk throughput and the time until the view was populated as JSON.
+	 *
+	 * The percentiles of the render passes' GPU times are included if any were recorded.
+	 *
+	 * @param path The path of the report file.
+	 */
+	auto WriteReport(const std::filesystem::path& path) const -> void;
+
+	[[nodiscard]] auto GetPath() const noexcept -> const CameraPath&
+	{
+		return m_path;
+	}
+
+private:
+	CameraPath m_path;
+
+	/**
+	 * @brief The duration of every replayed frame in milliseconds.
+	 */
+	std::vector<float> m_frameTimes;
+
+	/**
+	 * @brief The GPU times of every render pass in milliseconds, in the order the passes were first recorded.
+	 */
+	std::vector<std::pair<std::string, std::vector<float>>> m_gpuTimes;
+	float m_time = 0.0f;
+	bool m_isStarted = false;
+
+	/**
+	 * @brief The time of the first frame without pending chunks in seconds.
+	 */
+	std::optional<float> m_populateTime;
+	WorldStatistics m_statistics{};
+};
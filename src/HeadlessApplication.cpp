@@ -0,0 +1,183 @@
+#include "HeadlessApplication.h"
+
+#include "Benchmark.h"
+#include "renderer/Renderer.h"
+#include "world/World.h"
+#include "utility/ChunkAllocator.h"
+#include "utility/Config.h"
+#include "utility/JobSystem.h"
+#include "utility/Profiler.h"
+#include "utility/Time.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+HeadlessApplication::HeadlessApplication(const LaunchOptions& options)
+	: m_options(options)
+{
+	Config::Load();
+	JobSystem::Initialize();
+	PROFILE_THREAD_NAME("Main");
+
+	m_settings = HeadlessSettings::LoadFromConfig();
+
+	m_chunkData.resize(RendererSettings::LoadFromConfig().ChunkDataBufferSize);
+	m_chunkAllocator = std::make_unique<ChunkAllocator>(m_chunkData.size(), m_chunkData.data());
+
+	WorldSettings worldSettings = WorldSettings::LoadFromConfig();
+	if(!m_options.ReplayPath.empty())
+	{
+		m_benchmark = std::make_unique<Benchmark>(CameraPath::Load(m_options.ReplayPath));
+		worldSettings.Seed = m_benchmark->GetPath().GetSeed();
+	}
+
+	m_world = std::make_unique<World>(worldSettings, *m_chunkAllocator);
+}
+
+HeadlessApplication::~HeadlessApplication()
+{
+	// The world's jobs must finish before the workers stop.
+	m_world.reset();
+	JobSystem::Shutdown();
+}
+
+auto HeadlessApplication::Run() -> void
+{
+	using Clock = std::chrono::steady_clock;
+
+	Camera& camera = m_world->GetCamera();
+	camera.Rotation.x = 0.0f;
+
+	WorldStatistics lastStatistics = m_world->GetStatistics();
+	float lastReportTime = 0.0f;
+	uint64_t frameCount = 0u;
+
+	Time::Reset();
+	Clock::time_point frameEnd = Clock::now();
+	while(m_benchmark != nullptr || Time::GetElapsedTime() < m_settings.Duration)
+	{
+		PROFILE_SCOPE("Frame");
+
+		Time::Tick();
+
+		if(m_benchmark != nullptr)
+		{
+			if(!m_benchmark->Update(*m_world))
+			{
+				break;
+			}
+		}
+		else
+		{
+			// Fly forward while slowly turning, so new chunks keep coming into range from changing directions
+			float deltaTime = Time::GetDeltaTime();
+			camera.Rotation.y += m_settings.CameraTurnRate * deltaTime;
+			camera.Position += glm::quat(glm::radians(camera.Rotation)) * glm::vec3(0.0f, 0.0f, -1.0f) * m_settings.CameraSpeed * deltaTime;
+		}
+
+		m_world->Update();
+		++frameCount;
+
+		float time = Time::GetElapsedTime();
+		if(time - lastReportTime >= m_settings.ReportInterval)
+		{
+			WorldStatistics statistics = m_world->GetStatistics();
+			float interval = time - lastReportTime;
+
+			printf(
+				"%7.1f s: %6zu loaded, %5zu pending, %8.1f generated/s, %8.1f restored/s, %8.1f unloaded/s, cache %.1f MiB\n",
+				static_cast<double>(time),
+				statistics.LoadedChunkCount,
+				statistics.PendingChunkCount,
+				static_cast<double>(statistics.GeneratedChunkCount - lastStatistics.GeneratedChunkCount) / static_cast<double>(interval),
+				static_cast<double>(statistics.RestoredChunkCount - lastStatistics.RestoredChunkCount) / static_cast<double>(interval),
+				static_cast<double>(statistics.UnloadedChunkCount - lastStatistics.UnloadedChunkCount) / static_cast<double>(interval),
+				static_cast<double>(statistics.CacheSize) / (1024.0 * 1024.0));
+
+			lastStatistics = statistics;
+			lastReportTime = time;
+		}
+
+		if(m_settings.FrameTime > 0.0f)
+		{
+			frameEnd += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(m_settings.FrameTime));
+			frameEnd = std::max(frameEnd, Clock::now());
+
+			std::this_thread::sleep_until(frameEnd);
+		}
+	}
+
+	WorldStatistics statistics = m_world->GetStatistics();
+	double duration = static_cast<double>(Time::GetElapsedTime());
+
+	printf(
+		"%llu frames in %.1f s (%.1f fps), %llu chunks generated (%.1f/s), %llu restored, %llu unloaded, %llu lit\n",
+		static_cast<unsigned long long>(frameCount),
+		duration,
+		static_cast<double>(frameCount) / duration,
+		static_cast<unsigned long long>(statistics.GeneratedChunkCount),
+		static_cast<double>(statistics.GeneratedChunkCount) / duration,
+		static_cast<unsigned long long>(statistics.RestoredChunkCount),
+		static_cast<unsigned long long>(statistics.UnloadedChunkCount),
+		static_cast<unsigned long long>(statistics.BakedChunkCount));
+
+	PrintStageStatistics();
+
+	if(m_benchmark != nullptr)
+	{
+		m_benchmark->WriteReport(m_options.ReportPath);
+
+		printf("Benchmark report written to '%s'\n", m_options.ReportPath.string().c_str());
+	}
+
+	if(!m_options.TracePath.empty())
+	{
+#if defined(ENABLE_PROFILER)
+		if(Profiler::WriteChromeTrace(m_options.TracePath))
+		{
+			printf("Profiler trace written to '%s'\n", m_options.TracePath.string().c_str());
+		}
+		else
+		{
+			printf("Couldn't write the profiler trace to '%s'\n", m_options.TracePath.string().c_str());
+		}
+#else
+		printf("The profiler isn't compiled in, regenerate the project with 'premake5 --profiler'\n");
+#endif
+	}
+}
+
+auto HeadlessApplication::PrintStageStatistics() const -> void
+{
+	printf("%-12s %10s %10s %10s\n", "Stage", "ms/chunk", "Runs", "Skips");
+
+	for(size_t i = 0u; i < static_cast<size_t>(GenerationStage::Count); ++i)
+	{
+		GenerationStage stage = static_cast<GenerationStage>(i);
+		GenerationStageStatistics statistics = m_world->GetGenerator().GetStageStatistics(stage);
+		uint64_t count = statistics.RunCount + statistics.SkipCount;
+
+		printf(
+			"%-12s %10.3f %10llu %10llu\n",
+			WorldGenerator::GetStageName(stage),
+			(count > 0u) ? statistics.TotalTime / static_cast<double>(count) : 0.0,
+			static_cast<unsigned long long>(statistics.RunCount),
+			static_cast<unsigned long long>(statistics.SkipCount));
+	}
+}
+
+auto HeadlessSettings::LoadFromConfig() -> HeadlessSettings
+{
+	return HeadlessSettings{
+		.Duration = static_cast<float>(Config::Get<double>("headless", "fDuration")),
+		.FrameTime = static_cast<float>(std::max(Config::Get<double>("headless", "fFrameTime"), 0.0)),
+		.ReportInterval = static_cast<float>(Config::Get<double>("headless", "fReportInterval")),
+		.CameraSpeed = static_cast<float>(Config::Get<double>("headless", "fCameraSpeed")),
+		.CameraTurnRate = static_cast<float>(Config::Get<double>("headless", "fCameraTurnRate")),
+	};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "LaunchOptions.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Benchmark;
+class ChunkAllocator;
+class World;
+
+/**
+ * @brief Holds settings related to the headless mode.
+ */
+struct HeadlessSettings
+{
+	/**
+	 * @brief How long the simulation runs in seconds.
+	 */
+	float Duration;
+
+	/**
+	 * @brief The target duration of a frame in seconds. 0 runs the frames back to back.
+	 */
+	float FrameTime;
+
+	/**
+	 * @brief The time between two throughput reports in seconds.
+	 */
+	float ReportInterval;
+
+	/**
+	 * @brief The speed of the scripted camera in voxels per second.
+	 */
+	float CameraSpeed;
+
+	/**
+	 * @brief The turn rate of the scripted camera in degrees per second.
+	 */
+	float CameraTurnRate;
+
+	/**
+	 * @brief Loads the settings from the config file.
+	 *
+	 * @return The settings loaded from the file.
+	 */
+	static auto LoadFromConfig() -> HeadlessSettings;
+};
+
+/**
+ * @brief Runs the world without a window or a GL context.
+ *
+ * The chunks are allocated in CPU memory, the camera flies a scripted path or replays a recorded one and the streaming throughput is printed.
+ */
+class HeadlessApplication
+{
+public:
+	/**
+	 * @brief Loads the config and creates the world.
+	 *
+	 * @param options The command line options.
+	 */
+	HeadlessApplication(const LaunchOptions& options);
+
+	/**
+	 * @brief Destroys the world before stopping the job system.
+	 */
+	~HeadlessApplication();
+
+	HeadlessApplication(const HeadlessApplication&) = delete;
+	auto operator=(const HeadlessApplication&) -> HeadlessApplication& = delete;
+
+	HeadlessApplication(HeadlessApplication&&) noexcept = delete;
+	auto operator=(HeadlessApplication&&) noexcept -> HeadlessApplication& = delete;
+
+	/**
+	 * @brief Runs the simulation for the configured duration or until the replayed path ends.
+	 */
+	auto Run() -> void;
+
+private:
+	HeadlessSettings m_settings;
+	LaunchOptions m_options;
+
+	/**
+	 * @brief Stands in for the mapped chunk data buffer of the renderer.
+	 */
+	std::vector<uint8_t> m_chunkData;
+	std::unique_ptr<ChunkAllocator> m_chunkAllocator;
+	std::unique_ptr<World> m_world;
+	std::unique_ptr<Benchmark> m_benchmark;
+
+	/**
+	 * @brief Prints the generation time of every stage.
+	 */
+	auto PrintStageStatistics() const -> void;
+};
@@ -0,0 +1,49 @@
+#include "LaunchOptions.h"
+
+#include <string_view>
+
+auto LaunchOptions::Parse(std::span<char*> arguments) -> LaunchOptions
+{
+	LaunchOptions options;
+
+	for(size_t i = 0u; i < arguments.size(); ++i)
+	{
+		std::string_view argument = arguments[i];
+		bool hasValue = i + 1u < arguments.size();
+
+		if(argument == "--headless")
+		{
+			options.IsHeadless = true;
+		}
+		else if(argument == "--server")
+		{
+			options.IsServer = true;
+		}
+		else if(argument == "--record" && hasValue)
+		{
+			options.RecordPath = arguments[++i];
+		}
+		else if(argument == "--replay" && hasValue)
+		{
+			options.ReplayPath = arguments[++i];
+		}
+		else if(argument == "--report" && hasValue)
+		{
+			options.ReportPath = arguments[++i];
+		}
+		else if(argument == "--trace" && hasValue)
+		{
+			options.TracePath = arguments[++i];
+		}
+		else if(argument == "--capture" && hasValue)
+		{
+			options.CapturePath = arguments[++i];
+		}
+		else if(argument == "--golden" && hasValue)
+		{
+			options.GoldenPath = arguments[++i];
+		}
+	}
+
+	return options;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+/**
+ * @brief Holds the options given on the command line.
+ */
+struct LaunchOptions
+{
+	/**
+	 * @brief Whether to run without a window, set by '--headless'.
+	 */
+	bool IsHeadless = false;
+
+	/**
+	 * @brief Whether to run as a chunk server, set by '--server'.
+	 */
+	bool IsServer = false;
+
+	/**
+	 * @brief The file the camera path is recorded to, set by '--record <file>'. Empty if nothing is recorded.
+	 */
+	std::filesystem::path RecordPath;
+
+	/**
+	 * @brief The camera path to replay as a benchmark, set by '--replay <file>'. Empty if nothing is replayed.
+	 */
+	std::filesystem::path ReplayPath;
+
+	/**
+	 * @brief The file the benchmark report is written to, set by '--report <file>'.
+	 */
+	std::filesystem::path ReportPath = "benchmark.json";
+
+	/**
+	 * @brief The file the profiler's Chrome trace is written to on exit, set by '--trace <file>'. Empty if no trace is written.
+	 */
+	std::filesystem::path TracePath;
+
+	/**
+	 * @brief The PNG file an offscreen render of a fixed view is written to, set by '--capture <file>'. Empty to run normally.
+	 *
+	 * The view is the first keyframe of the '--replay' path in its world, or the initial camera in the configured world.
+	 */
+	std::filesystem::path CapturePath;
+
+	/**
+	 * @brief The PNG file the capture is compared to, set by '--golden <file>'. Empty if the capture isn't compared.
+	 */
+	std::filesystem::path GoldenPath;
+
+	/**
+	 * @brief Parses the command line, unknown arguments are ignored.
+	 *
+	 * @param arguments The arguments without the program name.
+	 *
+	 * @return The parsed options.
+	 */
+	[[nodiscard]] static auto Parse(std::span<char*> arguments) -> LaunchOptions;
+};
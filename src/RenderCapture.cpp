@@ -0,0 +1,197 @@
+#include "RenderCapture.h"
+
+#include "renderer/Renderer.h"
+#include "utility/Config.h"
+#include "utility/Time.h"
+
+#include <toml++/toml.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+
+RenderCapture::RenderCapture(const CaptureSettings& settings, std::filesystem::path imagePath, std::filesystem::path goldenPath, std::optional<CameraKeyframe> view)
+	: m_settings(settings), m_imagePath(std::move(imagePath)), m_goldenPath(std::move(goldenPath)), m_view(view)
+{
+
+}
+
+auto RenderCapture::Update(World& world, Renderer& renderer) -> bool
+{
+	if(m_view.has_value())
+	{
+		world.GetCamera().Position = m_view->Position;
+		world.GetCamera().Rotation = m_view->Rotation;
+	}
+
+	switch(m_state)
+	{
+		case State::Loading:
+		{
+			WorldStatistics statistics = world.GetStatistics();
+			if(statistics.LoadedChunkCount > 0u && statistics.PendingChunkCount == 0u && renderer.IsPipelineReady())
+			{
+				m_state = State::Settling;
+			}
+			else if(Time::GetElapsedTime() > m_settings.Timeout)
+			{
+				printf("The view wasn't populated within %.0f seconds\n", static_cast<double>(m_settings.Timeout));
+
+				WriteReport(std::nullopt, "timed out");
+
+				return false;
+			}
+
+			break;
+		}
+		case State::Settling:
+		{
+			if(++m_settledFrameCount >= m_settings.SettleFrameCount)
+			{
+				renderer.RequestCapture();
+
+				m_state = State::Reading;
+			}
+
+			break;
+		}
+		case State::Reading:
+		{
+			// The copy is polled every frame, the frames keep rendering meanwhile
+			if(std::optional<Image> image = renderer.TryGetCapture(); image.has_value())
+			{
+				Finish(*image);
+
+				return false;
+			}
+
+			break;
+		}
+	}
+
+	return true;
+}
+
+auto RenderCapture::RecordGpuTimes(std::span<const GpuPassTime> times) -> void
+{
+	if(m_state != State::Settling)
+	{
+		return;
+	}
+
+	for(const GpuPassTime& time : times)
+	{
+		auto it = std::ranges::find(m_gpuTimes, std::string_view(time.Name), &std::pair<std::string, std::vector<float>>::first);
+		if(it == m_gpuTimes.end())
+		{
+			it = m_gpuTimes.emplace(m_gpuTimes.end(), time.Name, std::vector<float>());
+		}
+
+		it->second.push_back(time.Milliseconds);
+	}
+}
+
+auto RenderCapture::Finish(const Image& image) -> void
+{
+	if(!SavePngFile(m_imagePath, image))
+	{
+		printf("Couldn't write the capture to '%s'\n", m_imagePath.string().c_str());
+
+		WriteReport(std::nullopt, "couldn't write the capture");
+
+		return;
+	}
+
+	printf("Capture written to '%s'\n", m_imagePath.string().c_str());
+
+	if(m_goldenPath.empty())
+	{
+		m_hasPassed = true;
+
+		WriteReport(std::nullopt, "");
+
+		return;
+	}
+
+	Image golden = LoadPngFile(m_goldenPath);
+	if(golden.Pixels.empty() || golden.Size != image.Size)
+	{
+		printf("The golden image '%s' is missing or isn't %ux%u\n", m_goldenPath.string().c_str(), image.Size.x, image.Size.y);
+
+		WriteReport(std::nullopt, "golden image missing or of a different size");
+
+		return;
+	}
+
+	ImageDifference difference = CompareImages(image, golden, m_settings.ChannelTolerance);
+
+	size_t pixelCount = static_cast<size_t>(image.Size.x) * image.Size.y;
+	m_hasPassed = static_cast<float>(difference.DifferingPixelCount) <= m_settings.MaxDifferingPixels * static_cast<float>(pixelCount);
+
+	printf(
+		"%s: %zu of %zu pixels differ from '%s', largest difference %u, mean %.3f\n",
+		m_hasPassed ? "Passed" : "Failed",
+		difference.DifferingPixelCount, pixelCount,
+		m_goldenPath.string().c_str(),
+		difference.MaxError,
+		static_cast<double>(difference.MeanError));
+
+	// The mask shows where to look when the capture doesn't match
+	if(!m_hasPassed)
+	{
+		std::filesystem::path maskPath = m_imagePath;
+		maskPath.replace_extension(".diff.png");
+
+		if(SavePngFile(maskPath, difference.Mask))
+		{
+			printf("Differing pixels written to '%s'\n", maskPath.string().c_str());
+		}
+	}
+
+	WriteReport(difference, m_hasPassed ? "" : "too many differing pixels");
+}
+
+auto RenderCapture::WriteReport(const std::optional<ImageDifference>& difference, const std::string& error) const -> void
+{
+	// The medians of the settling frames, which all render the same view
+	toml::table gpuTimes;
+	for(auto [name, times] : m_gpuTimes)
+	{
+		std::ranges::nth_element(times, times.begin() + static_cast<ptrdiff_t>(times.size() / 2u));
+
+		gpuTimes.insert(name, static_cast<double>(times[times.size() / 2u]));
+	}
+
+	toml::table report{
+		{ "image", m_imagePath.string() },
+		{ "golden", m_goldenPath.string() },
+		{ "passed", m_hasPassed },
+		{ "error", error },
+		{ "gpuPassTimeMs", std::move(gpuTimes) },
+	};
+
+	if(difference.has_value())
+	{
+		report.insert("differingPixels", static_cast<int64_t>(difference->DifferingPixelCount));
+		report.insert("maxError", static_cast<int64_t>(difference->MaxError));
+		report.insert("meanError", static_cast<double>(difference->MeanError));
+	}
+
+	std::filesystem::path reportPath = m_imagePath;
+	reportPath.replace_extension(".json");
+
+	std::ofstream file(reportPath);
+
+	file << toml::json_formatter{ report } << std::endl;
+}
+
+auto CaptureSettings::LoadFromConfig() -> CaptureSettings
+{
+	return CaptureSettings{
+		.ChannelTolerance = static_cast<uint32_t>(Config::Get<int64_t>("capture", "iChannelTolerance")),
+		.MaxDifferingPixels = static_cast<float>(Config::Get<double>("capture", "fMaxDifferingPixels")),
+		.SettleFrameCount = static_cast<uint32_t>(Config::Get<int64_t>("capture", "iSettleFrames")),
+		.Timeout = static_cast<float>(Config::Get<double>("capture", "fTimeout")),
+	};
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "renderer/GpuTimer.h"
+#include "utility/Image.h"
+#include "world/CameraPath.h"
+#include "world/World.h"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Renderer;
+
+/**
+ * @brief Holds settings related to render captures.
+ */
+struct CaptureSettings
+{
+	/**
+	 * @brief The largest difference of a color channel from the golden image still counted as matching.
+	 */
+	uint32_t ChannelTolerance;
+
+	/**
+	 * @brief The portion of the pixels allowed to differ from the golden image beyond the tolerance.
+	 */
+	float MaxDifferingPixels;
+
+	/**
+	 * @brief The number of frames rendered after the view was populated, so the reconstruction converges before the capture.
+	 */
+	uint32_t SettleFrameCount;
+
+	/**
+	 * @brief The time the view may take to populate in seconds.
+	 */
+	float Timeout;
+
+	/**
+	 * @brief Loads the settings from the config file.
+	 *
+	 * @return The settings loaded from the file.
+	 */
+	static auto LoadFromConfig() -> CaptureSettings;
+};
+
+/**
+ * @brief Renders a fixed view, writes it to a PNG and compares it to a golden image.
+ *
+ * Waits until every chunk in range is loaded and the reconstruction settled, then reads the frame back without stalling the renderer.
+ * A JSON report next to the image holds the comparison and the GPU times of the render passes while settling.
+ */
+class RenderCapture
+{
+public:
+	/**
+	 * @brief Prepares the capture.
+	 *
+	 * @param settings The settings of the capture.
+	 * @param imagePath The PNG file the capture is written to.
+	 * @param goldenPath The PNG file the capture is compared to, empty to only write the capture.
+	 * @param view The fixed camera, 'std::nullopt' to keep the world's camera.
+	 */
+	RenderCapture(const CaptureSettings& settings, std::filesystem::path imagePath, std::filesystem::path goldenPath, std::optional<CameraKeyframe> view);
+
+	/**
+	 * @brief Holds the camera and advances the capture.
+	 *
+	 * Must be called once per frame before the world is updated.
+	 *
+	 * @param world The world that is captured.
+	 * @param renderer The renderer drawing the world.
+	 *
+	 * @return 'false' once the capture finished, otherwise 'true'.
+	 */
+	auto Update(World& world, Renderer& renderer) -> bool;
+
+	/**
+	 * @brief Records the GPU times of a frame's render passes, only the ones of the settling frames are kept.
+	 *
+	 * @param times The times of the passes, see @ref GpuTimer::OnFrameResolved.
+	 */
+	auto RecordGpuTimes(std::span<const GpuPassTime> times) -> void;
+
+	/**
+	 * @brief Checks whether the capture was written and matched the golden image, if there is one.
+	 *
+	 * @return 'true' if the capture succeeded, otherwise 'false'.
+	 */
+	[[nodiscard]] auto HasPassed() const noexcept -> bool
+	{
+		return m_hasPassed;
+	}
+
+private:
+	enum class State : uint8_t
+	{
+		Loading,
+		Settling,
+		Reading,
+	};
+
+	CaptureSettings m_settings;
+	std::filesystem::path m_imagePath;
+	std::filesystem::path m_goldenPath;
+	std::optional<CameraKeyframe> m_view;
+	State m_state = State::Loading;
+	uint32_t m_settledFrameCount = 0u;
+	bool m_hasPassed = false;
+
+	/**
+	 * @brief The GPU times of every render pass while settling in milliseconds, in the order the passes were first recorded.
+	 */
+	std::vector<std::pair<std::string, std::vector<float>>> m_gpuTimes;
+
+	/**
+	 * @brief Writes the capture, compares it to the golden image and writes the report.
+	 *
+	 * @param image The captured frame.
+	 */
+	auto Finish(const Image& image) -> void;
+
+	/**
+	 * @brief Writes the report.
+	 *
+	 * @param difference The difference from the golden image, 'std::nullopt' if it wasn't compared.
+	 * @param error The reason the capture failed, empty if it didn't.
+	 */
+	auto WriteReport(const std::optional<ImageDifference>& difference, const std::string& error) const -> void;
+};
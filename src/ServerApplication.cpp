@@ -0,0 +1,85 @@
+#include "ServerApplication.h"
+
+#include "world/ChunkServer.h"
+#include "world/World.h"
+#include "utility/Config.h"
+#include "utility/JobSystem.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+	volatile std::sig_atomic_t s_isStopRequested = 0;
+
+	auto RequestStop(int) -> void
+	{
+		s_isStopRequested = 1;
+	}
+}
+
+ServerApplication::ServerApplication()
+{
+	Config::Load();
+	JobSystem::Initialize();
+
+	// The seed is picked once here, every client adopts it from the server
+	WorldSettings worldSettings = WorldSettings::LoadFromConfig();
+	if(worldSettings.Seed == 0)
+	{
+		worldSettings.Seed = WorldSettings::GetRandomSeed();
+	}
+
+	m_server = std::make_unique<ChunkServer>(ChunkServerSettings::LoadFromConfig(), worldSettings);
+}
+
+ServerApplication::~ServerApplication()
+{
+	// The server's jobs must finish before the workers stop.
+	m_server.reset();
+	JobSystem::Shutdown();
+}
+
+auto ServerApplication::Run() -> void
+{
+	ChunkServerSettings settings = ChunkServerSettings::LoadFromConfig();
+
+	if(!m_server->Start())
+	{
+		return;
+	}
+
+	printf("Serving seed %d on port %u\n", m_server->GetSeed(), static_cast<unsigned>(settings.Port));
+	fflush(stdout);
+
+	// Interrupting the process lets the server disconnect its clients and finish its jobs
+	std::signal(SIGINT, RequestStop);
+	std::signal(SIGTERM, RequestStop);
+
+	ChunkServerStatistics lastStatistics = m_server->GetStatistics();
+	while(!s_isStopRequested)
+	{
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+
+		ChunkServerStatistics statistics = m_server->GetStatistics();
+
+		printf(
+			"%zu clients, %llu requests/s, %llu generated/s, %llu cache hits/s, %llu edits/s, %.2f MiB/s sent\n",
+			statistics.ClientCount,
+			static_cast<unsigned long long>(statistics.RequestCount - lastStatistics.RequestCount),
+			static_cast<unsigned long long>(statistics.GeneratedChunkCount - lastStatistics.GeneratedChunkCount),
+			static_cast<unsigned long long>(statistics.CacheHitCount - lastStatistics.CacheHitCount),
+			static_cast<unsigned long long>(statistics.EditCount - lastStatistics.EditCount),
+			static_cast<double>(statistics.SentSize - lastStatistics.SentSize) / (1024.0 * 1024.0));
+
+		// The output is usually piped into a log
+		fflush(stdout);
+
+		lastStatistics = statistics;
+	}
+
+	printf("Stopping the server\n");
+	fflush(stdout);
+}
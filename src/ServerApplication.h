@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+
+class ChunkServer;
+
+/**
+ * @brief Runs a chunk server without a window, printing its throughput.
+ */
+class ServerApplication
+{
+public:
+	/**
+	 * @brief Loads the config and creates the server.
+	 */
+	ServerApplication();
+
+	/**
+	 * @brief Stops the server before the job system.
+	 */
+	~ServerApplication();
+
+	ServerApplication(const ServerApplication&) = delete;
+	auto operator=(const ServerApplication&) -> ServerApplication& = delete;
+
+	ServerApplication(ServerApplication&&) noexcept = delete;
+	auto operator=(ServerApplication&&) noexcept -> ServerApplication& = delete;
+
+	/**
+	 * @brief Serves the clients until the process is interrupted or terminated.
+	 */
+	auto Run() -> void;
+
+private:
+	std::unique_ptr<ChunkServer> m_server;
+};
@@ -1,10 +1,37 @@
 #include "Application.h"
+#include "HeadlessApplication.h"
+#include "LaunchOptions.h"
+#include "ServerApplication.h"
 
 #include <memory>
+#include <span>
 
 auto main(int argc, char* argv[]) -> int
 {
-	auto app = std::make_unique<Application>();
+	LaunchOptions options = LaunchOptions::Parse(std::span(argv + 1, static_cast<size_t>(argc - 1)));
+
+	if(options.IsServer)
+	{
+		auto app = std::make_unique<ServerApplication>();
+
+		app->Run();
+
+		return 0;
+	}
+
+	// Headless runs need no window, e.g. on machines without a GPU.
+	if(options.IsHeadless)
+	{
+		auto app = std::make_unique<HeadlessApplication>(options);
+
+		app->Run();
+
+		return 0;
+	}
+
+	auto app = std::make_unique<Application>(options);
 
 	app->Run();
+
+	return app->GetExitCode();
 }
@@ -71,3 +71,8 @@ auto Buffer::Bind(uint32_t target, uint32_t index) const noexcept -> void
 {
 	glBindBufferBase(target, index, m_handle);
 }
+
+auto Buffer::Bind(uint32_t target, uint32_t index, size_t offset, size_t size) const noexcept -> void
+{
+	glBindBufferRange(target, index, m_handle, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
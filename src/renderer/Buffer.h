@@ -104,6 +104,16 @@ public:
 	 */
 	auto Bind(uint32_t target, uint32_t index) const noexcept -> void;
 
+	/**
+	 * @brief Binds a range of the buffer to an indexed target.
+	 *
+	 * @param target The target binding.
+	 * @param index The index of the the binding point.
+	 * @param offset The offset of the range, a multiple of the target's offset alignment.
+	 * @param size The size of the range in bytes.
+	 */
+	auto Bind(uint32_t target, uint32_t index, size_t offset, size_t size) const noexcept -> void;
+
 private:
 	uint32_t m_handle;
 	size_t m_size;
@@ -0,0 +1,188 @@
+#include "GpuTimer.h"
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+GpuTimer::GpuTimer()
+{
+	// Software rasterizers may expose the entry points with a counter of 0 bits
+	GLint counterBits = 0;
+	if(glQueryCounter != nullptr && glGetQueryiv != nullptr)
+	{
+		glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits);
+	}
+
+	m_isSupported = counterBits > 0;
+	if(!m_isSupported)
+	{
+		printf("GPU timer queries aren't supported, the render passes won't be timed\n");
+
+		return;
+	}
+
+	for(Frame& frame : m_frames)
+	{
+		glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(frame.Queries.size()), frame.Queries.data());
+	}
+}
+
+GpuTimer::~GpuTimer()
+{
+	if(!m_isSupported)
+	{
+		return;
+	}
+
+	for(Frame& frame : m_frames)
+	{
+		glDeleteQueries(static_cast<GLsizei>(frame.Queries.size()), frame.Queries.data());
+	}
+}
+
+auto GpuTimer::BeginFrame() -> void
+{
+	if(!m_isSupported)
+	{
+		return;
+	}
+
+	// From the oldest frame, the queries finish in order so the first one in flight ends the read back
+	for(uint32_t i = 0u; i < FrameLatency; ++i)
+	{
+		Frame& frame = m_frames[(m_frameIndex + i) % FrameLatency];
+		if(frame.IsPending && !TryResolve(frame))
+		{
+			break;
+		}
+	}
+
+	Frame& frame = m_frames[m_frameIndex % FrameLatency];
+
+	m_isMeasuring = !frame.IsPending;
+	if(m_isMeasuring)
+	{
+		frame.PassCount = 0u;
+	}
+}
+
+auto GpuTimer::EndFrame() -> void
+{
+	if(!m_isMeasuring)
+	{
+		++m_frameIndex;
+
+		return;
+	}
+
+	Frame& frame = m_frames[m_frameIndex % FrameLatency];
+	frame.IsPending = frame.PassCount > 0u;
+
+	m_isMeasuring = false;
+	++m_frameIndex;
+}
+
+auto GpuTimer::BeginPass(const char* name) -> void
+{
+	Frame& frame = m_frames[m_frameIndex % FrameLatency];
+	if(!m_isMeasuring || frame.PassCount == MaxPassCount)
+	{
+		return;
+	}
+
+	glQueryCounter(frame.Queries[frame.PassCount * 2u], GL_TIMESTAMP);
+	frame.Names[frame.PassCount] = name;
+
+	m_isInPass = true;
+}
+
+auto GpuTimer::EndPass() -> void
+{
+	if(!m_isInPass)
+	{
+		return;
+	}
+
+	Frame& frame = m_frames[m_frameIndex % FrameLatency];
+	glQueryCounter(frame.Queries[frame.PassCount * 2u + 1u], GL_TIMESTAMP);
+	++frame.PassCount;
+
+	m_isInPass = false;
+}
+
+auto GpuTimer::GetPercentile(const PassHistory& history, float percentile) -> float
+{
+	std::array<float, HistoryLength> samples;
+	std::copy_n(history.Samples.begin(), history.Count, samples.begin());
+
+	// Nearest rank
+	size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<float>(history.Count)));
+	size_t index = std::clamp<size_t>(rank, 1u, history.Count) - 1u;
+
+	std::nth_element(samples.begin(), samples.begin() + static_cast<ptrdiff_t>(index), samples.begin() + static_cast<ptrdiff_t>(history.Count));
+
+	return samples[index];
+}
+
+auto GpuTimer::TryResolve(Frame& frame) -> bool
+{
+	GLint isAvailable = GL_FALSE;
+	glGetQueryObjectiv(frame.Queries[frame.PassCount * 2u - 1u], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+	if(isAvailable == GL_FALSE)
+	{
+		return false;
+	}
+
+	m_lastFrame.clear();
+	for(uint32_t pass = 0u; pass < frame.PassCount; ++pass)
+	{
+		GLuint64 begin = 0u;
+		GLuint64 end = 0u;
+		glGetQueryObjectui64v(frame.Queries[pass * 2u], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(frame.Queries[pass * 2u + 1u], GL_QUERY_RESULT, &end);
+
+		GpuPassTime time{
+			.Name = frame.Names[pass],
+			.Milliseconds = static_cast<float>(static_cast<double>(end - begin) / 1'000'000.0),
+		};
+
+		m_lastFrame.push_back(time);
+		Record(time);
+	}
+
+	frame.IsPending = false;
+
+	OnFrameResolved(std::span<const GpuPassTime>(m_lastFrame));
+
+	return true;
+}
+
+auto GpuTimer::Record(const GpuPassTime& time) -> void
+{
+	auto it = std::ranges::find_if(
+		m_histories,
+		[&] (const PassHistory& history) -> bool
+		{
+			return std::strcmp(history.Name, time.Name) == 0;
+		});
+
+	if(it == m_histories.end())
+	{
+		m_histories.emplace_back(
+			PassHistory{
+				.Name = time.Name,
+				.Samples = {},
+				.Count = 0u,
+				.Next = 0u,
+			});
+
+		it = m_histories.end() - 1;
+	}
+
+	it->Samples[it->Next] = time.Milliseconds;
+	it->Next = (it->Next + 1u) % HistoryLength;
+	it->Count = std::min(it->Count + 1u, HistoryLength);
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "../utility/Action.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief The GPU time of a render pass.
+ */
+struct GpuPassTime
+{
+	/**
+	 * @brief The name of the pass, a string literal.
+	 */
+	const char* Name;
+	float Milliseconds;
+};
+
+/**
+ * @brief Measures the GPU time of the render passes with timestamp queries.
+ *
+ * The queries of a frame are read back a few frames later once the GPU finished them, so the CPU never waits on the results.
+ * A frame whose queries are still in flight when its slot of the ring comes around again isn't measured.
+ * Does nothing on drivers without timer queries, @ref IsSupported tells whether any times will be reported.
+ */
+class GpuTimer
+{
+public:
+	/**
+	 * @brief The number of frames measured at once, the results are read back this many frames later at the latest.
+	 */
+	static constexpr uint32_t FrameLatency = 4u;
+
+	/**
+	 * @brief The largest number of passes measured in a frame.
+	 */
+	static constexpr uint32_t MaxPassCount = 8u;
+
+	/**
+	 * @brief The number of frames the rolling percentiles are taken over.
+	 */
+	static constexpr size_t HistoryLength = 240u;
+
+	/**
+	 * @brief The rolling statistics of a pass.
+	 */
+	struct PassHistory
+	{
+		const char* Name;
+
+		/**
+		 * @brief The times of the last frames in milliseconds, a ring of which the first @ref Count are valid.
+		 */
+		std::array<float, HistoryLength> Samples;
+		size_t Count;
+		size_t Next;
+	};
+
+	/**
+	 * @brief Called for every frame whose times were read back, with the passes in the order they ran.
+	 */
+	Action<std::span<const GpuPassTime>> OnFrameResolved;
+
+	/**
+	 * @brief Creates the queries if the driver supports timer queries.
+	 *
+	 * An OpenGL context must be current.
+	 */
+	GpuTimer();
+	~GpuTimer();
+
+	GpuTimer(const GpuTimer&) = delete;
+	auto operator=(const GpuTimer&) -> GpuTimer& = delete;
+
+	GpuTimer(GpuTimer&&) noexcept = delete;
+	auto operator=(GpuTimer&&) noexcept -> GpuTimer& = delete;
+
+	/**
+	 * @brief Reads back the finished frames and starts measuring a new one.
+	 */
+	auto BeginFrame() -> void;
+
+	/**
+	 * @brief Ends the measured frame.
+	 */
+	auto EndFrame() -> void;
+
+	/**
+	 * @brief Starts measuring a pass, the passes of a frame must not overlap.
+	 *
+	 * @param name The name of the pass, a string literal.
+	 */
+	auto BeginPass(const char* name) -> void;
+
+	/**
+	 * @brief Ends the pass started last.
+	 */
+	auto EndPass() -> void;
+
+	/**
+	 * @brief Calculates a percentile of a pass's recent times.
+	 *
+	 * @param history The statistics of the pass, must have at least one sample.
+	 * @param percentile The percentile in the range [0, 1].
+	 *
+	 * @return The time at the percentile in milliseconds.
+	 */
+	[[nodiscard]] static auto GetPercentile(const PassHistory& history, float percentile) -> float;
+
+	[[nodiscard]] auto IsSupported() const noexcept -> bool
+	{
+		return m_isSupported;
+	}
+
+	/**
+	 * @brief Retrieves the times of the last frame that was read back.
+	 *
+	 * @return The times of its passes, empty if no frame was read back yet.
+	 */
+	[[nodiscard]] auto GetLastFrame() const noexcept -> std::span<const GpuPassTime>
+	{
+		return m_lastFrame;
+	}
+
+	/**
+	 * @brief Retrieves the rolling statistics of every pass measured so far.
+	 *
+	 * @return The passes in the order they were first measured.
+	 */
+	[[nodiscard]] auto GetHistories() const noexcept -> std::span<const PassHistory>
+	{
+		return m_histories;
+	}
+
+private:
+	/**
+	 * @brief The queries of a frame of the ring.
+	 */
+	struct Frame
+	{
+		/**
+		 * @brief A timestamp at the start and the end of each pass.
+		 */
+		std::array<uint32_t, MaxPassCount * 2u> Queries;
+		std::array<const char*, MaxPassCount> Names;
+		uint32_t PassCount;
+		bool IsPending;
+	};
+
+	bool m_isSupported = false;
+	std::array<Frame, FrameLatency> m_frames{};
+	uint32_t m_frameIndex = 0u;
+
+	/**
+	 * @brief Whether the current frame is measured, 'false' if its slot of the ring was still in flight.
+	 */
+	bool m_isMeasuring = false;
+	bool m_isInPass = false;
+	std::vector<GpuPassTime> m_lastFrame;
+	std::vector<PassHistory> m_histories;
+
+	/**
+	 * @brief Reads back a frame if the GPU finished its queries.
+	 *
+	 * @param frame The frame.
+	 *
+	 * @return 'false' if its queries are still in flight, otherwise 'true'.
+	 */
+	auto TryResolve(Frame& frame) -> bool;
+
+	/**
+	 * @brief Adds a time to the statistics of a pass.
+	 *
+	 * @param time The time of the pass.
+	 */
+	auto Record(const GpuPassTime& time) -> void;
+};
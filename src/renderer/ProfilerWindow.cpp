@@ -0,0 +1,164 @@
+#include "ProfilerWindow.h"
+
+#if defined(ENABLE_PROFILER)
+
+#include "GUI.h"
+#include "../utility/Profiler.h"
+
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief The number of recent events captured per thread every frame, enough to hold a whole frame of the main thread.
+	 */
+	constexpr size_t ViewEventCount = 2048u;
+
+	/**
+	 * @brief The scopes of a frame with the same name and depth, merged into one line.
+	 */
+	struct ScopeSummary
+	{
+		const char* Name;
+		uint32_t Depth;
+		int64_t Duration;
+		uint32_t Count;
+	};
+
+	/**
+	 * @brief Finds the last finished frame of the main thread.
+	 *
+	 * @param events The events of the main thread ordered by their start.
+	 *
+	 * @return The frame's event or 'nullptr' if none was captured.
+	 */
+	[[nodiscard]] auto FindLastFrame(const std::vector<Profiler::Event>& events) -> const Profiler::Event*
+	{
+		auto it = std::ranges::find_if(
+			events.rbegin(),
+			events.rend(),
+			[] (const Profiler::Event& event) -> bool
+			{
+				return event.Depth == 0u && std::strcmp(event.Name, "Frame") == 0;
+			});
+
+		return (it != events.rend()) ? &*it : nullptr;
+	}
+}
+
+auto ProfilerWindow::Initialize(const std::filesystem::path& tracePath) -> void
+{
+	double scopeOverhead = Profiler::MeasureScopeOverhead();
+
+	GUI::OnGui += [tracePath, scopeOverhead, lastSaveResult = std::string()] (const glm::uvec2& windowSize) mutable -> void
+		{
+			ImGui::SetNextWindowSize(ImVec2(350.0f, 360.0f));
+			ImGui::SetNextWindowPos(ImVec2(static_cast<float>(windowSize.x) - 350.0f, 80.0f));
+			ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+
+			ImGui::Text("Scope overhead: %.1f ns", scopeOverhead);
+
+			if(ImGui::Button("Save trace"))
+			{
+				lastSaveResult = Profiler::WriteChromeTrace(tracePath)
+					? "Saved to '" + tracePath.string() + "'"
+					: "Couldn't write '" + tracePath.string() + "'";
+			}
+
+			if(!lastSaveResult.empty())
+			{
+				ImGui::SameLine();
+				ImGui::TextUnformatted(lastSaveResult.c_str());
+			}
+
+			std::vector<Profiler::ThreadCapture> captures = Profiler::Capture(ViewEventCount);
+
+			auto mainThread = std::ranges::find(captures, std::string("Main"), &Profiler::ThreadCapture::Name);
+			const Profiler::Event* frame = (mainThread != captures.end()) ? FindLastFrame(mainThread->Events) : nullptr;
+			if(frame == nullptr)
+			{
+				ImGui::End();
+
+				return;
+			}
+
+			int64_t frameDuration = std::max<int64_t>(frame->End - frame->Begin, 1);
+
+			// The scopes of the frame in order of their first start, repeated ones are summed
+			std::vector<ScopeSummary> summaries;
+			for(const Profiler::Event& event : mainThread->Events)
+			{
+				if(event.Begin < frame->Begin || event.End > frame->End)
+				{
+					continue;
+				}
+
+				auto it = std::ranges::find_if(
+					summaries,
+					[&] (const ScopeSummary& summary) -> bool
+					{
+						return summary.Depth == event.Depth && std::strcmp(summary.Name, event.Name) == 0;
+					});
+
+				if(it == summaries.end())
+				{
+					summaries.emplace_back(
+						ScopeSummary{
+							.Name = event.Name,
+							.Depth = event.Depth,
+							.Duration = 0,
+							.Count = 0u,
+						});
+
+					it = summaries.end() - 1;
+				}
+
+				it->Duration += event.End - event.Begin;
+				++it->Count;
+			}
+
+			ImGui::Separator();
+			for(const ScopeSummary& summary : summaries)
+			{
+				ImGui::Text(
+					"%*s%s%s",
+					static_cast<int32_t>(summary.Depth * 2u), "",
+					summary.Name,
+					(summary.Count > 1u) ? (" x" + std::to_string(summary.Count)).c_str() : "");
+				ImGui::SameLine(240.0f);
+				ImGui::Text("%7.3f ms", static_cast<double>(summary.Duration) / 1'000'000.0);
+			}
+
+			// The share of the frame the other threads spent in their outermost scopes
+			ImGui::Separator();
+			for(const Profiler::ThreadCapture& capture : captures)
+			{
+				if(&capture == &*mainThread)
+				{
+					continue;
+				}
+
+				int64_t busyTime = 0;
+				for(const Profiler::Event& event : capture.Events)
+				{
+					if(event.Depth == 0u)
+					{
+						busyTime += std::max<int64_t>(std::min(event.End, frame->End) - std::max(event.Begin, frame->Begin), 0);
+					}
+				}
+
+				ImGui::Text("%s", capture.Name.c_str());
+				ImGui::SameLine(240.0f);
+				ImGui::Text("%6.1f %% busy", 100.0 * static_cast<double>(busyTime) / static_cast<double>(frameDuration));
+			}
+
+			ImGui::End();
+		};
+}
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <filesystem>
+
+/**
+ * @brief A live view of the profiler's captures.
+ *
+ * Only compiled with 'ENABLE_PROFILER' defined, see 'Profiler.h'.
+ */
+namespace ProfilerWindow
+{
+	/**
+	 * @brief Measures the profiler's overhead and adds the window to the GUI.
+	 *
+	 * @param tracePath The file the 'Save trace' button writes the Chrome trace to.
+	 */
+	auto Initialize(const std::filesystem::path& tracePath) -> void;
+}
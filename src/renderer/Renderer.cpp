@@ -1,12 +1,19 @@
 #include "Renderer.h"
 
 #include "Buffer.h"
+#include "GpuTimer.h"
 #include "GUI.h"
 #include "Texture.h"
 #include "Shader.h"
 #include "Window.h"
 #include "../world/Camera.h"
+#include "../world/ChunkGrid.h"
+#include "../world/CoarseDepth.h"
 #include "../utility/Config.h"
+#include "../utility/Frustum.h"
+#include "../utility/IO.h"
+#include "../utility/Profiler.h"
+#include "../utility/Time.h"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -16,7 +23,14 @@
 #include <imgui/backends/imgui_impl_glfw.h>
 #include <imgui/backends/imgui_impl_opengl3.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
 #include <mutex>
+#include <span>
 #include <utility>
 
 using namespace Literals;
@@ -34,11 +48,78 @@ namespace
 	struct ScreenProperties
 	{
 		glm::uvec2 Size;
+		glm::uvec2 Offset;
+		glm::vec2 Jitter;
+	};
+
+	struct TemporalProperties
+	{
+		glm::mat4 PreviousViewProj;
+		glm::vec4 PreviousPosition;
+		glm::uvec2 OutputSize;
+		uint32_t HasHistory;
+		uint32_t Padding;
+	};
+
+	constexpr auto ShaderDirectory = "res/shaders";
+	constexpr auto TerrainTexturePath = "res/textures/grass.png";
+
+	/**
+	 * @brief The edge size of the raygen shader's work groups in pixels.
+	 */
+	constexpr int32_t TileSize = 8;
+
+	/**
+	 * @brief The texture units the previous and the current reconstructed frames are bound to.
+	 */
+	constexpr uint32_t HistoryTextureUnit = 3u;
+	constexpr uint32_t OutputTextureUnit = 4u;
+
+	/**
+	 * @brief The number of distinct sub-pixel offsets the rays cycle through.
+	 */
+	constexpr uint32_t JitterSequenceLength = 8u;
+
+	[[nodiscard]] auto GetHalton(uint32_t index, uint32_t base) noexcept -> float
+	{
+		float result = 0.0f;
+		float fraction = 1.0f;
+		while(index > 0u)
+		{
+			fraction /= static_cast<float>(base);
+			result += fraction * static_cast<float>(index % base);
+			index /= base;
+		}
+
+		return result;
+	}
+
+	struct ChunkDirectoryHeader
+	{
+		glm::ivec4 Origin;
+		glm::ivec4 Size;
 	};
 }
 
-Renderer::Renderer(const RendererSettings& settings, const Window& window)
-	: m_settings(settings), m_targetWindow(window)
+auto Renderer::ReadFiles() -> FileBatch
+{
+	// Every file of the shader directory is read, so the includes don't have to be parsed first
+	std::vector<std::filesystem::path> paths = { TerrainTexturePath };
+
+	std::error_code error;
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(ShaderDirectory, error))
+	{
+		if(entry.is_regular_file(error))
+		{
+			paths.push_back(entry.path());
+		}
+	}
+
+	return FileBatch(paths, JobPriority::High);
+}
+
+Renderer::Renderer(const RendererSettings& settings, const Window& window, const FileBatch& files)
+	: m_settings(settings), m_targetWindow(window), m_resolutionController(settings.Resolution)
 {
 	glfwMakeContextCurrent(static_cast<GLFWwindow*>(m_targetWindow));
 	gladLoadGL(glfwGetProcAddress);
@@ -46,49 +127,168 @@ Renderer::Renderer(const RendererSettings& settings, const Window& window)
 	// Disable V-sync because on nVidia it is on by default
 	glfwSwapInterval(0);
 
-	InitializeRenderPipeline();
+	InitializeRenderPipeline(files);
+
+	GUI::OnGui += [&] (const glm::uvec2& windowSize) -> void
+		{
+			glm::ivec2 tracedSize = m_tracedRect.IsEmpty() ? glm::ivec2(0) : m_tracedRect.Max - m_tracedRect.Min;
+			float tracedRatio = static_cast<float>(tracedSize.x * tracedSize.y) / static_cast<float>(m_renderSize.x * m_renderSize.y);
+
+			ImGui::SetNextWindowSize(ImVec2(350.0f, 80.0f));
+			ImGui::SetNextWindowPos(ImVec2(static_cast<float>(windowSize.x) - 350.0f, 0.0f));
+			ImGui::Begin("Renderer", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+			ImGui::Text("Culling: %zu of %zu chunks visible, %.0f%% traced", m_visibleChunks.size(), m_allocatedChunkCount, tracedRatio * 100.0f);
+			ImGui::Text(
+				"Resolution: %ux%u (%.0f%%), %.2f ms average",
+				m_renderSize.x, m_renderSize.y,
+				m_resolutionController.GetScale() * 100.0f,
+				m_resolutionController.GetAverageFrameTime() * 1000.0f);
+			ImGui::End();
+
+			ImGui::SetNextWindowSize(ImVec2(350.0f, 170.0f));
+			ImGui::SetNextWindowPos(ImVec2(0.0f, 380.0f));
+			ImGui::Begin("GPU", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+			if(!m_gpuTimer->IsSupported())
+			{
+				ImGui::TextUnformatted("Timer queries aren't supported by the driver");
+			}
+			else if(ImGui::BeginTable("Passes", 5))
+			{
+				ImGui::TableSetupColumn("Pass (ms)");
+				ImGui::TableSetupColumn("Last");
+				ImGui::TableSetupColumn("p50");
+				ImGui::TableSetupColumn("p95");
+				ImGui::TableSetupColumn("p99");
+				ImGui::TableHeadersRow();
+
+				// The last frame read back may lack passes that didn't run, like the tracing when no chunk is visible
+				std::span<const GpuPassTime> lastFrame = m_gpuTimer->GetLastFrame();
+				for(const GpuTimer::PassHistory& history : m_gpuTimer->GetHistories())
+				{
+					auto last = std::ranges::find_if(
+						lastFrame,
+						[&] (const GpuPassTime& time) -> bool
+						{
+							return std::strcmp(time.Name, history.Name) == 0;
+						});
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(history.Name);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", (last != lastFrame.end()) ? last->Milliseconds : 0.0f);
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", GpuTimer::GetPercentile(history, 0.5f));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", GpuTimer::GetPercentile(history, 0.95f));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", GpuTimer::GetPercentile(history, 0.99f));
+				}
+
+				ImGui::EndTable();
+			}
+			ImGui::End();
+		};
 }
 
 Renderer::~Renderer()
 {
+	if(m_captureFence != nullptr)
+	{
+		glDeleteSync(static_cast<GLsync>(m_captureFence));
+	}
+
+	for(void* fence : m_frameFences)
+	{
+		if(fence != nullptr)
+		{
+			glDeleteSync(static_cast<GLsync>(fence));
+		}
+	}
+
 	glDeleteVertexArrays(1, &m_dummyVertexArray);
 }
 
-auto Renderer::InitializeRenderPipeline() -> void
+auto Renderer::InitializeRenderPipeline(const FileBatch& files) -> void
 {
+	// The traced image never exceeds the window, only the part of the size the controller picks is used
+	m_renderSize = GetRenderSize(m_resolutionController.GetScale());
 	m_renderTexture = std::make_unique<Texture>(m_targetWindow.GetSize(), GL_RGBA16F, 0u);
-	m_terrainTexture = std::make_unique<Texture>("res/textures/grass.png", 1u);
+	m_outputTextures[0] = std::make_unique<Texture>(m_targetWindow.GetSize(), GL_RGBA16F, OutputTextureUnit);
+	m_outputTextures[1] = std::make_unique<Texture>(m_targetWindow.GetSize(), GL_RGBA16F, HistoryTextureUnit);
+
+	// Read here if it isn't part of the batch, the mapping lives until the texture is created
+	const MappedFile* terrainFile = files.Find(TerrainTexturePath);
+	m_terrainTexture = std::make_unique<Texture>((terrainFile != nullptr) ? terrainFile->GetData() : MappedFile(TerrainTexturePath).GetData(), 1u);
+
+	// One distance per work group of the raygen shader
+	glm::uvec2 tileCount = (m_targetWindow.GetSize() + static_cast<uint32_t>(TileSize) - 1u) / static_cast<uint32_t>(TileSize);
+	m_coarseDistanceTexture = std::make_unique<Texture>(tileCount, GL_R32F, 2u);
+
+	// The shaders compile in the background while the rest of the pipeline is set up and the first chunks stream in
+	m_shaderLoadStartTime = std::chrono::steady_clock::now();
+	Shader::Initialize(m_settings.ShaderCacheDirectory);
 
 	m_raygenShader = std::make_unique<Shader>(
 		Shader::Sources
 		{
 			{ GL_COMPUTE_SHADER, "res/shaders/Raygen.comp" },
-		});
+		},
+		files);
+	m_coarseDepthShader = std::make_unique<Shader>(
+		Shader::Sources
+		{
+			{ GL_COMPUTE_SHADER, "res/shaders/CoarseDepth.comp" },
+		},
+		files);
+	m_upsampleShader = std::make_unique<Shader>(
+		Shader::Sources
+		{
+			{ GL_COMPUTE_SHADER, "res/shaders/Upsample.comp" },
+		},
+		files);
 	m_screenShader = std::make_unique<Shader>(
 		Shader::Sources
 		{
 			{ GL_VERTEX_SHADER, "res/shaders/Screen.vert" },
 			{ GL_FRAGMENT_SHADER, "res/shaders/Screen.frag" },
-		});
-
-	m_projectionPropertiesBuffer = std::make_unique<Buffer>(
-		sizeof(ProjectionProperties), nullptr,
-		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT);
-	m_projectionPropertiesBuffer->Bind(GL_UNIFORM_BUFFER, 0u);
-
-	m_screenPropertiesBuffer = std::make_unique<Buffer>(
-		sizeof(ScreenProperties), nullptr,
-		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
-	m_screenPropertiesBuffer->Bind(GL_UNIFORM_BUFFER, 1u);
-
-	auto& screenProperties = *m_screenPropertiesBuffer->GetMappedStorage<ScreenProperties>();
-	screenProperties.Size = m_targetWindow.GetSize();
+		},
+		files);
 
 	m_chunkDataBuffer = std::make_unique<Buffer>(
 		m_settings.ChunkDataBufferSize, nullptr,
 		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
 	m_chunkDataBuffer->Bind(GL_SHADER_STORAGE_BUFFER, 0u);
-	m_chunkAllocator = std::make_unique<ChunkAllocator>(m_settings.ChunkDataBufferSize, m_chunkDataBuffer->GetMappedStorage());
+	m_chunkAllocator = std::make_unique<ChunkAllocator>(m_settings.ChunkDataBufferSize, m_chunkDataBuffer->GetMappedStorage(), FramesInFlight);
+
+	// Every section starts at an offset both uniform and storage buffer ranges can be bound at
+	GLint uniformAlignment = 0;
+	GLint storageAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	size_t alignment = static_cast<size_t>(glm::max(glm::max(uniformAlignment, storageAlignment), 1));
+
+	size_t directoryCellCount = static_cast<size_t>(ChunkDirectorySize * ChunkDirectorySize * WorldSettings::MaxHeight);
+	m_frameDataSizes = {
+		sizeof(ProjectionProperties),
+		sizeof(ScreenProperties),
+		sizeof(TemporalProperties),
+		sizeof(ChunkDirectoryHeader) + directoryCellCount * sizeof(ChunkDirectoryEntry),
+		directoryCellCount * sizeof(uint64_t),
+	};
+
+	m_frameDataSliceSize = 0u;
+	for(size_t i = 0u; i < m_frameDataSizes.size(); ++i)
+	{
+		m_frameDataOffsets[i] = m_frameDataSliceSize;
+		m_frameDataSliceSize += (m_frameDataSizes[i] + alignment - 1u) / alignment * alignment;
+	}
+
+	m_frameDataBuffer = std::make_unique<Buffer>(
+		m_frameDataSliceSize * FramesInFlight, nullptr,
+		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+
+	m_gpuTimer = std::make_unique<GpuTimer>();
 
 	glCreateVertexArrays(1, &m_dummyVertexArray);
 	glBindVertexArray(m_dummyVertexArray);
@@ -98,7 +298,7 @@ auto Renderer::UpdateProjectionData(const Camera& camera) -> void
 {
 	glm::quat rotation(glm::radians(camera.Rotation));
 
-	ProjectionProperties projectionProperties;
+	auto& projectionProperties = *GetFrameData<ProjectionProperties>(FrameData::Projection);
 	projectionProperties.View = glm::lookAt(
 		camera.Position,
 		camera.Position + rotation * glm::vec3(0.0f, 0.0f, -1.0f),
@@ -113,11 +313,61 @@ auto Renderer::UpdateProjectionData(const Camera& camera) -> void
 	projectionProperties.ViewInv = glm::inverse(projectionProperties.View);
 	projectionProperties.ProjInv = glm::inverse(projectionProperties.Proj);
 
-	m_projectionPropertiesBuffer->SetData(0u, sizeof(ProjectionProperties), &projectionProperties);
+	m_viewProjection = projectionProperties.Proj * projectionProperties.View;
+	m_cameraPosition = camera.Position;
 }
 
 auto Renderer::BeginFrame() -> void
 {
+	m_frameSlot = (m_frameSlot + 1u) % FramesInFlight;
+
+	// The slice is about to be rewritten, so the GPU must be done with the frame that used it last. It only waits if the GPU is that far behind.
+	if(GLsync fence = static_cast<GLsync>(m_frameFences[m_frameSlot]); fence != nullptr)
+	{
+		PROFILE_SCOPE("Renderer::WaitForFrame");
+
+		// Waits a second at a time up to the timeout, so a lost context or a hung GPU ends the wait instead of freezing the game
+		constexpr uint64_t waitSlice = 1'000'000'000u;
+		for(uint64_t waited = 0u; waited < FrameWaitTimeout; waited += waitSlice)
+		{
+			GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, std::min(waitSlice, FrameWaitTimeout - waited));
+			if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+			{
+				break;
+			}
+
+			if(status == GL_WAIT_FAILED)
+			{
+				printf("Couldn't wait for frame slot %u to finish on the GPU\n", m_frameSlot);
+				break;
+			}
+
+			if(waited + waitSlice >= FrameWaitTimeout)
+			{
+				printf("Frame slot %u didn't finish on the GPU within %.1f s\n", m_frameSlot, static_cast<double>(FrameWaitTimeout) * 1e-9);
+			}
+		}
+
+		glDeleteSync(fence);
+		m_frameFences[m_frameSlot] = nullptr;
+	}
+
+	// The chunk directories of the finished frames were the last ones pointing at the blocks freed back then
+	m_chunkAllocator->BeginFrame(m_frameSlot);
+
+	std::array<std::pair<GLenum, GLuint>, static_cast<size_t>(FrameData::Count)> bindings = {
+		std::pair(GL_UNIFORM_BUFFER, 0u),
+		std::pair(GL_UNIFORM_BUFFER, 1u),
+		std::pair(GL_UNIFORM_BUFFER, 2u),
+		std::pair(GL_SHADER_STORAGE_BUFFER, 1u),
+		std::pair(GL_SHADER_STORAGE_BUFFER, 2u),
+	};
+
+	for(size_t i = 0u; i < bindings.size(); ++i)
+	{
+		m_frameDataBuffer->Bind(bindings[i].first, bindings[i].second, m_frameSlot * m_frameDataSliceSize + m_frameDataOffsets[i], m_frameDataSizes[i]);
+	}
+
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -125,57 +375,365 @@ auto Renderer::BeginFrame() -> void
 
 auto Renderer::EndFrame() -> void
 {
-	GLsync bufferUploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
+	PROFILE_SCOPE("Renderer::EndFrame");
 
-	m_renderTexture->Clear(glm::vec4(0.6f, 0.8f, 1.0f, 1000.0f));
+	if(!IsPipelineReady())
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		ImGui::Render();
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+		m_frameFences[m_frameSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
+		glfwSwapBuffers(static_cast<GLFWwindow*>(m_targetWindow));
+
+		return;
+	}
+
+	m_renderSize = GetRenderSize(m_resolutionController.Update(Time::GetDeltaTime()));
+
+	// Every frame traces a different sub-pixel offset, which the reconstruction accumulates into the full resolution
+	auto& screenProperties = *GetFrameData<ScreenProperties>(FrameData::Screen);
+	screenProperties.Size = m_renderSize;
+	screenProperties.Offset = glm::uvec2(0u);
+	screenProperties.Jitter = glm::vec2(
+		GetHalton(m_frameIndex % JitterSequenceLength + 1u, 2u),
+		GetHalton(m_frameIndex % JitterSequenceLength + 1u, 3u));
+
+	m_gpuTimer->BeginFrame();
 
-	glWaitSync(bufferUploadFence, 0, GL_TIMEOUT_IGNORED);
+	m_gpuTimer->BeginPass("Clear");
+	m_renderTexture->Clear(glm::vec4(0.6f, 0.8f, 1.0f, 1000.0f));
+	m_gpuTimer->EndPass();
 
-	m_raygenShader->Use();
 	{
 		auto lock = std::scoped_lock(m_chunkAllocator->GetMutex());
 
-		for(const auto& [coordinate, block] : *m_chunkAllocator)
+		m_tracedRect = UpdateChunkDirectory();
+	}
+
+	// Every ray marches the chunk directory itself, so the whole world is traced in one dispatch.
+	// Only the tiles the visible chunks project to are dispatched, the rest of the screen keeps the sky color.
+	if(!m_tracedRect.IsEmpty())
+	{
+		screenProperties.Offset = glm::uvec2(m_tracedRect.Min);
+
+		glm::uvec2 tileCount = glm::uvec2(m_tracedRect.Max - m_tracedRect.Min) / static_cast<uint32_t>(TileSize);
+
+		// The coarse pass finds where each tile's rays may start first, one invocation per tile
+		glm::uvec2 coarseGroupCount = (tileCount + static_cast<uint32_t>(TileSize) - 1u) / static_cast<uint32_t>(TileSize);
+
+		m_gpuTimer->BeginPass("Coarse depth");
+		m_coarseDepthShader->Use();
+		glDispatchCompute(static_cast<GLuint>(coarseGroupCount.x), static_cast<GLuint>(coarseGroupCount.y), 1u);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		m_gpuTimer->EndPass();
+
+		m_gpuTimer->BeginPass("Raygen");
+		m_raygenShader->Use();
+		glDispatchCompute(static_cast<GLuint>(tileCount.x), static_cast<GLuint>(tileCount.y), 1u);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		m_gpuTimer->EndPass();
+	}
+
+	// Reconstruct the window's resolution from the traced image and the previous frame reprojected to the current camera
+	{
+		auto& temporalProperties = *GetFrameData<TemporalProperties>(FrameData::Temporal);
+		temporalProperties.PreviousViewProj = m_previousViewProjection;
+		temporalProperties.PreviousPosition = glm::vec4(m_previousPosition, 1.0f);
+		temporalProperties.OutputSize = m_targetWindow.GetSize();
+		temporalProperties.HasHistory = m_frameIndex > 0u;
+
+		std::swap(m_outputTextures[0], m_outputTextures[1]);
+		m_outputTextures[0]->Bind(OutputTextureUnit);
+		m_outputTextures[1]->Bind(HistoryTextureUnit);
+
+		glm::uvec2 groupCount = (m_targetWindow.GetSize() + static_cast<uint32_t>(TileSize) - 1u) / static_cast<uint32_t>(TileSize);
+
+		m_gpuTimer->BeginPass("Upsample");
+		m_upsampleShader->Use();
+		glDispatchCompute(static_cast<GLuint>(groupCount.x), static_cast<GLuint>(groupCount.y), 1u);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+		m_gpuTimer->EndPass();
+
+		m_previousViewProjection = m_viewProjection;
+		m_previousPosition = m_cameraPosition;
+		++m_frameIndex;
+	}
+
+	if(m_isCaptureRequested)
+	{
+		glm::uvec2 size = m_targetWindow.GetSize();
+		if(m_captureBuffer == nullptr)
 		{
-			DrawChunk(coordinate, block);
+			m_captureBuffer = std::make_unique<Buffer>(
+				static_cast<size_t>(size.x) * size.y * 4u, nullptr,
+				GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
 		}
+
+		// The copy into the pixel buffer runs on the GPU, the fence tells when the mapped storage can be read
+		glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT);
+		m_captureBuffer->Bind(GL_PIXEL_PACK_BUFFER);
+		glGetTextureImage(
+			static_cast<uint32_t>(*m_outputTextures[0]), 0,
+			GL_RGBA, GL_UNSIGNED_BYTE,
+			static_cast<GLsizei>(size.x * size.y * 4u), nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+
+		m_captureFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
+		m_isCaptureRequested = false;
 	}
 
+	m_gpuTimer->BeginPass("Screen");
 	m_screenShader->Use();
 	glDrawArrays(GL_TRIANGLES, 0, 3);
 	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	m_gpuTimer->EndPass();
 
+	m_gpuTimer->BeginPass("ImGui");
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	m_gpuTimer->EndPass();
+
+	m_gpuTimer->EndFrame();
+
+	// The slice of this frame can be rewritten once the GPU passed this point
+	m_frameFences[m_frameSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
 
+	PROFILE_SCOPE("SwapBuffers");
 	glfwSwapBuffers(static_cast<GLFWwindow*>(m_targetWindow));
 }
 
-auto Renderer::DrawChunk(const glm::ivec2& coordinate, const MemoryBlock& block) -> void
+auto Renderer::IsPipelineReady() -> bool
 {
-	glProgramUniform4i(
-		static_cast<GLuint>(*m_raygenShader), DrawDataUniformLocation,
-		coordinate.x, coordinate.y,
-		static_cast<int32_t>(block.Offset),
-		GetChunkLod(coordinate));
+	if(m_isPipelineReady)
+	{
+		return true;
+	}
 
-	glDispatchCompute(static_cast<GLuint>(m_targetWindow.GetSize().x / 8u), static_cast<GLuint>(m_targetWindow.GetSize().y / 8u), 1u);
-	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	std::array<Shader*, 4u> shaders = {
+		m_raygenShader.get(),
+		m_coarseDepthShader.get(),
+		m_upsampleShader.get(),
+		m_screenShader.get(),
+	};
+
+	// Every shader is polled so the finished ones are stored in the cache right away
+	bool isReady = true;
+	for(Shader* shader : shaders)
+	{
+		isReady &= shader->IsReady();
+	}
+
+	if(!isReady)
+	{
+		return false;
+	}
+
+	m_isPipelineReady = true;
+
+	size_t cachedCount = static_cast<size_t>(std::ranges::count_if(shaders, &Shader::IsCached));
+	float loadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_shaderLoadStartTime).count();
+
+	printf("Shaders ready in %.1f ms, %zu of %zu loaded from the cache\n", loadTime, cachedCount, shaders.size());
+
+	return true;
+}
+
+auto Renderer::RequestCapture() -> void
+{
+	m_isCaptureRequested = true;
+}
+
+auto Renderer::TryGetCapture() -> std::optional<Image>
+{
+	if(m_captureFence == nullptr)
+	{
+		return std::nullopt;
+	}
+
+	GLenum status = glClientWaitSync(static_cast<GLsync>(m_captureFence), GL_SYNC_FLUSH_COMMANDS_BIT, 0u);
+	if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+	{
+		return std::nullopt;
+	}
+
+	glDeleteSync(static_cast<GLsync>(m_captureFence));
+	m_captureFence = nullptr;
+
+	glm::uvec2 size = m_targetWindow.GetSize();
+	const uint8_t* pixels = m_captureBuffer->GetMappedStorage();
+
+	Image image{
+		.Size = size,
+		.Pixels = std::vector<uint8_t>(static_cast<size_t>(size.x) * size.y * 3u),
+	};
+
+	// The rows of the texture start at the bottom and the alpha holds the distance, the image gets the colors from the top
+	for(uint32_t y = 0u; y < size.y; ++y)
+	{
+		const uint8_t* row = pixels + static_cast<size_t>(size.y - 1u - y) * size.x * 4u;
+		for(uint32_t x = 0u; x < size.x; ++x)
+		{
+			std::copy_n(row + x * 4u, 3u, image.Pixels.begin() + static_cast<ptrdiff_t>((static_cast<size_t>(y) * size.x + x) * 3u));
+		}
+	}
+
+	return image;
+}
+
+auto Renderer::UpdateChunkDirectory() -> ScreenRect
+{
+	PROFILE_SCOPE("Renderer::UpdateChunkDirectory");
+
+	constexpr float chunkSize = static_cast<float>(Chunk::Size);
+
+	glm::ivec2 cameraCoordinate = GetChunkColumn(m_cameraPosition);
+
+	Frustum frustum(m_viewProjection);
+
+	// Primary rays can't reach the chunks outside the frustum, so they are left out of the directory
+	m_visibleChunks.clear();
+	m_allocatedChunkCount = 0u;
+	for(const auto& [coordinate, allocation] : *m_chunkAllocator)
+	{
+		++m_allocatedChunkCount;
+
+		glm::vec3 boundsMin = glm::vec3(coordinate) * chunkSize;
+		if(frustum.Intersects(boundsMin, boundsMin + chunkSize))
+		{
+			m_visibleChunks.emplace_back(coordinate, allocation);
+		}
+	}
+
+	// Fit the grid vertically to the visible chunks so rays don't march through empty layers
+	int32_t minHeight = std::numeric_limits<int32_t>::max();
+	int32_t maxHeight = std::numeric_limits<int32_t>::min();
+	for(const auto& [coordinate, allocation] : m_visibleChunks)
+	{
+		minHeight = glm::min(minHeight, coordinate.y);
+		maxHeight = glm::max(maxHeight, coordinate.y);
+	}
+
+	if(minHeight > maxHeight)
+	{
+		minHeight = 0;
+		maxHeight = 0;
+	}
+
+	uint8_t* storage = GetFrameData<uint8_t>(FrameData::ChunkDirectory);
+
+	auto& header = *reinterpret_cast<ChunkDirectoryHeader*>(storage);
+	header.Origin = glm::ivec4(
+		cameraCoordinate.x - ChunkDirectorySize / 2,
+		minHeight,
+		cameraCoordinate.y - ChunkDirectorySize / 2,
+		0);
+	header.Size = glm::ivec4(
+		ChunkDirectorySize,
+		glm::min(maxHeight - minHeight + 1, WorldSettings::MaxHeight),
+		ChunkDirectorySize,
+		0);
+
+	glm::ivec3 origin = glm::ivec3(header.Origin);
+	glm::ivec3 size = glm::ivec3(header.Size);
+
+	std::span<ChunkDirectoryEntry> entries(
+		reinterpret_cast<ChunkDirectoryEntry*>(storage + sizeof(ChunkDirectoryHeader)),
+		static_cast<size_t>(size.x * size.y * size.z));
+
+	std::ranges::fill(
+		entries,
+		ChunkDirectoryEntry{
+			.Offset = EmptyChunkOffset,
+			.Lod = 0,
+			.LightingOffset = 0,
+			.LeafOffset = 0,
+		});
+
+	m_coarseOccupancy.assign(entries.size(), 0u);
+
+	// Only the pixels covered by the chunks in the directory need to be traced
+	ScreenRect tracedRect{
+		.Min = glm::ivec2(0),
+		.Max = glm::ivec2(0),
+	};
+
+	for(const auto& [coordinate, allocation] : m_visibleChunks)
+	{
+		glm::ivec3 localCoordinate = coordinate - origin;
+		if(glm::any(glm::lessThan(localCoordinate, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(localCoordinate, size)))
+		{
+			continue;
+		}
+
+		glm::vec3 boundsMin = glm::vec3(coordinate) * chunkSize;
+		tracedRect.Merge(ProjectBox(m_viewProjection, boundsMin, boundsMin + chunkSize, m_renderSize));
+
+		size_t index = static_cast<size_t>((localCoordinate.y * size.z + localCoordinate.z) * size.x + localCoordinate.x);
+		int32_t lod = allocation.IsSolid ? 0 : GetChunkLod(coordinate);
+
+		entries[index] = ChunkDirectoryEntry{
+			.Offset = allocation.IsSolid ? SolidChunkOffset : static_cast<int32_t>(allocation.Block.Offset),
+			.Lod = allocation.IsSolid ? static_cast<int32_t>(allocation.SolidValue) : lod,
+			.LightingOffset = static_cast<int32_t>(allocation.LightingOffset),
+			.LeafOffset = static_cast<int32_t>(allocation.LightingOffset - allocation.LeafCount),
+		};
+
+		// The coarsest LOD traces nodes of 2*2*2 cells
+		m_coarseOccupancy[index] = (lod == 4) ? CoarsenOccupancy(allocation.CoarseOccupancy) : allocation.CoarseOccupancy;
+	}
+
+	DilateCoarseOccupancy(
+		m_coarseOccupancy,
+		std::span<uint64_t>(GetFrameData<uint64_t>(FrameData::CoarseOccupancy), m_coarseOccupancy.size()),
+		size);
+
+	if(tracedRect.IsEmpty())
+	{
+		return tracedRect;
+	}
+
+	// Align to whole work groups, the render size is a multiple of them
+	glm::ivec2 tileLimit = glm::ivec2(m_renderSize) / TileSize;
+
+	return ScreenRect{
+		.Min = (tracedRect.Min / TileSize) * TileSize,
+		.Max = glm::min((tracedRect.Max + TileSize - 1) / TileSize, tileLimit) * TileSize,
+	};
 }
 
-auto Renderer::GetChunkLod(const glm::ivec2& coordinate) const noexcept -> int32_t
+template<typename T>
+auto Renderer::GetFrameData(FrameData section) const noexcept -> T*
 {
-	auto& projectionProperties = *m_projectionPropertiesBuffer->GetMappedStorage<ProjectionProperties>();
-	glm::vec3 cameraPosition = glm::vec3(projectionProperties.ViewInv[3]);
+	size_t offset = m_frameSlot * m_frameDataSliceSize + m_frameDataOffsets[static_cast<size_t>(section)];
 
-	glm::vec3 chunkPosition = glm::vec3(coordinate.x, 0.5, coordinate.y) * static_cast<float>(Chunk::Size);
+	return reinterpret_cast<T*>(m_frameDataBuffer->GetMappedStorage() + offset);
+}
+
+auto Renderer::GetRenderSize(float scale) const noexcept -> glm::uvec2
+{
+	glm::vec2 size = glm::vec2(m_targetWindow.GetSize()) * scale;
+
+	// Whole work groups only, the partial ones at the edges would never be traced
+	glm::uvec2 tileCount = glm::max(glm::uvec2(glm::round(size / static_cast<float>(TileSize))), glm::uvec2(1u));
+	tileCount = glm::min(tileCount, glm::max(m_targetWindow.GetSize() / static_cast<uint32_t>(TileSize), glm::uvec2(1u)));
+
+	return tileCount * static_cast<uint32_t>(TileSize);
+}
+
+auto Renderer::GetChunkLod(const glm::ivec3& coordinate) const noexcept -> int32_t
+{
+	glm::vec3 chunkPosition = glm::vec3(coordinate.x, coordinate.y + 0.5, coordinate.z) * static_cast<float>(Chunk::Size);
 
-	return glm::clamp<uint32_t>(static_cast<uint32_t>(glm::distance(cameraPosition, chunkPosition)) / 64, 0, 4);
+	return glm::clamp<uint32_t>(static_cast<uint32_t>(glm::distance(m_cameraPosition, chunkPosition)) / 64, 0, 4);
 }
 
 auto RendererSettings::LoadFromConfig() -> RendererSettings
 {
 	return RendererSettings{
 		.ChunkDataBufferSize = static_cast<size_t>(Config::Get<int64_t>("renderer", "iChunkDataBufferSize")),
+		.ShaderCacheDirectory = Config::Get<std::string>("renderer", "sShaderCacheDirectory"),
+		.Resolution = ResolutionControllerSettings::LoadFromConfig(),
 	};
 }
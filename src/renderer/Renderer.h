@@ -1,14 +1,26 @@
 #pragma once
 
+#include "ResolutionController.h"
 #include "../world/Chunk.h"
+#include "../world/World.h"
 #include "../utility/ChunkAllocator.h"
+#include "../utility/Frustum.h"
+#include "../utility/Image.h"
 
 #include <glm/glm.hpp>
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 class Buffer;
+class FileBatch;
+class GpuTimer;
 class Shader;
 class Texture;
 class Window;
@@ -24,6 +36,16 @@ struct RendererSettings
 	 */
 	size_t ChunkDataBufferSize;
 
+	/**
+	 * @brief The directory the linked shader programs are cached in, empty to compile them on every start.
+	 */
+	std::filesystem::path ShaderCacheDirectory;
+
+	/**
+	 * @brief The settings of the dynamic resolution.
+	 */
+	ResolutionControllerSettings Resolution;
+
 	/**
 	 * @brief Loads the settings from the config file.
 	 *
@@ -38,13 +60,23 @@ struct RendererSettings
 class Renderer
 {
 public:
+	/**
+	 * @brief Starts reading the shader sources and textures on the job system.
+	 *
+	 * Called before the window is created, so the reads overlap with the context creation.
+	 *
+	 * @return The reads, passed to the constructor.
+	 */
+	[[nodiscard]] static auto ReadFiles() -> FileBatch;
+
 	/**
 	 * @brief Initialized the OpenGL context and the rendering pipeline.
 	 *
 	 * @param settings The settings of the renderer.
 	 * @param window The output window.
+	 * @param files The files started by @ref ReadFiles.
 	 */
-	Renderer(const RendererSettings& settings, const Window& window);
+	Renderer(const RendererSettings& settings, const Window& window, const FileBatch& files);
 	~Renderer();
 
 	Renderer(const Renderer&) = delete;
@@ -63,6 +95,16 @@ public:
 		return *m_chunkAllocator;
 	}
 
+	/**
+	 * @brief Retrieves the timer of the render passes.
+	 *
+	 * @return A reference to the GPU timer.
+	 */
+	[[nodiscard]] auto GetGpuTimer() noexcept -> GpuTimer&
+	{
+		return *m_gpuTimer;
+	}
+
 	/**
 	 * @brief Updates camera data.
 	 *
@@ -71,47 +113,213 @@ public:
 	auto UpdateProjectionData(const Camera& camera) -> void;
 
 	/**
-	 * @brief Begins a new ImGui frame.
+	 * @brief Begins a new frame.
+	 *
+	 * Waits for the GPU to finish the frame that last used this frame's slice of the frame data, then begins a new ImGui frame.
 	 */
 	auto BeginFrame() -> void;
 
 	/**
 	 * @brief Renders the scene.
+	 *
+	 * Traces at the resolution picked by the resolution controller and reconstructs the window's resolution from the previous frames.
 	 */
 	auto EndFrame() -> void;
 
+	/**
+	 * @brief Checks whether every shader finished compiling, without waiting for them.
+	 *
+	 * Reports the time the shaders took to load once they are ready.
+	 *
+	 * @return 'true' if the scene can be rendered, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsPipelineReady() -> bool;
+
+	/**
+	 * @brief Starts reading back the reconstructed frame of the next @ref EndFrame that renders the scene.
+	 *
+	 * The frame is copied into a pixel buffer on the GPU, see @ref TryGetCapture.
+	 */
+	auto RequestCapture() -> void;
+
+	/**
+	 * @brief Retrieves the captured frame once the GPU finished copying it, without waiting.
+	 *
+	 * @return The frame at the window's resolution, or 'std::nullopt' if it isn't ready yet or none was requested.
+	 */
+	[[nodiscard]] auto TryGetCapture() -> std::optional<Image>;
+
 private:
-	static constexpr size_t DrawDataUniformLocation = 0u;
+	/**
+	 * @brief The edge size of the chunk directory in chunks.
+	 *
+	 * Covers the largest load distance in every horizontal direction around the camera.
+	 */
+	static constexpr int32_t ChunkDirectorySize = 2 * WorldSettings::MaxLoadDistance;
+
+	/**
+	 * @brief The number of frames the CPU may prepare while the GPU still renders the previous ones.
+	 */
+	static constexpr uint32_t FramesInFlight = 3u;
+
+	/**
+	 * @brief The longest time BeginFrame waits for the GPU to finish an old frame in nanoseconds.
+	 */
+	static constexpr uint64_t FrameWaitTimeout = 5'000'000'000u;
+
+	/**
+	 * @brief The sections of a slice of the frame data.
+	 */
+	enum class FrameData : uint8_t
+	{
+		Projection,
+		Screen,
+		Temporal,
+		ChunkDirectory,
+		CoarseOccupancy,
+		Count,
+	};
 
 	RendererSettings m_settings;
 	const Window& m_targetWindow;
 	uint32_t m_dummyVertexArray;
 	std::unique_ptr<Texture> m_renderTexture;
+
+	/**
+	 * @brief The reconstructed frames at the window's resolution, the current one first and the previous one second.
+	 */
+	std::array<std::unique_ptr<Texture>, 2u> m_outputTextures;
 	std::unique_ptr<Texture> m_terrainTexture;
 	std::unique_ptr<Shader> m_screenShader;
 	std::unique_ptr<Shader> m_raygenShader;
-	std::unique_ptr<Buffer> m_screenPropertiesBuffer;
-	std::unique_ptr<Buffer> m_projectionPropertiesBuffer;
+	std::unique_ptr<Shader> m_coarseDepthShader;
+	std::unique_ptr<Shader> m_upsampleShader;
+	std::unique_ptr<Texture> m_coarseDistanceTexture;
 	std::unique_ptr<Buffer> m_chunkDataBuffer;
+
+	/**
+	 * @brief The data rewritten every frame, a slice for each frame in flight.
+	 */
+	std::unique_ptr<Buffer> m_frameDataBuffer;
+
+	/**
+	 * @brief The offset of each section within a slice of the frame data, see @ref FrameData.
+	 */
+	std::array<size_t, static_cast<size_t>(FrameData::Count)> m_frameDataOffsets{};
+	std::array<size_t, static_cast<size_t>(FrameData::Count)> m_frameDataSizes{};
+	size_t m_frameDataSliceSize = 0u;
+
+	/**
+	 * @brief The fences of the frames in flight, signaled once the GPU is done with their slice. 'GLsync' handles.
+	 */
+	std::array<void*, FramesInFlight> m_frameFences{};
+
+	/**
+	 * @brief The slice of the frame data the current frame writes.
+	 */
+	uint32_t m_frameSlot = 0u;
+
+	/**
+	 * @brief The pixel buffer a captured frame is read back through, created on the first capture.
+	 */
+	std::unique_ptr<Buffer> m_captureBuffer;
+
+	/**
+	 * @brief Signaled once the captured frame was copied, a 'GLsync' handle. 'nullptr' if no copy is in flight.
+	 */
+	void* m_captureFence = nullptr;
+	bool m_isCaptureRequested = false;
 	std::unique_ptr<ChunkAllocator> m_chunkAllocator;
+	std::unique_ptr<GpuTimer> m_gpuTimer;
+	ResolutionController m_resolutionController;
+
+	/**
+	 * @brief The size of the traced image, a multiple of the raygen shader's work groups no larger than the window.
+	 */
+	glm::uvec2 m_renderSize;
+	uint32_t m_frameIndex = 0u;
+
+	/**
+	 * @brief Whether every shader finished compiling, until then only the GUI is drawn.
+	 */
+	bool m_isPipelineReady = false;
+
+	/**
+	 * @brief The time the shaders started loading, to report the startup time once they are ready.
+	 */
+	std::chrono::steady_clock::time_point m_shaderLoadStartTime;
+
+	/**
+	 * @brief The camera of the current frame, kept on the CPU since the mapped frame data is slow to read.
+	 */
+	glm::mat4 m_viewProjection = glm::mat4(1.0f);
+	glm::vec3 m_cameraPosition = glm::vec3(0.0f);
+
+	/**
+	 * @brief The camera of the last frame, the history is reprojected from it.
+	 */
+	glm::mat4 m_previousViewProjection = glm::mat4(1.0f);
+	glm::vec3 m_previousPosition = glm::vec3(0.0f);
+
+	/**
+	 * @brief The allocated chunks inside the view frustum, reused between frames.
+	 */
+	std::vector<std::pair<glm::ivec3, ChunkAllocation>> m_visibleChunks;
+	size_t m_allocatedChunkCount = 0u;
+
+	/**
+	 * @brief The coarse occupancy of the chunk directory before dilation, reused between frames.
+	 */
+	std::vector<uint64_t> m_coarseOccupancy;
+
+	/**
+	 * @brief The pixels traced in the last frame.
+	 */
+	ScreenRect m_tracedRect{};
+
+	/**
+	 * @brief Calculates the size of the traced image.
+	 *
+	 * @param scale The portion of the window's size traced along each axis.
+	 *
+	 * @return The size of the traced image in pixels.
+	 */
+	[[nodiscard]] auto GetRenderSize(float scale) const noexcept -> glm::uvec2;
+
+	/**
+	 * @brief Retrieves a section of the current frame's slice of the frame data.
+	 *
+	 * @tparam T The type of the section's data.
+	 *
+	 * @param section The section.
+	 *
+	 * @return A pointer to the section in the mapped storage.
+	 */
+	template<typename T>
+	[[nodiscard]] auto GetFrameData(FrameData section) const noexcept -> T*;
 
 	/**
 	 * @brief Initialies the resources used for rendering.
+	 *
+	 * @param files The shader sources and textures.
 	 */
-	auto InitializeRenderPipeline() -> void;
+	auto InitializeRenderPipeline(const FileBatch& files) -> void;
 
 	/**
-	 * @brief Issues a draw call to draw one chunk.
+	 * @brief Writes the offset and LOD of the allocated chunks in the view frustum into the chunk directory.
 	 *
-	 * @param coordinate The coordinate of the chunk.
-	 * @param block The memory block of the chunk.
+	 * Also writes the dilated coarse occupancy of the directory for the coarse depth pass.
+	 *
+	 * The chunk allocator's mutex must be locked.
+	 *
+	 * @return The pixels covered by the chunks in the directory, aligned to the work groups of the raygen shader.
 	 */
-	auto DrawChunk(const glm::ivec2& coordinate, const MemoryBlock& block) -> void;
+	auto UpdateChunkDirectory() -> ScreenRect;
 
 	/**
 	 * @brief Calculate the LOD of a chunk.
 	 *
 	 * @param coordinate The coordinate of the chunk.
 	 */
-	[[nodiscard]] auto GetChunkLod(const glm::ivec2& coordinate) const noexcept -> int32_t;
+	[[nodiscard]] auto GetChunkLod(const glm::ivec3& coordinate) const noexcept -> int32_t;
 };
@@ -0,0 +1,96 @@
+#include "ResolutionController.h"
+
+#include "../utility/Config.h"
+
+#include <glm/glm.hpp>
+
+namespace
+{
+	/**
+	 * @brief The weight of the newest frame time in the moving average.
+	 */
+	constexpr float Smoothing = 0.1f;
+
+	/**
+	 * @brief Frame times are clamped to this multiple of the average so a single hitch can't collapse the resolution.
+	 */
+	constexpr float MaxFrameTimeRatio = 1.5f;
+
+	/**
+	 * @brief The range of the frame time relative to the target that leaves the scale unchanged.
+	 */
+	constexpr float LowerBand = 0.85f;
+	constexpr float UpperBand = 1.02f;
+
+	/**
+	 * @brief The largest relative change of the scale in one step when lowering and raising it.
+	 */
+	constexpr float MaxDecrease = 0.25f;
+	constexpr float MaxIncrease = 0.1f;
+
+	/**
+	 * @brief The scale is rounded to multiples of this to avoid changes too small to matter.
+	 */
+	constexpr float ScaleStep = 1.0f / 64.0f;
+}
+
+ResolutionController::ResolutionController(const ResolutionControllerSettings& settings)
+	: m_settings(settings), m_scale(settings.MaxScale)
+{
+}
+
+auto ResolutionController::Update(float frameTime) -> float
+{
+	if(m_settings.TargetFrameTime <= 0.0f)
+	{
+		return m_scale;
+	}
+
+	m_averageFrameTime = (m_averageFrameTime > 0.0f)
+		? glm::mix(m_averageFrameTime, glm::min(frameTime, m_averageFrameTime * MaxFrameTimeRatio), Smoothing)
+		: frameTime;
+
+	if(m_settleFrames > 0u)
+	{
+		--m_settleFrames;
+
+		return m_scale;
+	}
+
+	float load = m_averageFrameTime / m_settings.TargetFrameTime;
+	if(load >= LowerBand && load <= UpperBand)
+	{
+		return m_scale;
+	}
+
+	// Aim for the middle of the band so the next measurement lands inside it
+	float ratio = glm::sqrt(0.5f * (LowerBand + UpperBand) / load);
+	ratio = glm::clamp(ratio, 1.0f - MaxDecrease, 1.0f + MaxIncrease);
+
+	float scale = glm::round(m_scale * ratio / ScaleStep) * ScaleStep;
+	scale = glm::clamp(scale, m_settings.MinScale, m_settings.MaxScale);
+	if(scale == m_scale)
+	{
+		return m_scale;
+	}
+
+	// The old average measured the previous resolution, predict the new one instead
+	float pixelRatio = (scale * scale) / (m_scale * m_scale);
+	m_averageFrameTime *= pixelRatio;
+
+	m_scale = scale;
+	m_settleFrames = SettleFrameCount;
+
+	return m_scale;
+}
+
+auto ResolutionControllerSettings::LoadFromConfig() -> ResolutionControllerSettings
+{
+	float maxScale = glm::clamp(static_cast<float>(Config::Get<double>("renderer", "fMaxResolutionScale")), 0.1f, 1.0f);
+
+	return ResolutionControllerSettings{
+		.TargetFrameTime = glm::max(static_cast<float>(Config::Get<double>("renderer", "fTargetFrameTime")), 0.0f),
+		.MinScale = glm::clamp(static_cast<float>(Config::Get<double>("renderer", "fMinResolutionScale")), 0.1f, maxScale),
+		.MaxScale = maxScale,
+	};
+}
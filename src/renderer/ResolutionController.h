@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Holds settings related to dynamic resolution.
+ */
+struct ResolutionControllerSettings
+{
+	/**
+	 * @brief The frame time to stay within in seconds, 0 keeps the resolution at @ref MaxScale.
+	 */
+	float TargetFrameTime;
+
+	/**
+	 * @brief The smallest portion of the window's size traced along each axis.
+	 */
+	float MinScale;
+
+	/**
+	 * @brief The largest portion of the window's size traced along each axis.
+	 */
+	float MaxScale;
+
+	/**
+	 * @brief Loads the settings from the config file.
+	 *
+	 * @return The settings loaded from the file.
+	 */
+	static auto LoadFromConfig() -> ResolutionControllerSettings;
+};
+
+/**
+ * @brief Picks the resolution scale that keeps the frame time within a budget.
+ *
+ * The tracing cost is taken as proportional to the number of pixels, so the scale moves by the square root of the budget's ratio to the
+ * smoothed frame time. Dropping resolution reacts quickly, raising it waits for clear headroom so the scale doesn't oscillate around the target.
+ * Doesn't depend on the renderer, so it can be driven by any sequence of frame times.
+ */
+class ResolutionController
+{
+public:
+	/**
+	 * @brief The number of frames measured after a change before the next one, the frames in flight still ran at the old resolution.
+	 */
+	static constexpr uint32_t SettleFrameCount = 8u;
+
+	/**
+	 * @brief Initializes the controller at the largest scale.
+	 *
+	 * @param settings The settings of the controller.
+	 */
+	explicit ResolutionController(const ResolutionControllerSettings& settings);
+
+	/**
+	 * @brief Feeds the time of the last frame to the controller.
+	 *
+	 * @param frameTime The time the last frame took in seconds.
+	 *
+	 * @return The scale to render the next frame at.
+	 */
+	auto Update(float frameTime) -> float;
+
+	/**
+	 * @brief Retrieves the current scale.
+	 *
+	 * @return The portion of the window's size traced along each axis.
+	 */
+	[[nodiscard]] auto GetScale() const noexcept -> float
+	{
+		return m_scale;
+	}
+
+	/**
+	 * @brief Retrieves the smoothed frame time.
+	 *
+	 * @return The exponential moving average of the frame times in seconds.
+	 */
+	[[nodiscard]] auto GetAverageFrameTime() const noexcept -> float
+	{
+		return m_averageFrameTime;
+	}
+
+private:
+	ResolutionControllerSettings m_settings;
+	float m_scale;
+	float m_averageFrameTime = 0.0f;
+
+	/**
+	 * @brief The number of frames left until the scale may change again.
+	 */
+	uint32_t m_settleFrames = SettleFrameCount;
+};
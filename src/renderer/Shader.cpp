@@ -3,89 +3,360 @@
 #include "../utility/IO.h"
 
 #include <glad/gl.h>
+#include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
-#include <regex>
+#include <fstream>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
-Shader::Shader(const Sources& sources)
+namespace
+{
+	/**
+	 * @brief The constants and entry points of 'GL_KHR_parallel_shader_compile', which the loader doesn't include.
+	 */
+	constexpr GLenum CompletionStatus = 0x91B1u;
+	using MaxShaderCompilerThreadsFunction = void (*)(GLuint count);
+
+	/**
+	 * @brief Hashes bytes with 64 bit FNV-1a, continuing from a previous hash.
+	 *
+	 * @param data The bytes.
+	 * @param hash The hash of the previous bytes.
+	 *
+	 * @return The hash of the previous bytes followed by these.
+	 */
+	[[nodiscard]] auto HashBytes(std::string_view data, uint64_t hash = 0xCBF29CE484222325ull) noexcept -> uint64_t
+	{
+		for(char byte : data)
+		{
+			hash ^= static_cast<uint8_t>(byte);
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	/**
+	 * @brief Retrieves the info log of a shader or a program.
+	 *
+	 * @param handle The shader or the program.
+	 * @param getParameter 'glGetShaderiv' or 'glGetProgramiv'.
+	 * @param getInfoLog 'glGetShaderInfoLog' or 'glGetProgramInfoLog'.
+	 *
+	 * @return The info log.
+	 */
+	template<typename TGetParameter, typename TGetInfoLog>
+	[[nodiscard]] auto GetInfoLog(GLuint handle, TGetParameter getParameter, TGetInfoLog getInfoLog) -> std::string
+	{
+		GLint length = 0;
+		getParameter(handle, GL_INFO_LOG_LENGTH, &length);
+		if(length <= 1)
+		{
+			return std::string();
+		}
+
+		std::string log(static_cast<size_t>(length) - 1u, '\0');
+		getInfoLog(handle, length, nullptr, log.data());
+
+		return log;
+	}
+}
+
+auto Shader::Initialize(const std::filesystem::path& cacheDirectory) -> void
+{
+	GLint extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+	for(GLint i = 0; i < extensionCount; ++i)
+	{
+		std::string_view extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+		if(extension == "GL_KHR_parallel_shader_compile" || extension == "GL_ARB_parallel_shader_compile")
+		{
+			s_isParallelCompileSupported = true;
+		}
+	}
+
+	if(s_isParallelCompileSupported)
+	{
+		auto maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunction>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+		if(maxShaderCompilerThreads == nullptr)
+		{
+			maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunction>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+		}
+
+		// Let the driver pick the number of threads, some of them default to compiling synchronously
+		if(maxShaderCompilerThreads != nullptr)
+		{
+			maxShaderCompilerThreads(0xFFFFFFFFu);
+		}
+	}
+
+	GLint binaryFormatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+	if(cacheDirectory.empty() || binaryFormatCount == 0)
+	{
+		s_cacheDirectory.clear();
+
+		return;
+	}
+
+	s_cacheDirectory = cacheDirectory;
+
+	for(GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION })
+	{
+		s_driverIdentity += reinterpret_cast<const char*>(glGetString(name));
+		s_driverIdentity += '\n';
+	}
+}
+
+Shader::Shader(const Sources& sources, const FileBatch& files)
 {
 	m_handle = glCreateProgram();
 
-	std::vector<GLuint> shaders;
+	// The stages are hashed in a fixed order, the map's isn't
+	std::vector<std::pair<uint32_t, std::string>> stageSources;
 	for(const auto& [type, path] : sources)
 	{
-		GLuint shader = shaders.emplace_back(glCreateShader(type));
-
-		std::string source = LoadShaderSourceFile(path);
-		const GLchar* sourceCStr = source.c_str();
-		glShaderSource(shader, 1, &sourceCStr, nullptr);
+		stageSources.emplace_back(type, LoadShaderSourceFile(path, files));
+	}
 
-		glCompileShader(shader);
+	std::ranges::sort(stageSources, {}, &std::pair<uint32_t, std::string>::first);
 
-		GLint status;
-		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-		if(status != GL_TRUE)
+	if(!s_cacheDirectory.empty())
+	{
+		uint64_t hash = HashBytes(s_driverIdentity);
+		for(const auto& [type, source] : stageSources)
 		{
-			GLint length;
-			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+			hash = HashBytes(std::string_view(reinterpret_cast<const char*>(&type), sizeof(type)), hash);
+			hash = HashBytes(source, hash);
+		}
 
-			std::string str(static_cast<size_t>(length) - 1u, '\0');
-			glGetShaderInfoLog(shader, length, nullptr, str.data());
+		char fileName[24];
+		snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(hash));
+		m_cachePath = s_cacheDirectory / fileName;
 
-			printf("%s\n", str.c_str());
+		if(LoadFromCache())
+		{
+			return;
 		}
+	}
+
+	// No status is queried here, so with parallel compilation the driver finishes in the background
+	for(const auto& [type, source] : stageSources)
+	{
+		GLuint shader = glCreateShader(type);
+
+		const GLchar* sourceCStr = source.c_str();
+		glShaderSource(shader, 1, &sourceCStr, nullptr);
+		glCompileShader(shader);
 
 		glAttachShader(m_handle, shader);
+		m_stages.emplace_back(shader, sources.at(type));
 	}
 
-	glLinkProgram(m_handle);
-
-	for(const auto& shader : shaders)
+	if(!m_cachePath.empty())
 	{
-		glDetachShader(m_handle, shader);
-		glDeleteShader(shader);
+		glProgramParameteri(m_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	}
+
+	glLinkProgram(m_handle);
 }
 
 Shader::~Shader()
 {
+	for(const auto& [shader, path] : m_stages)
+	{
+		glDeleteShader(shader);
+	}
+
 	glDeleteProgram(m_handle);
 }
 
-auto Shader::Use() const noexcept -> void
+auto Shader::Use() -> void
 {
+	if(!m_isFinalized)
+	{
+		Finalize();
+	}
+
 	glUseProgram(m_handle);
 }
 
-auto Shader::LoadShaderSourceFile(const std::filesystem::path& path) -> std::string
+auto Shader::IsReady() -> bool
+{
+	if(m_isFinalized)
+	{
+		return true;
+	}
+
+	if(s_isParallelCompileSupported)
+	{
+		GLint isComplete = GL_FALSE;
+		glGetProgramiv(m_handle, CompletionStatus, &isComplete);
+		if(isComplete == GL_FALSE)
+		{
+			return false;
+		}
+	}
+
+	Finalize();
+
+	return true;
+}
+
+auto Shader::IsValid() -> bool
+{
+	if(!m_isFinalized)
+	{
+		Finalize();
+	}
+
+	return m_isValid;
+}
+
+auto Shader::LoadFromCache() -> bool
+{
+	// The driver reads the binary straight from the mapping
+	MappedFile file(m_cachePath);
+	std::span<const uint8_t> data = file.GetData();
+	if(data.size() <= sizeof(GLenum))
+	{
+		return false;
+	}
+
+	// The file is the binary's format followed by the binary
+	GLenum format;
+	std::memcpy(&format, data.data(), sizeof(format));
+
+	glProgramBinary(m_handle, format, data.data() + sizeof(format), static_cast<GLsizei>(data.size() - sizeof(format)));
+
+	// Binaries of a different driver build are rejected even though the identity matched, they are compiled and replaced
+	GLint status = GL_FALSE;
+	glGetProgramiv(m_handle, GL_LINK_STATUS, &status);
+	if(status != GL_TRUE)
+	{
+		return false;
+	}
+
+	m_isFinalized = true;
+	m_isValid = true;
+	m_isCached = true;
+
+	return true;
+}
+
+auto Shader::SaveToCache() const -> void
 {
-	static const std::regex rule("#include \"([a-zA-Z]+.[a-zA-Z]+)\"");
+	GLint length = 0;
+	glGetProgramiv(m_handle, GL_PROGRAM_BINARY_LENGTH, &length);
+	if(length <= 0)
+	{
+		return;
+	}
+
+	std::vector<uint8_t> data(sizeof(GLenum) + static_cast<size_t>(length));
 
-	std::string source = LoadTextFile(path);
+	GLenum format = 0u;
+	glGetProgramBinary(m_handle, length, nullptr, &format, data.data() + sizeof(format));
+	std::memcpy(data.data(), &format, sizeof(format));
+
+	std::error_code error;
+	std::filesystem::create_directories(m_cachePath.parent_path(), error);
+
+	if(std::ofstream file(m_cachePath, std::ios::binary); file.good())
+	{
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+	else
+	{
+		printf("Couldn't write the shader cache file '%s'\n", m_cachePath.string().c_str());
+	}
+}
+
+auto Shader::Finalize() -> void
+{
+	for(const auto& [shader, path] : m_stages)
+	{
+		GLint status = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if(status != GL_TRUE)
+		{
+			printf("Couldn't compile '%s':\n%s\n", path.string().c_str(), GetInfoLog(shader, glGetShaderiv, glGetShaderInfoLog).c_str());
+		}
+	}
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(m_handle, GL_LINK_STATUS, &status);
+	m_isValid = status == GL_TRUE;
+
+	if(!m_isValid)
+	{
+		printf(
+			"Couldn't link the program of '%s':\n%s\n",
+			m_stages.empty() ? "" : m_stages.front().second.string().c_str(),
+			GetInfoLog(m_handle, glGetProgramiv, glGetProgramInfoLog).c_str());
+	}
+
+	for(const auto& [shader, path] : m_stages)
+	{
+		glDetachShader(m_handle, shader);
+		glDeleteShader(shader);
+	}
+
+	m_stages.clear();
+	m_isFinalized = true;
+
+	if(m_isValid && !m_cachePath.empty())
+	{
+		SaveToCache();
+	}
+}
+
+auto Shader::LoadShaderSourceFile(const std::filesystem::path& path, const FileBatch& files) -> std::string
+{
+	constexpr std::string_view directive = "#include \"";
+
+	MappedFile ownFile;
+	const MappedFile* file = files.Find(path);
+	if(file == nullptr)
+	{
+		ownFile = MappedFile(path);
+		file = &ownFile;
+	}
+
+	std::string_view source = file->GetText();
 	std::filesystem::path parent = path.parent_path();
 
+	// Copies the source up to each include and the included file in its place
 	std::string result;
-	std::smatch match;
-	std::string::const_iterator searchStart = source.cbegin();
-
-	bool hasInclude = false;
-	while(std::regex_search(searchStart, source.cend(), match, rule))
+	size_t position = 0u;
+	for(size_t start = source.find(directive); start != std::string_view::npos; start = source.find(directive, position))
 	{
-		hasInclude = true;
+		size_t nameStart = start + directive.size();
+		size_t nameEnd = source.find('"', nameStart);
+		if(nameEnd == std::string_view::npos)
+		{
+			break;
+		}
 
-		result += match.prefix().str();
-		result += LoadShaderSourceFile(parent / match[1u].str());
+		result.append(source.substr(position, start - position));
+		result += LoadShaderSourceFile(parent / source.substr(nameStart, nameEnd - nameStart), files);
 
-		searchStart = match.suffix().first;
+		position = nameEnd + 1u;
 	}
 
-	if(!hasInclude)
+	if(position == 0u)
 	{
-		return source;
+		return std::string(source);
 	}
 
-	result += match.suffix().str();
+	result.append(source.substr(position));
+
 	return result;
 }
@@ -2,10 +2,19 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+class FileBatch;
 
 /**
  * @brief OpenGL program wrapper.
+ *
+ * Linked programs are cached on disk as driver specific binaries, keyed by the preprocessed sources and the driver's identity.
+ * On drivers with 'GL_KHR_parallel_shader_compile' the compilation runs in the background until the program is first used,
+ * see @ref IsReady to avoid waiting for it.
  */
 class Shader
 {
@@ -15,14 +24,24 @@ public:
 	 */
 	using Sources = std::unordered_map<uint32_t, std::filesystem::path>;
 
+	/**
+	 * @brief Sets up the program cache and the background compilation.
+	 *
+	 * Must be called after the OpenGL context was created and before any shader is created.
+	 *
+	 * @param cacheDirectory The directory of the cached programs, empty to compile every time.
+	 */
+	static auto Initialize(const std::filesystem::path& cacheDirectory) -> void;
+
 	/**
 	 * @brief Creates a shader from multiple stages.
 	 *
-	 * Loads and compiles multiple shader stages and links them together.
-	 * 
+	 * Loads the program from the cache, or starts compiling the stages and linking them together.
+	 *
 	 * @param sources The paths to the shader stages source files.
+	 * @param files The files read ahead, the sources and includes missing from it are read on the calling thread.
 	 */
-	Shader(const Sources& sources);
+	Shader(const Sources& sources, const FileBatch& files);
 
 	/**
 	 * @brief Deletes the program.
@@ -45,20 +64,90 @@ public:
 
 	/**
 	 * @brief Makes the shader active.
+	 *
+	 * Waits for the compilation if it is still running.
+	 */
+	auto Use() -> void;
+
+	/**
+	 * @brief Checks whether the program finished linking, without waiting for it.
+	 *
+	 * Reports the errors and stores the program in the cache once it did.
+	 *
+	 * @return 'true' if the program can be used without waiting, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsReady() -> bool;
+
+	/**
+	 * @brief Checks whether the program linked successfully, waiting for the compilation if it is still running.
+	 *
+	 * @return 'true' if the program can be used, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsValid() -> bool;
+
+	/**
+	 * @brief Checks whether the program was loaded from the cache.
+	 *
+	 * @return 'true' if the program was loaded from the cache, 'false' if it was compiled.
 	 */
-	auto Use() const noexcept -> void;
+	[[nodiscard]] auto IsCached() const noexcept -> bool
+	{
+		return m_isCached;
+	}
 
 private:
+	/**
+	 * @brief The directory of the cached programs, empty if the cache is disabled.
+	 */
+	static inline std::filesystem::path s_cacheDirectory;
+
+	/**
+	 * @brief The driver's identity, programs of other drivers or versions can't be loaded.
+	 */
+	static inline std::string s_driverIdentity;
+	static inline bool s_isParallelCompileSupported = false;
+
 	uint32_t m_handle;
 
+	/**
+	 * @brief The stages still attached to the program and their source files, empty once the program is finalized.
+	 */
+	std::vector<std::pair<uint32_t, std::filesystem::path>> m_stages;
+
+	/**
+	 * @brief The file the program is cached in, empty if the cache is disabled.
+	 */
+	std::filesystem::path m_cachePath;
+	bool m_isFinalized = false;
+	bool m_isValid = false;
+	bool m_isCached = false;
+
+	/**
+	 * @brief Loads the program from the cache.
+	 *
+	 * @return 'true' if the cached program linked successfully, otherwise 'false'.
+	 */
+	[[nodiscard]] auto LoadFromCache() -> bool;
+
+	/**
+	 * @brief Stores the linked program in the cache.
+	 */
+	auto SaveToCache() const -> void;
+
+	/**
+	 * @brief Reports the compilation and link errors and releases the stages, waits for the compilation if it is still running.
+	 */
+	auto Finalize() -> void;
+
 	/**
 	 * @brief Loads and preprocesses a shader source file.
 	 *
 	 * Handles relative includes.
-	 * 
+	 *
 	 * @param path The path of the file.
-	 * 
+	 * @param files The files read ahead.
+	 *
 	 * @return A string containing the source.
 	 */
-	[[nodiscard]] static auto LoadShaderSourceFile(const std::filesystem::path& path) -> std::string;
+	[[nodiscard]] static auto LoadShaderSourceFile(const std::filesystem::path& path, const FileBatch& files) -> std::string;
 };
@@ -6,6 +6,7 @@
 #include <stb/stb_image.h>
 
 Texture::Texture(const glm::uvec2& size, uint32_t format, uint32_t unit)
+	: m_format(format)
 {
 	glCreateTextures(GL_TEXTURE_2D, 1, &m_handle);
 	glTextureParameteri(m_handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -13,14 +14,13 @@ Texture::Texture(const glm::uvec2& size, uint32_t format, uint32_t unit)
 	glTextureParameteri(m_handle, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTextureParameteri(m_handle, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTextureStorage2D(m_handle, 1, format, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y));
-	glBindTextureUnit(unit, m_handle);
-	glBindImageTexture(unit, m_handle, 0, GL_FALSE, 0, GL_READ_WRITE, format);
+	Bind(unit);
 }
 
-Texture::Texture(const std::filesystem::path& path, uint32_t unit)
+Texture::Texture(std::span<const uint8_t> fileData, uint32_t unit)
 {
 	int32_t width, height, channels;
-	uint8_t* data = stbi_load(path.string().c_str(), &width, &height, &channels, 0);
+	uint8_t* data = stbi_load_from_memory(fileData.data(), static_cast<int>(fileData.size()), &width, &height, &channels, 0);
 
 	glCreateTextures(GL_TEXTURE_2D, 1, &m_handle);
 	glTextureParameteri(m_handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -43,3 +43,13 @@ auto Texture::Clear(const glm::vec4& color) const -> void
 {
 	glClearTexImage(m_handle, 0u, GL_RGBA, GL_FLOAT, glm::value_ptr(color));
 }
+
+auto Texture::Bind(uint32_t unit) const -> void
+{
+	glBindTextureUnit(unit, m_handle);
+
+	if(m_format != 0u)
+	{
+		glBindImageTexture(unit, m_handle, 0, GL_FALSE, 0, GL_READ_WRITE, m_format);
+	}
+}
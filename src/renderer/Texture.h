@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <unordered_map>
 #include <filesystem>
+#include <span>
 
 /**
  * @brief OpenGL texture wrapper.
@@ -24,11 +25,12 @@ public:
 	Texture(const glm::uvec2& size, uint32_t format, uint32_t unit = 0u);
 
 	/**
-	 * @brief Loads a texture from a file.
+	 * @brief Decodes a texture from the contents of an image file.
 	 * 
-	 * @param path The path of the file.
+	 * @param fileData The bytes of the file.
+	 * @param unit The unit that texture will be bound to.
 	 */
-	Texture(const std::filesystem::path& path, uint32_t unit = 0u);
+	Texture(std::span<const uint8_t> fileData, uint32_t unit = 0u);
 
 	/**
 	 * @brief Deletes the texture.
@@ -42,6 +44,13 @@ public:
 	 */
 	auto Clear(const glm::vec4& color) const -> void;
 
+	/**
+	 * @brief Binds the texture to a texture unit and, if it is a render target, to the image unit of the same index.
+	 *
+	 * @param unit The unit the texture will be bound to.
+	 */
+	auto Bind(uint32_t unit) const -> void;
+
 	/**
 	 * @brief Retrieves the GLuint handle of the program.
 	 */
@@ -52,4 +61,9 @@ public:
 
 private:
 	uint32_t m_handle;
+
+	/**
+	 * @brief The format of a render target used when binding it as an image, 0 for loaded textures.
+	 */
+	uint32_t m_format = 0u;
 };
@@ -4,6 +4,8 @@
 
 #include <GLFW/glfw3.h>
 
+#include <cstdio>
+
 Window::Window(const WindowSettings& settings)
 	: m_settings(settings)
 {
@@ -16,8 +18,33 @@ Window::Window(const WindowSettings& settings)
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_VISIBLE, m_settings.IsVisible ? GLFW_TRUE : GLFW_FALSE);
+
+	// Offscreen contexts try EGL and then OSMesa before the native API, Mesa's software rasterizer provides both on machines without a GPU
+	if(!m_settings.IsVisible)
+	{
+		for(int contextApi : { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API, GLFW_NATIVE_CONTEXT_API })
+		{
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+
+			m_handle = glfwCreateWindow(static_cast<int>(m_settings.Size.x), static_cast<int>(m_settings.Size.y), m_settings.Title.data(), nullptr, nullptr);
+			if(m_handle != nullptr)
+			{
+				break;
+			}
+		}
+
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+	}
+	else
+	{
+		m_handle = glfwCreateWindow(static_cast<int>(m_settings.Size.x), static_cast<int>(m_settings.Size.y), m_settings.Title.data(), nullptr, nullptr);
+	}
 
-	m_handle = glfwCreateWindow(static_cast<int>(m_settings.Size.x), static_cast<int>(m_settings.Size.y), m_settings.Title.data(), nullptr, nullptr);
+	if(m_handle == nullptr)
+	{
+		printf("Couldn't create a window with an OpenGL 4.6 context\n");
+	}
 }
 
 Window::~Window()
@@ -43,5 +70,6 @@ auto WindowSettings::LoadFromConfig() -> WindowSettings
 			static_cast<uint32_t>(Config::Get<int64_t>("window", "iHeight"))
 		),
 		.Title = Config::Get<std::string>("window", "sTitle"),
+		.IsVisible = true,
 	};
 }
@@ -22,6 +22,11 @@ struct WindowSettings
 	 */
 	std::string Title;
 
+	/**
+	 * @brief Whether the window is shown, hidden windows only provide a context for offscreen rendering.
+	 */
+	bool IsVisible = true;
+
 	/**
 	 * @brief Loads the settings from the config file.
 	 *
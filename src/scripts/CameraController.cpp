@@ -12,10 +12,16 @@
 
 CameraController::CameraController(Camera& camera)
 	: m_camera(camera),
-	m_movementSpeed(static_cast<float>(Config::Get<double>("camera", "fMovementSpeed"))),
-	m_rotationSpeed(static_cast<float>(Config::Get<double>("camera", "fRotationSpeed"))),
+	m_movementSpeed("camera", "fMovementSpeed"),
+	m_rotationSpeed("camera", "fRotationSpeed"),
+	m_fieldOfView("camera", "fFieldOfView"),
 	m_movement(0.0f), m_rotation(camera.Rotation)
 {
+	m_fieldOfView.OnChanged += [&] (const double& fieldOfView) -> void
+		{
+			m_camera.FieldOfView = static_cast<float>(fieldOfView);
+		};
+
 	Input::OnKey += [&] (int key, bool isPressed) -> void
 		{
 			if(GUI::IsVisible)
@@ -30,16 +36,16 @@ CameraController::CameraController(Camera& camera)
 			switch(key)
 			{
 			case GLFW_KEY_D:
-				m_movement.x += dir * m_movementSpeed;
+				m_movement.x += dir;
 				break;
 			case GLFW_KEY_A:
-				m_movement.x -= dir * m_movementSpeed;
+				m_movement.x -= dir;
 				break;
 			case GLFW_KEY_S:
-				m_movement.z += dir * m_movementSpeed;
+				m_movement.z += dir;
 				break;
 			case GLFW_KEY_W:
-				m_movement.z -= dir * m_movementSpeed;
+				m_movement.z -= dir;
 				break;
 			}
 		};
@@ -51,8 +57,9 @@ CameraController::CameraController(Camera& camera)
 				return;
 			}
 
-			m_rotation.y -= delta.x * m_rotationSpeed;
-			m_rotation.x -= delta.y * m_rotationSpeed;
+			float rotationSpeed = static_cast<float>(m_rotationSpeed.Get());
+			m_rotation.y -= delta.x * rotationSpeed;
+			m_rotation.x -= delta.y * rotationSpeed;
 			m_rotation.x = glm::clamp(m_rotation.x, -89.999f, 89.999f);
 		};
 
@@ -71,12 +78,24 @@ CameraController::CameraController(Camera& camera)
 			ImGui::SetNextWindowSize(ImVec2(350.0f, 100.0f));
 			ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
 			ImGui::Begin("Camera", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
-			ImGui::SliderFloat("Movement Speed", &m_movementSpeed, 1.0f, 20.0f, "%.1f");
-			Config::Get<double>("camera", "fMovementSpeed") = m_movementSpeed;
-			ImGui::SliderFloat("Rotation Speed", &m_rotationSpeed, 0.01f, 1.0f, "%.2f");
-			Config::Get<double>("camera", "fRotationSpeed") = m_rotationSpeed;
-			ImGui::SliderFloat("Field of View", &m_camera.FieldOfView, 30.0f, 90.0f, "%.0f");
-			Config::Get<double>("camera", "fFieldOfView") = m_camera.FieldOfView;
+			// The config is only written when a slider moved
+			float movementSpeed = static_cast<float>(m_movementSpeed.Get());
+			if(ImGui::SliderFloat("Movement Speed", &movementSpeed, 1.0f, 20.0f, "%.1f"))
+			{
+				m_movementSpeed.Set(movementSpeed);
+			}
+
+			float rotationSpeed = static_cast<float>(m_rotationSpeed.Get());
+			if(ImGui::SliderFloat("Rotation Speed", &rotationSpeed, 0.01f, 1.0f, "%.2f"))
+			{
+				m_rotationSpeed.Set(rotationSpeed);
+			}
+
+			float fieldOfView = m_camera.FieldOfView;
+			if(ImGui::SliderFloat("Field of View", &fieldOfView, 30.0f, 90.0f, "%.0f"))
+			{
+				m_fieldOfView.Set(fieldOfView);
+			}
 			ImGui::End();
 		};
 }
@@ -84,5 +103,5 @@ CameraController::CameraController(Camera& camera)
 auto CameraController::Update() -> void
 {
 	m_camera.Rotation = glm::vec3(m_rotation, 0.0f);
-	m_camera.Position += glm::quat(glm::radians(m_camera.Rotation)) * m_movement * Time::GetDeltaTime();
+	m_camera.Position += glm::quat(glm::radians(m_camera.Rotation)) * m_movement * static_cast<float>(m_movementSpeed.Get()) * Time::GetDeltaTime();
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../utility/Config.h"
+
 #include <glm/glm.hpp>
 
 struct Camera;
@@ -24,8 +26,13 @@ public:
 
 private:
 	Camera& m_camera;
-	float m_movementSpeed;
-	float m_rotationSpeed;
+	ConfigValue<double> m_movementSpeed;
+	ConfigValue<double> m_rotationSpeed;
+	ConfigValue<double> m_fieldOfView;
+
+	/**
+	 * @brief The direction of the pressed keys, the speed is applied when moving so it can change while a key is held.
+	 */
 	glm::vec3 m_movement;
 	glm::vec2 m_rotation;
 };
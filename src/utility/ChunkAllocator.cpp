@@ -1,10 +1,12 @@
 #include "ChunkAllocator.h"
 
+#include "Profiler.h"
+
 #include <algorithm>
 #include <ranges>
 
-ChunkAllocator::ChunkAllocator(size_t size, void* data)
-	: m_data(static_cast<uint8_t*>(data), size)
+ChunkAllocator::ChunkAllocator(size_t size, void* data, uint32_t framesInFlight)
+	: m_data(static_cast<uint8_t*>(data), size), m_retiredBlocks(framesInFlight)
 {
 	m_freeBlocks.emplace_back(
 		MemoryBlock{
@@ -13,23 +15,169 @@ ChunkAllocator::ChunkAllocator(size_t size, void* data)
 		});
 }
 
-auto ChunkAllocator::Allocate(const glm::ivec2& coordinate, const Chunk& chunk) -> bool
+auto ChunkAllocator::Allocate(const glm::ivec3& coordinate, const Chunk& chunk) -> bool
+{
+	PROFILE_SCOPE("ChunkAllocator::Allocate");
+
+	std::scoped_lock lock(m_mutex);
+
+	return AllocateBlock(coordinate, chunk);
+}
+
+auto ChunkAllocator::Free(const glm::ivec3& coordinate) -> void
+{
+	PROFILE_SCOPE("ChunkAllocator::Free");
+
+	std::scoped_lock lock(m_mutex);
+
+	FreeBlock(coordinate);
+}
+
+auto ChunkAllocator::Update(const glm::ivec3& coordinate, const Chunk& previous, const Chunk& chunk) -> std::optional<size_t>
+{
+	PROFILE_SCOPE("ChunkAllocator::Update");
+
+	std::scoped_lock lock(m_mutex);
+
+	std::span<const uint8_t> data = chunk.Data();
+	std::span<const uint8_t> previousData = previous.Data();
+
+	// Rewrite only the differing bytes if the nodes and the lighting still fit the block exactly.
+	auto it = m_allocatedChunks.find(coordinate);
+	if(
+		it != m_allocatedChunks.end() &&
+		!it->second.IsSolid &&
+		!chunk.IsUniform() &&
+		data.size() + GetChunkLightingSize(chunk) == it->second.Block.Size &&
+		previousData.size() == data.size() &&
+		chunk.GetLeafCount() == it->second.LeafCount)
+	{
+		auto [first, previousFirst] = std::ranges::mismatch(data, previousData);
+		if(first == data.end())
+		{
+			return 0u;
+		}
+
+		// Frames in flight could see a half written tree, so the chunk moves to a new block unless nothing reads the buffer meanwhile
+		if(m_retiredBlocks.empty())
+		{
+			auto [last, previousLast] = std::ranges::mismatch(data | std::views::reverse, previousData | std::views::reverse);
+
+			size_t begin = static_cast<size_t>(first - data.begin());
+			size_t end = data.size() - static_cast<size_t>(last - data.rbegin());
+
+			std::ranges::copy(
+				data.subspan(begin, end - begin),
+				m_data.subspan(it->second.Block.Offset + begin, end - begin).begin()
+			);
+
+			it->second.CoarseOccupancy = GetCoarseOccupancy(chunk);
+
+			return end - begin;
+		}
+	}
+
+	// The previous block is kept until the edited chunk found a new one, frames in flight may still read it anyway.
+	if(it == m_allocatedChunks.end())
+	{
+		return AllocateBlock(coordinate, chunk) ? std::optional<size_t>(data.size() + GetChunkLightingSize(chunk)) : std::nullopt;
+	}
+
+	ChunkAllocation previousAllocation = it->second;
+	m_allocatedChunks.erase(it);
+
+	if(!AllocateBlock(coordinate, chunk))
+	{
+		m_allocatedChunks.insert({ coordinate, previousAllocation });
+
+		return std::nullopt;
+	}
+
+	if(previousAllocation.Block.Size > 0u)
+	{
+		RetireBlock(previousAllocation.Block);
+	}
+
+	return data.size() + GetChunkLightingSize(chunk);
+}
+
+auto ChunkAllocator::BeginFrame(uint32_t slot) -> void
 {
 	std::scoped_lock lock(m_mutex);
 
+	if(slot >= m_retiredBlocks.size())
+	{
+		return;
+	}
+
+	for(const MemoryBlock& block : m_retiredBlocks[slot])
+	{
+		ReleaseBlock(block);
+	}
+
+	m_retiredBlocks[slot].clear();
+	m_frameSlot = slot;
+}
+
+auto ChunkAllocator::UpdateLighting(const glm::ivec3& coordinate, std::span<const uint8_t> lighting) -> bool
+{
+	PROFILE_SCOPE("ChunkAllocator::UpdateLighting");
+
+	std::scoped_lock lock(m_mutex);
+
+	auto it = m_allocatedChunks.find(coordinate);
+	if(it == m_allocatedChunks.end() || it->second.IsSolid || lighting.size() != it->second.LeafCount * ChunkLightingStride)
+	{
+		return false;
+	}
+
+	std::ranges::copy(lighting, m_data.subspan(it->second.LightingOffset, lighting.size()).begin());
+
+	return true;
+}
+
+auto ChunkAllocator::AllocateBlock(const glm::ivec3& coordinate, const Chunk& chunk) -> bool
+{
 	if(m_allocatedChunks.contains(coordinate))
 	{
 		return false;
 	}
 
+	// Uniform chunks are only tagged.
+	if(chunk.IsUniform())
+	{
+		if(chunk.GetUniformValue() != 0u)
+		{
+			m_allocatedChunks.insert(
+				{
+					coordinate,
+					ChunkAllocation{
+						.Block = MemoryBlock{
+							.Offset = 0u,
+							.Size = 0u,
+						},
+						.LightingOffset = 0u,
+						.LeafCount = 0u,
+						.CoarseOccupancy = ~0ull,
+						.IsSolid = true,
+						.SolidValue = chunk.GetUniformValue(),
+					}
+				});
+		}
+
+		return true;
+	}
+
 	std::span<const uint8_t> data = chunk.Data();
+	size_t leafCount = chunk.GetLeafCount();
+	size_t size = data.size() + leafCount * ChunkLightingStride;
 
 	// Find a free block that is large enough.
 	auto it = std::ranges::find_if(
 		m_freeBlocks,
 		[&] (const MemoryBlock& block) -> bool
 		{
-			return block.Size >= data.size();
+			return block.Size >= size;
 		});
 
 	if(it == m_freeBlocks.end())
@@ -39,43 +187,77 @@ auto ChunkAllocator::Allocate(const glm::ivec2& coordinate, const Chunk& chunk)
 
 	MemoryBlock chunkBlock{
 		.Offset = it->Offset,
-		.Size = data.size(),
+		.Size = size,
 	};
 
 	// If the free block is the same size as the needed memory, remove the freeblock.
-	if(it->Size == data.size())
+	if(it->Size == size)
 	{
 		m_freeBlocks.erase(it);
 	}
 	// Otherwise shrink it.
 	else
 	{
-		it->Offset += data.size();
-		it->Size -= data.size();
+		it->Offset += size;
+		it->Size -= size;
 	}
 
-	// Copy the memory into the buffer.
+	// Copy the memory into the buffer, the lighting is fully lit until it is baked.
 	std::ranges::copy(
 		data,
-		m_data.subspan(chunkBlock.Offset, chunkBlock.Size).begin()
+		m_data.subspan(chunkBlock.Offset, data.size()).begin()
 	);
+	std::ranges::fill(m_data.subspan(chunkBlock.Offset + data.size(), size - data.size()), UnbakedLighting);
 
-	m_allocatedChunks.insert({ coordinate, chunkBlock });
+	m_allocatedChunks.insert(
+		{
+			coordinate,
+			ChunkAllocation{
+				.Block = chunkBlock,
+				.LightingOffset = chunkBlock.Offset + data.size(),
+				.LeafCount = leafCount,
+				.CoarseOccupancy = GetCoarseOccupancy(chunk),
+				.IsSolid = false,
+				.SolidValue = 0u,
+			}
+		});
 
 	return true;
 }
 
-auto ChunkAllocator::Free(const glm::ivec2& coordinate) -> void
+auto ChunkAllocator::FreeBlock(const glm::ivec3& coordinate) -> void
 {
-	std::scoped_lock lock(m_mutex);
+	auto it = m_allocatedChunks.find(coordinate);
+	if(it == m_allocatedChunks.end())
+	{
+		return;
+	}
 
-	if(!m_allocatedChunks.contains(coordinate))
+	const MemoryBlock chunkBlock = it->second.Block;
+	m_allocatedChunks.erase(it);
+
+	if(chunkBlock.Size == 0u)
 	{
 		return;
 	}
 
-	const MemoryBlock& chunkBlock = m_allocatedChunks.at(coordinate);
+	RetireBlock(chunkBlock);
+}
 
+auto ChunkAllocator::RetireBlock(const MemoryBlock& block) -> void
+{
+	if(m_retiredBlocks.empty())
+	{
+		ReleaseBlock(block);
+
+		return;
+	}
+
+	m_retiredBlocks[m_frameSlot].push_back(block);
+}
+
+auto ChunkAllocator::ReleaseBlock(const MemoryBlock& chunkBlock) -> void
+{
 	std::vector<MemoryBlock>::iterator itBefore = std::ranges::find_if(
 		m_freeBlocks,
 		[&] (const MemoryBlock& block) -> bool
@@ -113,6 +295,4 @@ auto ChunkAllocator::Free(const glm::ivec2& coordinate) -> void
 		itAfter->Offset -= chunkBlock.Size;
 		itAfter->Size += chunkBlock.Size;
 	}
-
-	m_allocatedChunks.erase(coordinate);
 }
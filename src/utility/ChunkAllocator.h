@@ -1,11 +1,14 @@
 #pragma once
 
 #include "../world/Chunk.h"
+#include "../world/ChunkLighting.h"
+#include "../world/CoarseDepth.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtx/hash.hpp>
 
 #include <mutex>
+#include <optional>
 #include <span>
 #include <unordered_map>
 #include <vector>
@@ -26,8 +29,48 @@ struct MemoryBlock
 	size_t Size;
 };
 
+/**
+ * @brief Describes the storage of an allocated chunk.
+ */
+struct ChunkAllocation
+{
+	/**
+	 * @brief The memory block of the chunk's nodes followed by its lighting. Zero sized if the chunk is solid.
+	 */
+	MemoryBlock Block;
+
+	/**
+	 * @brief The offset of the chunk's lighting in the buffer, right after the nodes.
+	 */
+	size_t LightingOffset;
+
+	/**
+	 * @brief The number of leaves of the chunk, the last nodes before the lighting.
+	 */
+	size_t LeafCount;
+
+	/**
+	 * @brief Which coarse cells of the chunk contain solid voxels, see @ref GetCoarseOccupancy.
+	 */
+	uint64_t CoarseOccupancy;
+
+	/**
+	 * @brief Whether the chunk is entirely solid, in which case no nodes are stored.
+	 */
+	bool IsSolid;
+
+	/**
+	 * @brief The value of every voxel if the chunk is solid.
+	 */
+	uint8_t SolidValue;
+};
+
 /**
  * @brief Wraps an already allocated buffer to manage it.
+ *
+ * Uniform chunks take up no memory. Solid chunks are only tagged, empty ones aren't stored at all.
+ * Every other chunk reserves @ref ChunkLightingStride bytes of lighting per leaf after its nodes, unbaked until @ref UpdateLighting.
+ * Blocks freed while the GPU may still read them are only reused once the frames in flight finished, see @ref BeginFrame.
  */
 class ChunkAllocator
 {
@@ -36,8 +79,9 @@ public:
 	 * @brief Wraps a buffer.
 	 * 
 	 * @param data A span to a buffer.
+	 * @param framesInFlight The number of frames that may read the buffer at the same time, 0 if nothing reads it asynchronously.
 	 */
-	ChunkAllocator(size_t size, void* data);
+	ChunkAllocator(size_t size, void* data, uint32_t framesInFlight = 0u);
 
 	/**
 	 * @brief Allocates memory for a chunk.
@@ -45,16 +89,50 @@ public:
 	 * @param coordinate The coordinate of the chunk.
 	 * @param chunk The chunk.
 	 *
-	 * @return Whether the allocation was successful.
+	 * @return Whether the allocation was successful. Always succeeds for empty chunks.
 	 */
-	auto Allocate(const glm::ivec2& coordinate, const Chunk& chunk) -> bool;
+	auto Allocate(const glm::ivec3& coordinate, const Chunk& chunk) -> bool;
 
 	/**
 	 * @brief Frees up the allocated memory of a chunk.
 	 * 
 	 * @param coordinate The coordinate of the chunk.
 	 */
-	auto Free(const glm::ivec2& coordinate) -> void;
+	auto Free(const glm::ivec3& coordinate) -> void;
+
+	/**
+	 * @brief Replaces an allocated chunk by an edited version of it.
+	 *
+	 * If nothing reads the buffer asynchronously and neither the size of the nodes nor the number of leaves changed, only the range of bytes
+	 * that differ is written into the existing block and the lighting stays until it is baked again.
+	 * Otherwise the chunk moves to a new block with unbaked lighting, the old block is freed once the frames in flight finished.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param previous The chunk as it is currently allocated.
+	 * @param chunk The edited chunk.
+	 *
+	 * @return The number of bytes written including the lighting, or 'std::nullopt' if the edited chunk doesn't fit, in which case the previous one stays with its lighting.
+	 */
+	auto Update(const glm::ivec3& coordinate, const Chunk& previous, const Chunk& chunk) -> std::optional<size_t>;
+
+	/**
+	 * @brief Starts recording a frame, reusing the blocks freed while the frame that last used its slot was recorded.
+	 *
+	 * Must only be called once the GPU finished that frame, the frames before it finished too by then.
+	 *
+	 * @param slot The frame slot, less than the number of frames in flight.
+	 */
+	auto BeginFrame(uint32_t slot) -> void;
+
+	/**
+	 * @brief Replaces the lighting of an allocated chunk.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param lighting The lighting of every leaf of the chunk, @ref ChunkLightingStride bytes each.
+	 *
+	 * @return Whether the lighting was written. Fails if the chunk isn't allocated or has a different number of leaves.
+	 */
+	auto UpdateLighting(const glm::ivec3& coordinate, std::span<const uint8_t> lighting) -> bool;
 
 	/**
 	 * @brief Retrieves tzhe mutex of the managed memory.
@@ -71,7 +149,7 @@ public:
 	 * 
 	 * @return An iterator to the first allocated chunk.
 	 */
-	[[nodiscard]] auto begin() const noexcept -> std::unordered_map<glm::ivec2, MemoryBlock>::const_iterator
+	[[nodiscard]] auto begin() const noexcept -> std::unordered_map<glm::ivec3, ChunkAllocation>::const_iterator
 	{
 		return m_allocatedChunks.begin();
 	}
@@ -81,7 +159,7 @@ public:
 	 * 
 	 * @return An iterator to the last allocated chunk.
 	 */
-	[[nodiscard]] auto end() const noexcept -> std::unordered_map<glm::ivec2, MemoryBlock>::const_iterator
+	[[nodiscard]] auto end() const noexcept -> std::unordered_map<glm::ivec3, ChunkAllocation>::const_iterator
 	{
 		return m_allocatedChunks.end();
 	}
@@ -89,6 +167,43 @@ public:
 private:
 	std::span<uint8_t> m_data;
 	std::vector<MemoryBlock> m_freeBlocks;
-	std::unordered_map<glm::ivec2, MemoryBlock> m_allocatedChunks;
+	std::unordered_map<glm::ivec3, ChunkAllocation> m_allocatedChunks;
 	std::mutex m_mutex;
+
+	/**
+	 * @brief The blocks freed while each frame slot was recorded, empty if nothing reads the buffer asynchronously.
+	 */
+	std::vector<std::vector<MemoryBlock>> m_retiredBlocks;
+	uint32_t m_frameSlot = 0u;
+
+	/**
+	 * @brief Allocates memory for a chunk, the mutex must be locked.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param chunk The chunk.
+	 *
+	 * @return Whether the allocation was successful.
+	 */
+	auto AllocateBlock(const glm::ivec3& coordinate, const Chunk& chunk) -> bool;
+
+	/**
+	 * @brief Frees up the allocated memory of a chunk, the mutex must be locked.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 */
+	auto FreeBlock(const glm::ivec3& coordinate) -> void;
+
+	/**
+	 * @brief Keeps a block until the frames that may read it finished, the mutex must be locked.
+	 *
+	 * @param block The block.
+	 */
+	auto RetireBlock(const MemoryBlock& block) -> void;
+
+	/**
+	 * @brief Returns a block to the free ones, merging it with its neighbours, the mutex must be locked.
+	 *
+	 * @param block The block.
+	 */
+	auto ReleaseBlock(const MemoryBlock& block) -> void;
 };
@@ -2,15 +2,151 @@
 
 #include <toml++/toml.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
 namespace
 {
 	constexpr auto DefaultConfigFilePath = "config.default.toml";
 	constexpr auto ConfigFilePath = "config.toml";
 
+	/**
+	 * @brief The time between checks of the file's modification time.
+	 */
+	constexpr std::chrono::milliseconds WatchInterval(500);
+
+	struct Subscription
+	{
+		/**
+		 * @brief Identifies the subscription while its callbacks run, the vector may change in the meantime.
+		 */
+		uint64_t Id;
+
+		const void* Subscriber;
+		const void* Value;
+		std::function<void()> Callback;
+	};
+
 	toml::table s_table;
+	std::vector<Subscription> s_subscriptions;
+	uint64_t s_nextSubscriptionId = 0u;
+	std::filesystem::file_time_type s_lastWriteTime;
+	std::chrono::steady_clock::time_point s_nextWatchTime;
+
+	/**
+	 * @brief Parses a file without failing on syntax errors, the file may be read while an editor is still writing it.
+	 *
+	 * @param path The path of the file.
+	 *
+	 * @return The parsed file, 'std::nullopt' if it isn't valid.
+	 */
+	[[nodiscard]] auto TryParseFile(const char* path) -> std::optional<toml::table>
+	{
+#if TOML_EXCEPTIONS
+		try
+		{
+			return toml::parse_file(path);
+		}
+		catch(const toml::parse_error& error)
+		{
+			printf("Couldn't parse '%s': %s\n", path, std::string(error.description()).c_str());
+
+			return std::nullopt;
+		}
+#else
+		toml::parse_result result = toml::parse_file(path);
+		if(!result)
+		{
+			printf("Couldn't parse '%s': %s\n", path, std::string(result.error().description()).c_str());
+
+			return std::nullopt;
+		}
+
+		return std::move(result).table();
+#endif
+	}
+
+	/**
+	 * @brief Overwrites a value with the one from the file.
+	 *
+	 * @tparam T The type of both values.
+	 *
+	 * @param node The current value.
+	 * @param value The value from the file.
+	 * @param changedValues Receives the current value if it changed.
+	 */
+	template<typename T>
+	auto Assign(toml::node& node, const toml::node& value, std::vector<const void*>& changedValues) -> void
+	{
+		T& current = node.as<T>()->get();
+		const T& next = value.as<T>()->get();
+		if(current != next)
+		{
+			current = next;
+			changedValues.push_back(&current);
+		}
+	}
+
+	/**
+	 * @brief Overwrites the values of the current state with the ones from the file, keeping their addresses.
+	 *
+	 * @param file The parsed file.
+	 *
+	 * @return The values that changed.
+	 */
+	auto ApplyChanges(const toml::table& file) -> std::vector<const void*>
+	{
+		std::vector<const void*> changedValues;
+		for(auto&& [tableName, fileTable] : file)
+		{
+			toml::table* table = s_table[tableName].as_table();
+			if(table == nullptr || !fileTable.is_table())
+			{
+				continue;
+			}
+
+			for(auto&& [key, value] : *fileTable.as_table())
+			{
+				toml::node* node = table->get(key);
+				if(node == nullptr)
+				{
+					continue;
+				}
+
+				if(node->type() != value.type())
+				{
+					printf("Ignoring '%s.%s', it must keep its type\n", std::string(tableName.str()).c_str(), std::string(key.str()).c_str());
+
+					continue;
+				}
+
+				switch(node->type())
+				{
+					case toml::node_type::integer:
+						Assign<int64_t>(*node, value, changedValues);
+						break;
+					case toml::node_type::floating_point:
+						Assign<double>(*node, value, changedValues);
+						break;
+					case toml::node_type::boolean:
+						Assign<bool>(*node, value, changedValues);
+						break;
+					case toml::node_type::string:
+						Assign<std::string>(*node, value, changedValues);
+						break;
+					default:
+						break;
+				}
+			}
+		}
+
+		return changedValues;
+	}
 }
 
 auto Config::Load() -> void
@@ -21,13 +157,127 @@ auto Config::Load() -> void
 	}
 
 	s_table = toml::parse_file(ConfigFilePath);
+
+	// Add the values introduced since the config file was created.
+	toml::table defaults = toml::parse_file(DefaultConfigFilePath);
+	for(auto&& [tableName, defaultTable] : defaults)
+	{
+		if(!defaultTable.is_table())
+		{
+			continue;
+		}
+
+		if(toml::table* table = s_table[tableName].as_table(); table != nullptr)
+		{
+			for(auto&& [key, value] : *defaultTable.as_table())
+			{
+				table->insert(key, value);
+			}
+		}
+		else
+		{
+			s_table.insert(tableName, *defaultTable.as_table());
+		}
+	}
+
+	std::error_code error;
+	s_lastWriteTime = std::filesystem::last_write_time(ConfigFilePath, error);
 }
 
 auto Config::Save() -> void
 {
-	std::ofstream file(ConfigFilePath);
+	{
+		std::ofstream file(ConfigFilePath);
+
+		file << s_table << std::endl;
+	}
+
+	// The state is already up to date with its own file
+	std::error_code error;
+	s_lastWriteTime = std::filesystem::last_write_time(ConfigFilePath, error);
+}
 
-	file << s_table << std::endl;
+auto Config::Update() -> void
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if(now < s_nextWatchTime)
+	{
+		return;
+	}
+
+	s_nextWatchTime = now + WatchInterval;
+
+	std::error_code error;
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(ConfigFilePath, error);
+	if(error || writeTime == s_lastWriteTime)
+	{
+		return;
+	}
+
+	// A file that doesn't parse is skipped until it is written again
+	s_lastWriteTime = writeTime;
+
+	std::optional<toml::table> file = TryParseFile(ConfigFilePath);
+	if(!file.has_value())
+	{
+		return;
+	}
+
+	// Every value is applied before the callbacks run, so they see the file's state
+	std::vector<const void*> changedValues = ApplyChanges(*file);
+	for(const void* value : changedValues)
+	{
+		NotifyChanged(value);
+	}
+
+	if(!changedValues.empty())
+	{
+		printf("Applied %zu changed values from '%s'\n", changedValues.size(), ConfigFilePath);
+	}
+}
+
+auto Config::Subscribe(const void* subscriber, const void* value, std::function<void()> callback) -> void
+{
+	s_subscriptions.push_back(Subscription{
+		.Id = s_nextSubscriptionId++,
+		.Subscriber = subscriber,
+		.Value = value,
+		.Callback = std::move(callback),
+	});
+}
+
+auto Config::Unsubscribe(const void* subscriber) -> void
+{
+	std::erase_if(s_subscriptions, [subscriber] (const Subscription& subscription) -> bool
+		{
+			return subscription.Subscriber == subscriber;
+		});
+}
+
+auto Config::NotifyChanged(const void* value) -> void
+{
+	// Callbacks may subscribe or unsubscribe handles, so only the subscriptions present now are notified, if they still exist by then
+	std::vector<uint64_t> ids;
+	for(const Subscription& subscription : s_subscriptions)
+	{
+		if(subscription.Value == value)
+		{
+			ids.push_back(subscription.Id);
+		}
+	}
+
+	for(uint64_t id : ids)
+	{
+		auto it = std::ranges::find(s_subscriptions, id, &Subscription::Id);
+		if(it == s_subscriptions.end())
+		{
+			continue;
+		}
+
+		// Copied since subscribing from the callback may move the subscriptions
+		std::function<void()> callback = it->Callback;
+		callback();
+	}
 }
 
 template<>
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Action.h"
+
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -9,6 +12,8 @@ namespace Config
 {
 	/**
 	 * @brief Loads the configs from the file overwriting the current state.
+	 *
+	 * Must be called before any @ref ConfigValue is created, the handles point into the loaded state.
 	 */
 	auto Load() -> void;
 
@@ -17,14 +22,23 @@ namespace Config
 	 */
 	auto Save() -> void;
 
+	/**
+	 * @brief Checks whether the file was modified and applies its changed values.
+	 *
+	 * The file's modification time is checked at an interval, so this may be called every frame.
+	 * The values are overwritten in place, so references from @ref Get and @ref ConfigValue stay valid, and the handles of changed values are notified.
+	 * Values added to the file or changed to another type are ignored until the next start.
+	 */
+	auto Update() -> void;
+
 	/**
 	 * @brief Retrieves a value from the config file.
-	 * 
+	 *
 	 * @tparam T The type of the value. Only support 'int64_t', 'double' 'bool' and 'std::string'.
-	 * 
+	 *
 	 * @param table The table of the value.
 	 * @param key The key of the value.
-	 * 
+	 *
 	 * @return A reference to the value.
 	 */
 	template<typename T>
@@ -34,4 +48,97 @@ namespace Config
 			std::is_same<T, bool>,
 			std::is_same<T, std::string>>)
 	auto Get(std::string_view table, std::string_view key) -> T&;
+
+	/**
+	 * @brief Registers a callback called whenever a value changes, used by @ref ConfigValue.
+	 *
+	 * @param subscriber Identifies the subscription to remove it.
+	 * @param value The value returned by @ref Get.
+	 * @param callback The callback.
+	 */
+	auto Subscribe(const void* subscriber, const void* value, std::function<void()> callback) -> void;
+
+	/**
+	 * @brief Removes the callbacks of a subscriber.
+	 *
+	 * @param subscriber The subscriber passed to @ref Subscribe.
+	 */
+	auto Unsubscribe(const void* subscriber) -> void;
+
+	/**
+	 * @brief Calls the callbacks subscribed to a value.
+	 *
+	 * @param value The value returned by @ref Get.
+	 */
+	auto NotifyChanged(const void* value) -> void;
 }
+
+/**
+ * @brief A typed handle to a value of the config file.
+ *
+ * The value is looked up once, reading it is a pointer load.
+ * Changes made through any handle of the value or to the file are announced through @ref OnChanged.
+ *
+ * @tparam T The type of the value, see @ref Config::Get.
+ */
+template<typename T>
+class ConfigValue
+{
+public:
+	/**
+	 * @brief Looks up the value.
+	 *
+	 * @param table The table of the value.
+	 * @param key The key of the value.
+	 */
+	ConfigValue(std::string_view table, std::string_view key)
+		: m_value(&Config::Get<T>(table, key))
+	{
+		Config::Subscribe(this, m_value, [this] () -> void
+			{
+				OnChanged(*m_value);
+			});
+	}
+
+	ConfigValue(const ConfigValue&) = delete;
+	auto operator=(const ConfigValue&) -> ConfigValue& = delete;
+
+	~ConfigValue()
+	{
+		Config::Unsubscribe(this);
+	}
+
+	/**
+	 * @brief Retrieves the value.
+	 *
+	 * @return The value.
+	 */
+	[[nodiscard]] auto Get() const noexcept -> const T&
+	{
+		return *m_value;
+	}
+
+	/**
+	 * @brief Overwrites the value and notifies every handle of it, if it changed.
+	 *
+	 * @param value The new value.
+	 */
+	auto Set(const T& value) -> void
+	{
+		if(*m_value == value)
+		{
+			return;
+		}
+
+		*m_value = value;
+		Config::NotifyChanged(m_value);
+	}
+
+	/**
+	 * @brief Called with the new value after it changed.
+	 */
+	Action<T> OnChanged;
+
+private:
+	T* m_value;
+};
@@ -0,0 +1,79 @@
+#include "Frustum.h"
+
+#include <limits>
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+	// Gribb-Hartmann extraction, a point is inside if 'dot(plane.xyz, point) + plane.w >= 0' for every plane
+	glm::mat4 transposed = glm::transpose(viewProjection);
+
+	m_planes = {
+		transposed[3] + transposed[0],
+		transposed[3] - transposed[0],
+		transposed[3] + transposed[1],
+		transposed[3] - transposed[1],
+		transposed[3] + transposed[2],
+		transposed[3] - transposed[2],
+	};
+
+	for(glm::vec4& plane : m_planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+auto Frustum::Intersects(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const noexcept -> bool
+{
+	for(const glm::vec4& plane : m_planes)
+	{
+		// The corner furthest along the plane's normal
+		glm::vec3 corner = glm::mix(boundsMin, boundsMax, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+
+		if(glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+auto ProjectBox(
+	const glm::mat4& viewProjection,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	const glm::uvec2& screenSize) -> ScreenRect
+{
+	glm::ivec2 size = glm::ivec2(screenSize);
+
+	glm::vec2 ndcMin = glm::vec2(std::numeric_limits<float>::max());
+	glm::vec2 ndcMax = glm::vec2(std::numeric_limits<float>::lowest());
+
+	for(uint32_t i = 0u; i < 8u; ++i)
+	{
+		glm::vec3 corner = glm::mix(boundsMin, boundsMax, glm::bvec3(i & 1u, (i >> 1u) & 1u, (i >> 2u) & 1u));
+		glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+
+		// Corners behind the camera project to the wrong side, clipping the box isn't worth it
+		if(clip.w <= std::numeric_limits<float>::epsilon())
+		{
+			return ScreenRect{
+				.Min = glm::ivec2(0),
+				.Max = size,
+			};
+		}
+
+		glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		ndcMin = glm::min(ndcMin, ndc);
+		ndcMax = glm::max(ndcMax, ndc);
+	}
+
+	glm::vec2 pixelMin = (ndcMin * 0.5f + 0.5f) * glm::vec2(size);
+	glm::vec2 pixelMax = (ndcMax * 0.5f + 0.5f) * glm::vec2(size);
+
+	// The rays start at the corners of the pixels, so the pixel after the edge may still touch the box
+	return ScreenRect{
+		.Min = glm::clamp(glm::ivec2(glm::floor(pixelMin)), glm::ivec2(0), size),
+		.Max = glm::clamp(glm::ivec2(glm::floor(pixelMax)) + 1, glm::ivec2(0), size),
+	};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief A range of pixels on the screen.
+ */
+struct ScreenRect
+{
+	/**
+	 * @brief The first pixel of the rectangle.
+	 */
+	glm::ivec2 Min;
+
+	/**
+	 * @brief The pixel after the last one of the rectangle.
+	 */
+	glm::ivec2 Max;
+
+	/**
+	 * @brief Checks whether the rectangle covers no pixels.
+	 *
+	 * @return 'true' if the rectangle is empty, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsEmpty() const noexcept -> bool
+	{
+		return Max.x <= Min.x || Max.y <= Min.y;
+	}
+
+	/**
+	 * @brief Extends the rectangle to cover another one.
+	 *
+	 * @param other The other rectangle, ignored if it is empty.
+	 */
+	auto Merge(const ScreenRect& other) noexcept -> void
+	{
+		if(other.IsEmpty())
+		{
+			return;
+		}
+
+		if(IsEmpty())
+		{
+			*this = other;
+
+			return;
+		}
+
+		Min = glm::min(Min, other.Min);
+		Max = glm::max(Max, other.Max);
+	}
+};
+
+/**
+ * @brief The volume visible from a camera, bounded by 6 planes.
+ */
+class Frustum
+{
+public:
+	/**
+	 * @brief Extracts the planes of a projection.
+	 *
+	 * @param viewProjection The projection matrix multiplied by the view matrix.
+	 */
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	/**
+	 * @brief Checks whether an axis aligned box may be visible.
+	 *
+	 * Conservative, boxes near the corners of the frustum may pass even though they are outside.
+	 *
+	 * @param boundsMin The minimum corner of the box.
+	 * @param boundsMax The maximum corner of the box.
+	 *
+	 * @return 'false' if the box is entirely outside, otherwise 'true'.
+	 */
+	[[nodiscard]] auto Intersects(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const noexcept -> bool;
+
+private:
+	/**
+	 * @brief The planes facing inwards. xyz -> normal, w -> distance from the origin.
+	 */
+	std::array<glm::vec4, 6u> m_planes;
+};
+
+/**
+ * @brief Calculates the pixels an axis aligned box covers on the screen.
+ *
+ * Conservative, a box crossing the near plane covers the whole screen.
+ *
+ * @param viewProjection The projection matrix multiplied by the view matrix.
+ * @param boundsMin The minimum corner of the box.
+ * @param boundsMax The maximum corner of the box.
+ * @param screenSize The size of the screen in pixels.
+ *
+ * @return The covered pixels clamped to the screen, empty if the box is behind the camera or off-screen.
+ */
+[[nodiscard]] auto ProjectBox(
+	const glm::mat4& viewProjection,
+	const glm::vec3& boundsMin,
+	const glm::vec3& boundsMax,
+	const glm::uvec2& screenSize) -> ScreenRect;
@@ -1,23 +1,193 @@
 #include "IO.h"
 
-#include <fstream>
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
-auto LoadTextFile(const std::filesystem::path& path) -> std::string
+#include <algorithm>
+
+namespace
 {
-	std::string text;
+	/**
+	 * @brief The stride of the reads that pull a mapped file into memory, the smallest page size of the supported platforms.
+	 */
+	constexpr size_t PageSize = 4096u;
+}
 
-	if(std::ifstream file(path); file.good())
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
 	{
-		file.seekg(0, std::ios::end);
+		return;
+	}
 
-		if(std::streampos size = file.tellg(); size != -1)
+	LARGE_INTEGER size{};
+	bool hasSize = GetFileSizeEx(file, &size) != FALSE;
+	if(hasSize && size.QuadPart > 0)
+	{
+		// The view keeps the mapping alive, neither handle is needed afterwards
+		if(HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr); mapping != nullptr)
 		{
-			file.seekg(0, std::ios::beg);
+			m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
 
-			text.resize(static_cast<size_t>(size));
-			file.read(text.data(), static_cast<std::streamsize>(size));
+		m_size = (m_data != nullptr) ? static_cast<size_t>(size.QuadPart) : 0u;
+		m_isOpen = m_data != nullptr;
+	}
+	else
+	{
+		m_isOpen = hasSize;
+	}
+
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if(file < 0)
+	{
+		return;
+	}
+
+	struct stat status{};
+	bool hasStatus = fstat(file, &status) == 0;
+	if(hasStatus && status.st_size > 0)
+	{
+		// The mapping stays valid after the descriptor is closed
+		if(void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0); data != MAP_FAILED)
+		{
+			m_data = static_cast<const uint8_t*>(data);
+			m_size = static_cast<size_t>(status.st_size);
+			m_isOpen = true;
 		}
 	}
+	else
+	{
+		// Empty files can't be mapped, they are open without data
+		m_isOpen = hasStatus;
+	}
+
+	close(file);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	if(m_data == nullptr)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0u)), m_isOpen(std::exchange(other.m_isOpen, false))
+{
+
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+	std::swap(m_data, other.m_data);
+	std::swap(m_size, other.m_size);
+	std::swap(m_isOpen, other.m_isOpen);
+
+	return *this;
+}
+
+auto MappedFile::Prefetch() const noexcept -> void
+{
+	// One byte per page faults the whole file in, the volatile sum keeps the reads from being optimized away
+	volatile uint8_t sum = 0u;
+	for(size_t offset = 0u; offset < m_size; offset += PageSize)
+	{
+		sum = static_cast<uint8_t>(sum + m_data[offset]);
+	}
+}
+
+FileRead::FileRead(const std::filesystem::path& path, JobPriority priority)
+	: m_file(std::make_shared<MappedFile>())
+{
+	m_job = JobSystem::Schedule(
+		[file = m_file, path] () -> void
+		{
+			*file = MappedFile(path);
+			file->Prefetch();
+		},
+		priority);
+}
+
+auto FileRead::IsFinished() const noexcept -> bool
+{
+	return !m_job || m_job.IsFinished();
+}
+
+auto FileRead::Get() const -> const MappedFile&
+{
+	static const MappedFile s_notRead;
+	if(m_file == nullptr)
+	{
+		return s_notRead;
+	}
+
+	if(!m_job.IsFinished())
+	{
+		JobSystem::Wait(m_job);
+	}
+
+	return *m_file;
+}
+
+FileBatch::FileBatch(std::span<const std::filesystem::path> paths, JobPriority priority)
+{
+	m_reads.reserve(paths.size());
+	for(const std::filesystem::path& path : paths)
+	{
+		m_reads.emplace_back(path.lexically_normal(), FileRead(path, priority));
+	}
+}
+
+auto FileBatch::IsFinished() const noexcept -> bool
+{
+	return std::ranges::all_of(m_reads, [] (const std::pair<std::filesystem::path, FileRead>& read) -> bool
+		{
+			return read.second.IsFinished();
+		});
+}
+
+auto FileBatch::Find(const std::filesystem::path& path) const -> const MappedFile*
+{
+	auto it = std::ranges::find(m_reads, path.lexically_normal(), &std::pair<std::filesystem::path, FileRead>::first);
+	if(it == m_reads.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second.Get();
+}
+
+auto LoadTextFile(const std::filesystem::path& path) -> std::string
+{
+	return std::string(MappedFile(path).GetText());
+}
+
+auto LoadBinaryFile(const std::filesystem::path& path) -> std::vector<uint8_t>
+{
+	MappedFile file(path);
+	std::span<const uint8_t> data = file.GetData();
 
-	return text;
+	return std::vector<uint8_t>(data.begin(), data.end());
 }
@@ -1,7 +1,157 @@
 #pragma once
 
+#include "JobSystem.h"
+
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A read-only view of a file mapped into memory.
+ *
+ * The data is read from the disk as it is accessed, nothing is copied into the process.
+ */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+
+	/**
+	 * @brief Maps a file.
+	 *
+	 * @param path The path of the file.
+	 */
+	explicit MappedFile(const std::filesystem::path& path);
+
+	/**
+	 * @brief Unmaps the file.
+	 */
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+	auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+	/**
+	 * @brief Checks whether the file could be opened.
+	 *
+	 * @return 'true' if the file was mapped or is empty, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsOpen() const noexcept -> bool
+	{
+		return m_isOpen;
+	}
+
+	/**
+	 * @brief Retrieves the bytes of the file.
+	 *
+	 * @return The bytes, valid as long as the file is mapped.
+	 */
+	[[nodiscard]] auto GetData() const noexcept -> std::span<const uint8_t>
+	{
+		return std::span<const uint8_t>(m_data, m_size);
+	}
+
+	/**
+	 * @brief Retrieves the file as text.
+	 *
+	 * @return The text, valid as long as the file is mapped.
+	 */
+	[[nodiscard]] auto GetText() const noexcept -> std::string_view
+	{
+		return std::string_view(reinterpret_cast<const char*>(m_data), m_size);
+	}
+
+	/**
+	 * @brief Reads every page of the file, so accessing it later doesn't wait for the disk.
+	 */
+	auto Prefetch() const noexcept -> void;
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0u;
+	bool m_isOpen = false;
+};
+
+/**
+ * @brief A file mapped and read by a job.
+ *
+ * Copies refer to the same read.
+ */
+class FileRead
+{
+public:
+	FileRead() = default;
+
+	/**
+	 * @brief Schedules the read.
+	 *
+	 * @param path The path of the file.
+	 * @param priority The priority of the job.
+	 */
+	explicit FileRead(const std::filesystem::path& path, JobPriority priority = JobPriority::Normal);
+
+	/**
+	 * @brief Retrieves whether the file was read.
+	 *
+	 * @return 'true' if the file can be retrieved without waiting, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsFinished() const noexcept -> bool;
+
+	/**
+	 * @brief Retrieves the file, waiting for the read if it is still running.
+	 *
+	 * @return The file, not open if it couldn't be read or the read wasn't scheduled.
+	 */
+	[[nodiscard]] auto Get() const -> const MappedFile&;
+
+private:
+	JobHandle m_job;
+	std::shared_ptr<MappedFile> m_file;
+};
+
+/**
+ * @brief Files read in parallel, one job each.
+ */
+class FileBatch
+{
+public:
+	FileBatch() = default;
+
+	/**
+	 * @brief Schedules the reads.
+	 *
+	 * @param paths The paths of the files.
+	 * @param priority The priority of the jobs.
+	 */
+	explicit FileBatch(std::span<const std::filesystem::path> paths, JobPriority priority = JobPriority::Normal);
+
+	/**
+	 * @brief Retrieves whether every file was read.
+	 *
+	 * @return 'true' if none of the files has to be waited for, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsFinished() const noexcept -> bool;
+
+	/**
+	 * @brief Retrieves a file of the batch, waiting for its read if it is still running.
+	 *
+	 * @param path The path of the file, compared after normalizing it.
+	 *
+	 * @return A pointer to the file, 'nullptr' if it isn't part of the batch.
+	 */
+	[[nodiscard]] auto Find(const std::filesystem::path& path) const -> const MappedFile*;
+
+private:
+	std::vector<std::pair<std::filesystem::path, FileRead>> m_reads;
+};
 
 /**
  * @brief Loads a text file.
@@ -11,3 +161,12 @@
  * @return A string containing the text.
  */
 [[nodiscard]] auto LoadTextFile(const std::filesystem::path& path) -> std::string;
+
+/**
+ * @brief Loads a binary file.
+ *
+ * @param path The path of the file.
+ *
+ * @return The bytes of the file, empty if it couldn't be read.
+ */
+[[nodiscard]] auto LoadBinaryFile(const std::filesystem::path& path) -> std::vector<uint8_t>;
@@ -0,0 +1,208 @@
+#include "Image.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+
+namespace
+{
+	/**
+	 * @brief The largest block of deflate data stored without compression.
+	 */
+	constexpr size_t MaxStoredBlockSize = 65535u;
+
+	[[nodiscard]] constexpr auto CreateCrcTable() noexcept -> std::array<uint32_t, 256u>
+	{
+		std::array<uint32_t, 256u> table{};
+		for(uint32_t i = 0u; i < 256u; ++i)
+		{
+			uint32_t crc = i;
+			for(uint32_t bit = 0u; bit < 8u; ++bit)
+			{
+				crc = (crc & 1u) ? (0xEDB88320u ^ (crc >> 1u)) : (crc >> 1u);
+			}
+
+			table[i] = crc;
+		}
+
+		return table;
+	}
+
+	constexpr std::array<uint32_t, 256u> CrcTable = CreateCrcTable();
+
+	[[nodiscard]] auto GetCrc(std::span<const uint8_t> data) noexcept -> uint32_t
+	{
+		uint32_t crc = 0xFFFFFFFFu;
+		for(uint8_t byte : data)
+		{
+			crc = CrcTable[(crc ^ byte) & 0xFFu] ^ (crc >> 8u);
+		}
+
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	[[nodiscard]] auto GetAdler32(std::span<const uint8_t> data) noexcept -> uint32_t
+	{
+		uint32_t a = 1u;
+		uint32_t b = 0u;
+		for(uint8_t byte : data)
+		{
+			a = (a + byte) % 65521u;
+			b = (b + a) % 65521u;
+		}
+
+		return (b << 16u) | a;
+	}
+
+	auto WriteBigEndian(std::vector<uint8_t>& output, uint32_t value) -> void
+	{
+		output.push_back(static_cast<uint8_t>(value >> 24u));
+		output.push_back(static_cast<uint8_t>(value >> 16u));
+		output.push_back(static_cast<uint8_t>(value >> 8u));
+		output.push_back(static_cast<uint8_t>(value));
+	}
+
+	/**
+	 * @brief Appends a PNG chunk, its length, type, data and checksum.
+	 *
+	 * @param output The file's data.
+	 * @param type The four letter type of the chunk.
+	 * @param data The data of the chunk.
+	 */
+	auto WriteChunk(std::vector<uint8_t>& output, std::string_view type, std::span<const uint8_t> data) -> void
+	{
+		WriteBigEndian(output, static_cast<uint32_t>(data.size()));
+
+		size_t typeStart = output.size();
+		output.insert(output.end(), type.begin(), type.end());
+		output.insert(output.end(), data.begin(), data.end());
+
+		// The checksum covers the type and the data
+		WriteBigEndian(output, GetCrc(std::span<const uint8_t>(output).subspan(typeStart)));
+	}
+}
+
+auto LoadPngFile(const std::filesystem::path& path) -> Image
+{
+	int32_t width = 0;
+	int32_t height = 0;
+	int32_t channels = 0;
+	uint8_t* data = stbi_load(path.string().c_str(), &width, &height, &channels, 3);
+	if(data == nullptr)
+	{
+		return Image{
+			.Size = glm::uvec2(0u),
+			.Pixels = {},
+		};
+	}
+
+	Image image{
+		.Size = glm::uvec2(static_cast<uint32_t>(width), static_cast<uint32_t>(height)),
+		.Pixels = std::vector<uint8_t>(data, data + static_cast<size_t>(width) * static_cast<size_t>(height) * 3u),
+	};
+
+	stbi_image_free(data);
+
+	return image;
+}
+
+auto SavePngFile(const std::filesystem::path& path, const Image& image) -> bool
+{
+	size_t rowSize = static_cast<size_t>(image.Size.x) * 3u;
+
+	// Every row starts with its filter type, 0 for none
+	std::vector<uint8_t> rows;
+	rows.reserve((rowSize + 1u) * image.Size.y);
+	for(uint32_t y = 0u; y < image.Size.y; ++y)
+	{
+		rows.push_back(0u);
+		rows.insert(rows.end(), image.Pixels.begin() + static_cast<ptrdiff_t>(y * rowSize), image.Pixels.begin() + static_cast<ptrdiff_t>((y + 1u) * rowSize));
+	}
+
+	// A zlib stream of stored deflate blocks
+	std::vector<uint8_t> stream = { 0x78u, 0x01u };
+	for(size_t offset = 0u; offset < rows.size() || offset == 0u; offset += MaxStoredBlockSize)
+	{
+		size_t blockSize = std::min(rows.size() - offset, MaxStoredBlockSize);
+		bool isLast = offset + blockSize == rows.size();
+
+		stream.push_back(isLast ? 1u : 0u);
+		stream.push_back(static_cast<uint8_t>(blockSize));
+		stream.push_back(static_cast<uint8_t>(blockSize >> 8u));
+		stream.push_back(static_cast<uint8_t>(~blockSize));
+		stream.push_back(static_cast<uint8_t>(~blockSize >> 8u));
+		stream.insert(stream.end(), rows.begin() + static_cast<ptrdiff_t>(offset), rows.begin() + static_cast<ptrdiff_t>(offset + blockSize));
+
+		if(isLast)
+		{
+			break;
+		}
+	}
+
+	WriteBigEndian(stream, GetAdler32(rows));
+
+	std::vector<uint8_t> header;
+	WriteBigEndian(header, image.Size.x);
+	WriteBigEndian(header, image.Size.y);
+
+	// 8 bits per channel, RGB, deflate, adaptive filtering, not interlaced
+	header.insert(header.end(), { 8u, 2u, 0u, 0u, 0u });
+
+	std::vector<uint8_t> file = { 0x89u, 'P', 'N', 'G', '\r', '\n', 0x1Au, '\n' };
+	WriteChunk(file, "IHDR", header);
+	WriteChunk(file, "IDAT", stream);
+	WriteChunk(file, "IEND", {});
+
+	std::ofstream output(path, std::ios::binary);
+	if(!output.good())
+	{
+		return false;
+	}
+
+	output.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+
+	return output.good();
+}
+
+auto CompareImages(const Image& image, const Image& reference, uint32_t tolerance) -> ImageDifference
+{
+	ImageDifference difference{
+		.MaxError = 0u,
+		.MeanError = 0.0f,
+		.DifferingPixelCount = 0u,
+		.Mask = Image{
+			.Size = image.Size,
+			.Pixels = std::vector<uint8_t>(image.Pixels.size(), 0u),
+		},
+	};
+
+	uint64_t errorSum = 0u;
+	for(size_t pixel = 0u; pixel * 3u < image.Pixels.size(); ++pixel)
+	{
+		uint32_t pixelError = 0u;
+		for(size_t channel = pixel * 3u; channel < pixel * 3u + 3u; ++channel)
+		{
+			uint32_t error = static_cast<uint32_t>(std::abs(static_cast<int32_t>(image.Pixels[channel]) - static_cast<int32_t>(reference.Pixels[channel])));
+
+			pixelError = std::max(pixelError, error);
+			errorSum += error;
+		}
+
+		difference.MaxError = std::max(difference.MaxError, pixelError);
+
+		if(pixelError > tolerance)
+		{
+			++difference.DifferingPixelCount;
+
+			difference.Mask.Pixels[pixel * 3u] = static_cast<uint8_t>(std::min(pixelError * 4u, 255u));
+		}
+	}
+
+	difference.MeanError = image.Pixels.empty() ? 0.0f : static_cast<float>(static_cast<double>(errorSum) / static_cast<double>(image.Pixels.size()));
+
+	return difference;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+/**
+ * @brief An 8 bit RGB image, rows from top to bottom.
+ */
+struct Image
+{
+	glm::uvec2 Size;
+	std::vector<uint8_t> Pixels;
+};
+
+/**
+ * @brief The per channel difference of two images.
+ */
+struct ImageDifference
+{
+	/**
+	 * @brief The largest difference of a channel.
+	 */
+	uint32_t MaxError;
+
+	/**
+	 * @brief The average difference of the channels.
+	 */
+	float MeanError;
+
+	/**
+	 * @brief The number of pixels with a channel differing by more than the tolerance.
+	 */
+	size_t DifferingPixelCount;
+
+	/**
+	 * @brief A black image with the differing pixels in red, scaled by their largest difference.
+	 */
+	Image Mask;
+};
+
+/**
+ * @brief Loads a PNG file.
+ *
+ * @param path The path of the file.
+ *
+ * @return The image converted to RGB, with no pixels if it couldn't be read.
+ */
+[[nodiscard]] auto LoadPngFile(const std::filesystem::path& path) -> Image;
+
+/**
+ * @brief Writes an image as a PNG file.
+ *
+ * The image data is stored without compression, no deflate implementation is available to the project.
+ *
+ * @param path The path of the file.
+ * @param image The image.
+ *
+ * @return 'true' if the file was written, otherwise 'false'.
+ */
+auto SavePngFile(const std::filesystem::path& path, const Image& image) -> bool;
+
+/**
+ * @brief Compares two images of the same size.
+ *
+ * @param image The image.
+ * @param reference The image it is compared to.
+ * @param tolerance The largest difference of a channel not counted as a differing pixel.
+ *
+ * @return The difference of the images.
+ */
+[[nodiscard]] auto CompareImages(const Image& image, const Image& reference, uint32_t tolerance) -> ImageDifference;
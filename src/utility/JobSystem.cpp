@@ -0,0 +1,326 @@
+#include "JobSystem.h"
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace JobSystem::Detail
+{
+	struct Job
+	{
+		std::function<void()> Function;
+		JobPriority Priority;
+		CancellationToken Token;
+
+		std::atomic<bool> IsFinished = false;
+		std::mutex Mutex;
+		std::condition_variable Finished;
+		std::vector<std::shared_ptr<Job>> Continuations;
+	};
+}
+
+namespace
+{
+	using Job = JobSystem::Detail::Job;
+
+	constexpr size_t PriorityCount = 3u;
+	constexpr size_t NoWorker = ~0u;
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::array<std::deque<std::shared_ptr<Job>>, PriorityCount> Jobs;
+	};
+
+	std::vector<std::thread> s_workers;
+	std::vector<std::unique_ptr<WorkerQueue>> s_queues;
+
+	std::atomic<bool> s_isRunning = false;
+	std::atomic<size_t> s_pendingCount = 0u;
+	std::atomic<size_t> s_nextQueue = 0u;
+
+	std::mutex s_sleepMutex;
+	std::condition_variable s_wakeUp;
+
+	thread_local size_t t_workerIndex = NoWorker;
+
+	auto Push(std::shared_ptr<Job> job) -> void
+	{
+		// Workers push to their own queue, other threads distribute the jobs evenly.
+		size_t queueIndex = (t_workerIndex != NoWorker)
+			? t_workerIndex
+			: s_nextQueue.fetch_add(1u, std::memory_order_relaxed) % s_queues.size();
+
+		WorkerQueue& queue = *s_queues[queueIndex];
+		{
+			std::scoped_lock lock(queue.Mutex);
+
+			// Counted under the queue's mutex before the job is published, so it can't be popped and uncounted first
+			s_pendingCount.fetch_add(1u, std::memory_order_release);
+			queue.Jobs[static_cast<size_t>(job->Priority)].push_back(std::move(job));
+		}
+
+		// A worker that saw no pending jobs holds the sleep mutex until it waits, so it can't miss the notification
+		{
+			std::scoped_lock lock(s_sleepMutex);
+		}
+		s_wakeUp.notify_one();
+	}
+
+	auto TryPop() -> std::shared_ptr<Job>
+	{
+		if(s_pendingCount.load(std::memory_order_acquire) == 0u)
+		{
+			return nullptr;
+		}
+
+		size_t queueCount = s_queues.size();
+		size_t ownIndex = (t_workerIndex != NoWorker) ? t_workerIndex : 0u;
+
+		for(size_t priority = 0u; priority < PriorityCount; ++priority)
+		{
+			// Take the newest job of the own queue, it is the most likely to be in the cache.
+			if(t_workerIndex != NoWorker)
+			{
+				WorkerQueue& queue = *s_queues[ownIndex];
+				std::scoped_lock lock(queue.Mutex);
+
+				if(auto& jobs = queue.Jobs[priority]; !jobs.empty())
+				{
+					std::shared_ptr<Job> job = std::move(jobs.back());
+					jobs.pop_back();
+
+					s_pendingCount.fetch_sub(1u, std::memory_order_relaxed);
+					return job;
+				}
+			}
+
+			// Steal the oldest job of the others.
+			for(size_t i = 0u; i < queueCount; ++i)
+			{
+				size_t victimIndex = (ownIndex + i + 1u) % queueCount;
+				if(victimIndex == t_workerIndex)
+				{
+					continue;
+				}
+
+				WorkerQueue& queue = *s_queues[victimIndex];
+				std::scoped_lock lock(queue.Mutex);
+
+				if(auto& jobs = queue.Jobs[priority]; !jobs.empty())
+				{
+					std::shared_ptr<Job> job = std::move(jobs.front());
+					jobs.pop_front();
+
+					s_pendingCount.fetch_sub(1u, std::memory_order_relaxed);
+					return job;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	auto Finish(Job& job) -> void
+	{
+		std::vector<std::shared_ptr<Job>> continuations;
+		{
+			std::scoped_lock lock(job.Mutex);
+
+			job.IsFinished.store(true, std::memory_order_release);
+			continuations = std::move(job.Continuations);
+		}
+		job.Finished.notify_all();
+
+		for(auto& continuation : continuations)
+		{
+			Push(std::move(continuation));
+		}
+	}
+
+	auto Execute(Job& job) -> void
+	{
+		if(!job.Token.IsCancelled())
+		{
+			PROFILE_SCOPE("Job");
+
+			job.Function();
+		}
+
+		// Release the captured state as soon as possible.
+		job.Function = nullptr;
+
+		Finish(job);
+	}
+
+	auto WorkerMain(size_t workerIndex) -> void
+	{
+		t_workerIndex = workerIndex;
+
+		PROFILE_THREAD_NAME("Worker " + std::to_string(workerIndex));
+
+		while(s_isRunning.load(std::memory_order_acquire))
+		{
+			if(std::shared_ptr<Job> job = TryPop())
+			{
+				Execute(*job);
+
+				continue;
+			}
+
+			std::unique_lock lock(s_sleepMutex);
+			s_wakeUp.wait(
+				lock,
+				[] () -> bool
+				{
+					return s_pendingCount.load(std::memory_order_acquire) != 0u || !s_isRunning.load(std::memory_order_acquire);
+				});
+		}
+	}
+
+	auto MakeJob(std::function<void()>&& function, JobPriority priority, const CancellationToken& token) -> std::shared_ptr<Job>
+	{
+		auto job = std::make_shared<Job>();
+		job->Function = std::move(function);
+		job->Priority = priority;
+		job->Token = token;
+
+		return job;
+	}
+}
+
+CancellationToken::CancellationToken()
+	: m_isCancelled(std::make_shared<std::atomic<bool>>(false))
+{}
+
+auto CancellationToken::Cancel() const noexcept -> void
+{
+	m_isCancelled->store(true, std::memory_order_relaxed);
+}
+
+auto CancellationToken::IsCancelled() const noexcept -> bool
+{
+	return m_isCancelled->load(std::memory_order_relaxed);
+}
+
+JobHandle::JobHandle(std::shared_ptr<JobSystem::Detail::Job> job) noexcept
+	: m_job(std::move(job))
+{}
+
+auto JobHandle::IsFinished() const noexcept -> bool
+{
+	return m_job == nullptr || m_job->IsFinished.load(std::memory_order_acquire);
+}
+
+auto JobSystem::Initialize(size_t workerCount) -> void
+{
+	if(workerCount == 0u)
+	{
+		workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+	}
+
+	s_isRunning = true;
+
+	for(size_t i = 0u; i < workerCount; ++i)
+	{
+		s_queues.emplace_back(std::make_unique<WorkerQueue>());
+	}
+
+	for(size_t i = 0u; i < workerCount; ++i)
+	{
+		s_workers.emplace_back(WorkerMain, i);
+	}
+}
+
+auto JobSystem::Shutdown() -> void
+{
+	{
+		std::scoped_lock lock(s_sleepMutex);
+
+		s_isRunning = false;
+	}
+	s_wakeUp.notify_all();
+
+	for(auto& worker : s_workers)
+	{
+		worker.join();
+	}
+	s_workers.clear();
+
+	// Nothing will run the remaining jobs, release their waiters.
+	while(std::shared_ptr<Job> job = TryPop())
+	{
+		job->Token.Cancel();
+
+		Execute(*job);
+	}
+
+	s_queues.clear();
+}
+
+auto JobSystem::GetWorkerCount() noexcept -> size_t
+{
+	return s_workers.size();
+}
+
+auto JobSystem::Schedule(std::function<void()> function, JobPriority priority, const CancellationToken& token) -> JobHandle
+{
+	std::shared_ptr<Job> job = MakeJob(std::move(function), priority, token);
+
+	Push(job);
+
+	return JobHandle(std::move(job));
+}
+
+auto JobSystem::Then(const JobHandle& parent, std::function<void()> function, JobPriority priority, const CancellationToken& token) -> JobHandle
+{
+	std::shared_ptr<Job> job = MakeJob(std::move(function), priority, token);
+
+	if(const auto& parentJob = parent.GetJob())
+	{
+		std::scoped_lock lock(parentJob->Mutex);
+
+		if(!parentJob->IsFinished.load(std::memory_order_acquire))
+		{
+			parentJob->Continuations.push_back(job);
+
+			return JobHandle(std::move(job));
+		}
+	}
+
+	Push(job);
+
+	return JobHandle(std::move(job));
+}
+
+auto JobSystem::Wait(const JobHandle& handle) -> void
+{
+	const auto& job = handle.GetJob();
+
+	while(!handle.IsFinished())
+	{
+		// Help out instead of idling.
+		if(std::shared_ptr<Job> other = TryPop())
+		{
+			Execute(*other);
+
+			continue;
+		}
+
+		std::unique_lock lock(job->Mutex);
+		job->Finished.wait_for(
+			lock,
+			std::chrono::milliseconds(1),
+			[&] () -> bool
+			{
+				return job->IsFinished.load(std::memory_order_acquire);
+			});
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief The priority of a job. Workers always pick the most important available job.
+ */
+enum class JobPriority : uint8_t
+{
+	High,
+	Normal,
+	Low,
+};
+
+/**
+ * @brief A shared flag used to cancel jobs that haven't started yet.
+ *
+ * Copies of a token share the same state.
+ */
+class CancellationToken
+{
+public:
+	/**
+	 * @brief Creates a new, not cancelled token.
+	 */
+	CancellationToken();
+
+	/**
+	 * @brief Cancels every job scheduled with this token that hasn't started yet.
+	 */
+	auto Cancel() const noexcept -> void;
+
+	/**
+	 * @brief Retrieves whether the token was cancelled.
+	 *
+	 * Long running jobs may poll it to stop early.
+	 *
+	 * @return 'true' if the token was cancelled, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsCancelled() const noexcept -> bool;
+
+private:
+	std::shared_ptr<std::atomic<bool>> m_isCancelled;
+};
+
+namespace JobSystem::Detail
+{
+	struct Job;
+}
+
+/**
+ * @brief A reference to a scheduled job.
+ */
+class JobHandle
+{
+public:
+	JobHandle() = default;
+
+	/**
+	 * @brief Wraps a job. Used by the job system.
+	 *
+	 * @param job The referenced job.
+	 */
+	explicit JobHandle(std::shared_ptr<JobSystem::Detail::Job> job) noexcept;
+
+	/**
+	 * @brief Retrieves whether the job has finished or was cancelled.
+	 *
+	 * @return 'true' if the job won't run anymore, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsFinished() const noexcept -> bool;
+
+	/**
+	 * @brief Retrieves the referenced job. Used by the job system.
+	 *
+	 * @return A pointer to the job.
+	 */
+	[[nodiscard]] auto GetJob() const noexcept -> const std::shared_ptr<JobSystem::Detail::Job>&
+	{
+		return m_job;
+	}
+
+	/**
+	 * @brief Retrieves whether the handle refers to a job.
+	 */
+	[[nodiscard]] explicit operator bool() const noexcept
+	{
+		return m_job != nullptr;
+	}
+
+private:
+	std::shared_ptr<JobSystem::Detail::Job> m_job;
+};
+
+/**
+ * @brief A work-stealing thread pool.
+ *
+ * Every worker owns a deque per priority, each worker's deques are guarded by one mutex, nothing is lock-free.
+ * Workers take their own newest jobs first and steal the oldest jobs of the others when they run out.
+ */
+namespace JobSystem
+{
+	/**
+	 * @brief Starts the worker threads.
+	 *
+	 * @param workerCount The number of workers. If it is 0, one worker is started for each hardware thread except the calling one.
+	 */
+	auto Initialize(size_t workerCount = 0u) -> void;
+
+	/**
+	 * @brief Stops the worker threads.
+	 *
+	 * Jobs that haven't started yet are dropped and marked as finished.
+	 */
+	auto Shutdown() -> void;
+
+	/**
+	 * @brief Retrieves the number of worker threads.
+	 *
+	 * @return The number of worker threads.
+	 */
+	[[nodiscard]] auto GetWorkerCount() noexcept -> size_t;
+
+	/**
+	 * @brief Schedules a job.
+	 *
+	 * @param function The work to do.
+	 * @param priority The priority of the job.
+	 * @param token The job is skipped if the token is cancelled before it starts.
+	 *
+	 * @return A handle to the scheduled job.
+	 */
+	auto Schedule(std::function<void()> function, JobPriority priority = JobPriority::Normal, const CancellationToken& token = CancellationToken()) -> JobHandle;
+
+	/**
+	 * @brief Schedules a job to run after another one finished.
+	 *
+	 * The continuation is scheduled even if the parent was cancelled, it has its own token.
+	 *
+	 * @param parent The job that has to finish first.
+	 * @param function The work to do.
+	 * @param priority The priority of the job.
+	 * @param token The job is skipped if the token is cancelled before it starts.
+	 *
+	 * @return A handle to the continuation.
+	 */
+	auto Then(const JobHandle& parent, std::function<void()> function, JobPriority priority = JobPriority::Normal, const CancellationToken& token = CancellationToken()) -> JobHandle;
+
+	/**
+	 * @brief Blocks until a job finishes.
+	 *
+	 * The calling thread executes other jobs while it waits.
+	 *
+	 * @param handle The awaited job.
+	 */
+	auto Wait(const JobHandle& handle) -> void;
+}
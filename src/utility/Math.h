@@ -1,5 +1,7 @@
 #pragma once
 
+#include <glm/glm.hpp>
+
 #include <bit>
 #include <cstdint>
 
@@ -61,3 +63,39 @@
 
 	return result;
 }
+
+/**
+ * @brief Intersects a ray with an axis aligned box.
+ *
+ * CPU port of 'RayBoxIntersection' in 'Raygen.comp'.
+ *
+ * @param rayOrigin The origin of the ray.
+ * @param rayDirection The direction of the ray.
+ * @param boundsMin The minimum corner of the box.
+ * @param boundsMax The maximum corner of the box.
+ *
+ * @return The distance to the nearest and furthest intersection. Both are -1 if the box is missed, the nearest is 0 if the origin is inside.
+ */
+[[nodiscard]] inline auto RayBoxIntersection(
+	const glm::vec3& rayOrigin, const glm::vec3& rayDirection,
+	const glm::vec3& boundsMin, const glm::vec3& boundsMax) noexcept -> glm::vec2
+{
+	glm::vec3 rayDirectionInverse = 1.0f / rayDirection;
+
+	glm::vec3 t0 = (boundsMin - rayOrigin) * rayDirectionInverse;
+	glm::vec3 t1 = (boundsMax - rayOrigin) * rayDirectionInverse;
+
+	glm::vec3 tMin = glm::min(t0, t1);
+	glm::vec3 tMax = glm::max(t0, t1);
+
+	float nearest = glm::max(glm::max(tMin.x, tMin.y), tMin.z);
+	float furthest = glm::min(glm::min(tMax.x, tMax.y), tMax.z);
+
+	// Box behind or doesn't intersect
+	if(furthest < 0.0f || nearest > furthest)
+	{
+		return glm::vec2(-1.0f);
+	}
+
+	return glm::vec2(glm::max(nearest, 0.0f), furthest);
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief An unbounded multi-producer single-consumer queue.
+ *
+ * Pushing never blocks, it takes one atomic exchange. Popping is only allowed from a single thread.
+ * A value becomes visible to the consumer once the producer finished linking it, so a producer preempted in the middle of @ref Push
+ * may briefly hide the values pushed after it.
+ *
+ * @tparam T The type of the values.
+ */
+template<typename T>
+class MpscQueue
+{
+public:
+	/**
+	 * @brief Creates an empty queue.
+	 */
+	MpscQueue()
+		: m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed))
+	{
+
+	}
+
+	MpscQueue(const MpscQueue&) = delete;
+	auto operator=(const MpscQueue&) -> MpscQueue& = delete;
+
+	/**
+	 * @brief Destroys the values that were never popped.
+	 *
+	 * No producer may push anymore.
+	 */
+	~MpscQueue()
+	{
+		while(TryPop().has_value())
+		{
+
+		}
+
+		delete m_tail;
+	}
+
+	/**
+	 * @brief Adds a value to the end of the queue. May be called from any thread.
+	 *
+	 * @param value The new value.
+	 */
+	auto Push(T value) -> void
+	{
+		Node* node = new Node();
+		node->Value.emplace(std::move(value));
+
+		Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+		previous->Next.store(node, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Removes the value at the front of the queue. May only be called from the consumer thread.
+	 *
+	 * @return The removed value or 'std::nullopt' if the queue is empty.
+	 */
+	[[nodiscard]] auto TryPop() -> std::optional<T>
+	{
+		// The tail is always a node whose value was already taken, its successor holds the front value.
+		Node* next = m_tail->Next.load(std::memory_order_acquire);
+		if(next == nullptr)
+		{
+			return std::nullopt;
+		}
+
+		std::optional<T> value = std::move(next->Value);
+		next->Value.reset();
+
+		delete m_tail;
+		m_tail = next;
+
+		return value;
+	}
+
+	/**
+	 * @brief Pops every value currently in the queue. May only be called from the consumer thread.
+	 *
+	 * @param function Called with each value in push order.
+	 *
+	 * @return The number of popped values.
+	 */
+	template<typename TFunction>
+	auto Drain(TFunction&& function) -> size_t
+	{
+		size_t count = 0u;
+		while(std::optional<T> value = TryPop())
+		{
+			function(std::move(*value));
+
+			++count;
+		}
+
+		return count;
+	}
+
+private:
+	/**
+	 * @brief A link of the queue.
+	 */
+	struct Node
+	{
+		std::atomic<Node*> Next = nullptr;
+		std::optional<T> Value;
+	};
+
+	/**
+	 * @brief The most recently pushed node, shared by the producers.
+	 */
+	alignas(64) std::atomic<Node*> m_head;
+
+	/**
+	 * @brief The node before the front value, owned by the consumer.
+	 */
+	alignas(64) Node* m_tail;
+};
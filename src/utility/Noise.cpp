@@ -0,0 +1,353 @@
+#include "Noise.h"
+
+#include <array>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define NOISE_HAS_AVX2_PATH 1
+
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define NOISE_TARGET_AVX2
+	#else
+		#include <cpuid.h>
+		#define NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+
+	#include <immintrin.h>
+#else
+	#define NOISE_HAS_AVX2_PATH 0
+#endif
+
+namespace
+{
+	// The constants and the order of the operations follow FastNoiseLite, every change breaks the bit exact match.
+	constexpr float Sqrt3 = 1.7320508075688772935274463415059f;
+	constexpr float F2 = 0.5f * (Sqrt3 - 1);
+	constexpr float G2 = (3 - Sqrt3) / 6;
+	constexpr float CornerFactorT = static_cast<float>(2 * (1 - 2 * G2) * (1 / G2 - 2));
+	constexpr float CornerFactorA = static_cast<float>(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+	constexpr float FarCornerOffset = 2 * G2 - 1;
+	constexpr float Normalization = 99.83685446303647f;
+
+	constexpr uint32_t PrimeX = 501125321u;
+	constexpr uint32_t PrimeY = 1136930381u;
+	constexpr uint32_t HashMultiplier = 0x27d4eb2du;
+
+	// 24 evenly spaced directions repeated to fill the table, followed by 8 diagonals.
+	constexpr std::array<float, 48> BaseGradients = {
+		0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+		0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+		0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+		-0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+		-0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+		-0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+	};
+
+	constexpr std::array<float, 16> DiagonalGradients = {
+		0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+		-0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+	};
+
+	constexpr auto MakeGradients() -> std::array<float, 256>
+	{
+		std::array<float, 256> gradients{};
+
+		for(size_t i = 0u; i < 240u; ++i)
+		{
+			gradients[i] = BaseGradients[i % BaseGradients.size()];
+		}
+
+		for(size_t i = 0u; i < DiagonalGradients.size(); ++i)
+		{
+			gradients[240u + i] = DiagonalGradients[i];
+		}
+
+		return gradients;
+	}
+
+	alignas(64) constexpr std::array<float, 256> Gradients = MakeGradients();
+
+	auto FastFloor(float f) noexcept -> int32_t
+	{
+		return (f >= 0) ? static_cast<int32_t>(f) : static_cast<int32_t>(f) - 1;
+	}
+
+	auto GradCoord(uint32_t seed, uint32_t xPrimed, uint32_t yPrimed, float xd, float yd) noexcept -> float
+	{
+		int32_t hash = static_cast<int32_t>((seed ^ xPrimed ^ yPrimed) * HashMultiplier);
+		hash ^= hash >> 15;
+		hash &= 127 << 1;
+
+		return xd * Gradients[hash] + yd * Gradients[hash | 1];
+	}
+
+	auto SingleSimplex(uint32_t seed, float x, float y) noexcept -> float
+	{
+		int32_t i = FastFloor(x);
+		int32_t j = FastFloor(y);
+		float xi = x - static_cast<float>(i);
+		float yi = y - static_cast<float>(j);
+
+		float t = (xi + yi) * G2;
+		float x0 = xi - t;
+		float y0 = yi - t;
+
+		uint32_t iPrimed = static_cast<uint32_t>(i) * PrimeX;
+		uint32_t jPrimed = static_cast<uint32_t>(j) * PrimeY;
+
+		float n0 = 0.0f;
+		float n1 = 0.0f;
+		float n2 = 0.0f;
+
+		float a = 0.5f - x0 * x0 - y0 * y0;
+		if(a > 0)
+		{
+			n0 = (a * a) * (a * a) * GradCoord(seed, iPrimed, jPrimed, x0, y0);
+		}
+
+		float c = CornerFactorT * t + (CornerFactorA + a);
+		if(c > 0)
+		{
+			float x2 = x0 + FarCornerOffset;
+			float y2 = y0 + FarCornerOffset;
+			n2 = (c * c) * (c * c) * GradCoord(seed, iPrimed + PrimeX, jPrimed + PrimeY, x2, y2);
+		}
+
+		if(y0 > x0)
+		{
+			float x1 = x0 + G2;
+			float y1 = y0 + (G2 - 1);
+			float b = 0.5f - x1 * x1 - y1 * y1;
+			if(b > 0)
+			{
+				n1 = (b * b) * (b * b) * GradCoord(seed, iPrimed, jPrimed + PrimeY, x1, y1);
+			}
+		}
+		else
+		{
+			float x1 = x0 + (G2 - 1);
+			float y1 = y0 + G2;
+			float b = 0.5f - x1 * x1 - y1 * y1;
+			if(b > 0)
+			{
+				n1 = (b * b) * (b * b) * GradCoord(seed, iPrimed + PrimeX, jPrimed, x1, y1);
+			}
+		}
+
+		return (n0 + n1 + n2) * Normalization;
+	}
+
+#if NOISE_HAS_AVX2_PATH
+	NOISE_TARGET_AVX2 auto GradCoordAvx2(__m256i seed, __m256i xPrimed, __m256i yPrimed, __m256 xd, __m256 yd) noexcept -> __m256
+	{
+		__m256i hash = _mm256_mullo_epi32(_mm256_xor_si256(_mm256_xor_si256(seed, xPrimed), yPrimed), _mm256_set1_epi32(static_cast<int32_t>(HashMultiplier)));
+		hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+		hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+
+		__m256 xg = _mm256_i32gather_ps(Gradients.data(), hash, 4);
+		__m256 yg = _mm256_i32gather_ps(Gradients.data(), _mm256_or_si256(hash, _mm256_set1_epi32(1)), 4);
+
+		return _mm256_add_ps(_mm256_mul_ps(xd, xg), _mm256_mul_ps(yd, yg));
+	}
+
+	NOISE_TARGET_AVX2 auto SingleSimplexAvx2(uint32_t seed, __m256 x, __m256 y) noexcept -> __m256
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256i primeX = _mm256_set1_epi32(static_cast<int32_t>(PrimeX));
+		const __m256i primeY = _mm256_set1_epi32(static_cast<int32_t>(PrimeY));
+		const __m256i seeds = _mm256_set1_epi32(static_cast<int32_t>(seed));
+
+		// Truncate, then step down where the value is negative.
+		__m256i i = _mm256_add_epi32(_mm256_cvttps_epi32(x), _mm256_castps_si256(_mm256_cmp_ps(x, zero, _CMP_LT_OQ)));
+		__m256i j = _mm256_add_epi32(_mm256_cvttps_epi32(y), _mm256_castps_si256(_mm256_cmp_ps(y, zero, _CMP_LT_OQ)));
+		__m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+		__m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+		__m256 t = _mm256_mul_ps(_mm256_add_ps(xi, yi), _mm256_set1_ps(G2));
+		__m256 x0 = _mm256_sub_ps(xi, t);
+		__m256 y0 = _mm256_sub_ps(yi, t);
+
+		i = _mm256_mullo_epi32(i, primeX);
+		j = _mm256_mullo_epi32(j, primeY);
+
+		__m256 a = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0));
+		__m256 n0 = _mm256_mul_ps(
+			_mm256_mul_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(a, a)),
+			GradCoordAvx2(seeds, i, j, x0, y0));
+		n0 = _mm256_and_ps(n0, _mm256_cmp_ps(a, zero, _CMP_GT_OQ));
+
+		__m256 c = _mm256_add_ps(
+			_mm256_mul_ps(_mm256_set1_ps(CornerFactorT), t),
+			_mm256_add_ps(_mm256_set1_ps(CornerFactorA), a));
+		__m256 x2 = _mm256_add_ps(x0, _mm256_set1_ps(FarCornerOffset));
+		__m256 y2 = _mm256_add_ps(y0, _mm256_set1_ps(FarCornerOffset));
+		__m256 n2 = _mm256_mul_ps(
+			_mm256_mul_ps(_mm256_mul_ps(c, c), _mm256_mul_ps(c, c)),
+			GradCoordAvx2(seeds, _mm256_add_epi32(i, primeX), _mm256_add_epi32(j, primeY), x2, y2));
+		n2 = _mm256_and_ps(n2, _mm256_cmp_ps(c, zero, _CMP_GT_OQ));
+
+		// The middle corner depends on which triangle of the skewed cell the point is in.
+		__m256 isUpper = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+		__m256i isUpperInt = _mm256_castps_si256(isUpper);
+		__m256 x1 = _mm256_add_ps(x0, _mm256_blendv_ps(_mm256_set1_ps(G2 - 1), _mm256_set1_ps(G2), isUpper));
+		__m256 y1 = _mm256_add_ps(y0, _mm256_blendv_ps(_mm256_set1_ps(G2), _mm256_set1_ps(G2 - 1), isUpper));
+		__m256i i1 = _mm256_add_epi32(i, _mm256_andnot_si256(isUpperInt, primeX));
+		__m256i j1 = _mm256_add_epi32(j, _mm256_and_si256(isUpperInt, primeY));
+
+		__m256 b = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1));
+		__m256 n1 = _mm256_mul_ps(
+			_mm256_mul_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(b, b)),
+			GradCoordAvx2(seeds, i1, j1, x1, y1));
+		n1 = _mm256_and_ps(n1, _mm256_cmp_ps(b, zero, _CMP_GT_OQ));
+
+		return _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), _mm256_set1_ps(Normalization));
+	}
+
+	auto IsAvx2Supported() noexcept -> bool
+	{
+	#if defined(_MSC_VER)
+		int32_t info[4];
+
+		__cpuid(info, 0);
+		if(info[0] < 7)
+		{
+			return false;
+		}
+
+		// The OS has to save the YMM registers too.
+		__cpuid(info, 1);
+		bool isOsSaving = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6u) == 0x6u;
+
+		__cpuidex(info, 7, 0);
+		return isOsSaving && (info[1] & (1 << 5)) != 0;
+	#else
+		return __builtin_cpu_supports("avx2");
+	#endif
+	}
+#endif
+}
+
+FractalNoise::FractalNoise(const FractalNoiseSettings& settings)
+	: m_settings(settings)
+{
+	float gain = (m_settings.Gain < 0) ? -m_settings.Gain : m_settings.Gain;
+	float amp = gain;
+	float ampFractal = 1.0f;
+	for(int32_t i = 1; i < m_settings.Octaves; ++i)
+	{
+		ampFractal += amp;
+		amp *= gain;
+	}
+
+	m_fractalBounding = 1 / ampFractal;
+}
+
+auto FractalNoise::GetNoise(float x, float y) const noexcept -> float
+{
+	float result;
+	GetNoiseScalar(&x, &y, &result, 1u);
+
+	return result;
+}
+
+auto FractalNoise::GetNoise(std::span<const float> xs, std::span<const float> ys, std::span<float> result) const noexcept -> void
+{
+	static const SimdLevel supportedLevel = GetSupportedSimdLevel();
+
+	GetNoise(xs, ys, result, supportedLevel);
+}
+
+auto FractalNoise::GetNoise(std::span<const float> xs, std::span<const float> ys, std::span<float> result, SimdLevel level) const noexcept -> void
+{
+	if(level == SimdLevel::Avx2 && GetSupportedSimdLevel() == SimdLevel::Avx2)
+	{
+		GetNoiseAvx2(xs.data(), ys.data(), result.data(), result.size());
+	}
+	else
+	{
+		GetNoiseScalar(xs.data(), ys.data(), result.data(), result.size());
+	}
+}
+
+auto FractalNoise::GetSupportedSimdLevel() noexcept -> SimdLevel
+{
+#if NOISE_HAS_AVX2_PATH
+	static const bool isAvx2Supported = IsAvx2Supported();
+
+	return isAvx2Supported ? SimdLevel::Avx2 : SimdLevel::Scalar;
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+auto FractalNoise::GetNoiseScalar(const float* xs, const float* ys, float* result, size_t count) const noexcept -> void
+{
+	for(size_t i = 0u; i < count; ++i)
+	{
+		float x = xs[i] * m_settings.Frequency;
+		float y = ys[i] * m_settings.Frequency;
+
+		// Skew into the simplex grid.
+		float t = (x + y) * F2;
+		x += t;
+		y += t;
+
+		uint32_t seed = static_cast<uint32_t>(m_settings.Seed);
+		float sum = 0.0f;
+		float amp = m_fractalBounding;
+
+		for(int32_t octave = 0; octave < m_settings.Octaves; ++octave)
+		{
+			sum += SingleSimplex(seed++, x, y) * amp;
+
+			x *= m_settings.Lacunarity;
+			y *= m_settings.Lacunarity;
+			amp *= m_settings.Gain;
+		}
+
+		result[i] = sum;
+	}
+}
+
+#if NOISE_HAS_AVX2_PATH
+NOISE_TARGET_AVX2 auto FractalNoise::GetNoiseAvx2(const float* xs, const float* ys, float* result, size_t count) const noexcept -> void
+{
+	const __m256 frequency = _mm256_set1_ps(m_settings.Frequency);
+	const __m256 lacunarity = _mm256_set1_ps(m_settings.Lacunarity);
+
+	size_t i = 0u;
+	for(; i + 8u <= count; i += 8u)
+	{
+		__m256 x = _mm256_mul_ps(_mm256_loadu_ps(xs + i), frequency);
+		__m256 y = _mm256_mul_ps(_mm256_loadu_ps(ys + i), frequency);
+
+		__m256 t = _mm256_mul_ps(_mm256_add_ps(x, y), _mm256_set1_ps(F2));
+		x = _mm256_add_ps(x, t);
+		y = _mm256_add_ps(y, t);
+
+		uint32_t seed = static_cast<uint32_t>(m_settings.Seed);
+		__m256 sum = _mm256_setzero_ps();
+		float amp = m_fractalBounding;
+
+		for(int32_t octave = 0; octave < m_settings.Octaves; ++octave)
+		{
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(SingleSimplexAvx2(seed++, x, y), _mm256_set1_ps(amp)));
+
+			x = _mm256_mul_ps(x, lacunarity);
+			y = _mm256_mul_ps(y, lacunarity);
+			amp *= m_settings.Gain;
+		}
+
+		_mm256_storeu_ps(result + i, sum);
+	}
+
+	GetNoiseScalar(xs + i, ys + i, result + i, count - i);
+}
+#else
+auto FractalNoise::GetNoiseAvx2(const float* xs, const float* ys, float* result, size_t count) const noexcept -> void
+{
+	GetNoiseScalar(xs, ys, result, count);
+}
+#endif
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief The instruction sets the noise can be evaluated with.
+ */
+enum class SimdLevel : uint8_t
+{
+	Scalar,
+	Avx2,
+};
+
+/**
+ * @brief Holds the parameters of a fractal noise.
+ */
+struct FractalNoiseSettings
+{
+	/**
+	 * @brief The seed of the first octave. Every further octave increments it.
+	 */
+	int32_t Seed;
+
+	/**
+	 * @brief The frequency of the first octave.
+	 */
+	float Frequency;
+
+	/**
+	 * @brief The number of summed octaves.
+	 */
+	int32_t Octaves;
+
+	/**
+	 * @brief The amplitude multiplier between two octaves.
+	 */
+	float Gain;
+
+	/**
+	 * @brief The frequency multiplier between two octaves.
+	 */
+	float Lacunarity;
+};
+
+/**
+ * @brief 2D OpenSimplex2 FBm noise evaluated in batches.
+ *
+ * Produces the same values as FastNoiseLite configured with the OpenSimplex2 noise and FBm fractal types.
+ * The scalar and the AVX2 implementation give bit identical results.
+ */
+class FractalNoise
+{
+public:
+	/**
+	 * @brief Sets the parameters of the noise.
+	 *
+	 * @param settings The parameters of the noise.
+	 */
+	FractalNoise(const FractalNoiseSettings& settings);
+
+	/**
+	 * @brief Evaluates the noise at a single point.
+	 *
+	 * @param x The X coordinate of the point.
+	 * @param y The Y coordinate of the point.
+	 *
+	 * @return The noise value in the [-1, 1] range.
+	 */
+	[[nodiscard]] auto GetNoise(float x, float y) const noexcept -> float;
+
+	/**
+	 * @brief Evaluates the noise at multiple points using the widest supported instruction set.
+	 *
+	 * @param xs The X coordinates of the points.
+	 * @param ys The Y coordinates of the points.
+	 * @param result The noise values, must be as long as the coordinate spans.
+	 */
+	auto GetNoise(std::span<const float> xs, std::span<const float> ys, std::span<float> result) const noexcept -> void;
+
+	/**
+	 * @brief Evaluates the noise at multiple points using a specific instruction set.
+	 *
+	 * Falls back to the scalar implementation if the instruction set isn't supported.
+	 *
+	 * @param xs The X coordinates of the points.
+	 * @param ys The Y coordinates of the points.
+	 * @param result The noise values, must be as long as the coordinate spans.
+	 * @param level The used instruction set.
+	 */
+	auto GetNoise(std::span<const float> xs, std::span<const float> ys, std::span<float> result, SimdLevel level) const noexcept -> void;
+
+	/**
+	 * @brief Retrieves the widest instruction set supported by the CPU.
+	 *
+	 * @return The widest supported instruction set.
+	 */
+	[[nodiscard]] static auto GetSupportedSimdLevel() noexcept -> SimdLevel;
+
+private:
+	FractalNoiseSettings m_settings;
+	float m_fractalBounding;
+
+	/**
+	 * @brief Evaluates the noise one point at a time.
+	 *
+	 * @param xs A pointer to the X coordinates.
+	 * @param ys A pointer to the Y coordinates.
+	 * @param result A pointer to the output values.
+	 * @param count The number of points.
+	 */
+	auto GetNoiseScalar(const float* xs, const float* ys, float* result, size_t count) const noexcept -> void;
+
+	/**
+	 * @brief Evaluates the noise eight points at a time.
+	 *
+	 * The remaining points are evaluated by @ref GetNoiseScalar.
+	 *
+	 * @param xs A pointer to the X coordinates.
+	 * @param ys A pointer to the Y coordinates.
+	 * @param result A pointer to the output values.
+	 * @param count The number of points.
+	 */
+	auto GetNoiseAvx2(const float* xs, const float* ys, float* result, size_t count) const noexcept -> void;
+};
@@ -4,8 +4,10 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <span>
+#include <utility>
 #include <vector>
 
 /**
@@ -24,10 +26,17 @@ public:
 	 */
 	static constexpr size_t Size = PowerConstexpr(2u, L);
 
+	/**
+	 * @brief The number of levels of the octree, the leaves not included.
+	 *
+	 * Equals to @ref L
+	 */
+	static constexpr size_t LevelCount = L;
+
 	/**
 	 * @brief Retrieves a value from the octree.
 	 *
-	 * Will return 0 if the value is not stored in the tree.
+	 * Will return 0 if the value is not stored in the tree or the uniform value if the tree is uniform.
 	 *
 	 * @param coordinate The coordinate of the value.
 	 *
@@ -37,7 +46,7 @@ public:
 	{
 		if(m_nodes.empty())
 		{
-			return 0u;
+			return m_uniformValue;
 		}
 
 		size_t headIndex = 0u;
@@ -97,7 +106,19 @@ public:
 
 		if(m_nodes.empty())
 		{
-			m_nodes.emplace_back(0u);
+			if(value == m_uniformValue)
+			{
+				return;
+			}
+
+			if(m_uniformValue != 0u)
+			{
+				Expand();
+			}
+			else
+			{
+				m_nodes.emplace_back(0u);
+			}
 		}
 
 		size_t headIndex = 0u;
@@ -142,9 +163,268 @@ public:
 		m_nodes[headIndex] = value;
 	}
 
+	/**
+	 * @brief Sets every value of the octree without storing any nodes.
+	 *
+	 * @param value The new value of the whole octree. 0 makes the octree empty.
+	 */
+	auto Fill(uint8_t value) -> void
+	{
+		m_nodes.clear();
+		m_uniformValue = value;
+	}
+
+	/**
+	 * @brief Replaces the content of the octree with a dense grid of values.
+	 *
+	 * Much faster than calling @ref Set for every value since the nodes are written in order without insertions.
+	 *
+	 * @param values The values indexed by '(z * Size + y) * Size + x'. Must contain Size^3 values.
+	 */
+	auto Build(std::span<const uint8_t> values) -> void
+	{
+		if(std::ranges::all_of(values, [&] (uint8_t value) -> bool { return value == values.front(); }))
+		{
+			Fill(values.front());
+
+			return;
+		}
+
+		// Collect the child masks of every level bottom up, level l has (2^l)^3 nodes.
+		std::vector<uint8_t> masks(s_innerNodeCount, 0u);
+
+		size_t levelOffset = s_innerNodeCount - PowerConstexpr(8u, L - 1u);
+		size_t levelSize = s_half;
+		for(size_t z = 0u; z < levelSize; ++z)
+		{
+			for(size_t y = 0u; y < levelSize; ++y)
+			{
+				for(size_t x = 0u; x < levelSize; ++x)
+				{
+					uint8_t mask = 0u;
+					for(uint8_t childIndex = 0u; childIndex < 8u; ++childIndex)
+					{
+						size_t childX = x * 2u + (childIndex & 1u);
+						size_t childY = y * 2u + ((childIndex >> 1u) & 1u);
+						size_t childZ = z * 2u + ((childIndex >> 2u) & 1u);
+
+						mask |= static_cast<uint8_t>((values[(childZ * Size + childY) * Size + childX] != 0u) << childIndex);
+					}
+
+					masks[levelOffset + (z * levelSize + y) * levelSize + x] = mask;
+				}
+			}
+		}
+
+		while(levelSize > 1u)
+		{
+			size_t childLevelOffset = levelOffset;
+			size_t childLevelSize = levelSize;
+
+			levelSize /= 2u;
+			levelOffset -= levelSize * levelSize * levelSize;
+
+			for(size_t z = 0u; z < levelSize; ++z)
+			{
+				for(size_t y = 0u; y < levelSize; ++y)
+				{
+					for(size_t x = 0u; x < levelSize; ++x)
+					{
+						uint8_t mask = 0u;
+						for(uint8_t childIndex = 0u; childIndex < 8u; ++childIndex)
+						{
+							size_t childX = x * 2u + (childIndex & 1u);
+							size_t childY = y * 2u + ((childIndex >> 1u) & 1u);
+							size_t childZ = z * 2u + ((childIndex >> 2u) & 1u);
+
+							mask |= static_cast<uint8_t>((masks[childLevelOffset + (childZ * childLevelSize + childY) * childLevelSize + childX] != 0u) << childIndex);
+						}
+
+						masks[levelOffset + (z * levelSize + y) * levelSize + x] = mask;
+					}
+				}
+			}
+		}
+
+		// Write the nodes level by level, the children of a level follow the order of their parents.
+		m_nodes.clear();
+		m_uniformValue = 0u;
+
+		std::vector<glm::uvec3> level = { glm::uvec3(0u) };
+		std::vector<glm::uvec3> nextLevel;
+
+		levelOffset = 0u;
+		levelSize = 1u;
+		while(levelSize < Size)
+		{
+			nextLevel.clear();
+
+			for(const glm::uvec3& node : level)
+			{
+				uint8_t mask = masks[levelOffset + (node.z * levelSize + node.y) * levelSize + node.x];
+				m_nodes.push_back(mask);
+
+				for(uint8_t childIndex = 0u; childIndex < 8u; ++childIndex)
+				{
+					if(mask & (1u << childIndex))
+					{
+						nextLevel.emplace_back(
+							node.x * 2u + (childIndex & 1u),
+							node.y * 2u + ((childIndex >> 1u) & 1u),
+							node.z * 2u + ((childIndex >> 2u) & 1u));
+					}
+				}
+			}
+
+			std::swap(level, nextLevel);
+
+			levelOffset += levelSize * levelSize * levelSize;
+			levelSize *= 2u;
+		}
+
+		for(const glm::uvec3& leaf : level)
+		{
+			m_nodes.push_back(values[(leaf.z * Size + leaf.y) * Size + leaf.x]);
+		}
+	}
+
+	/**
+	 * @brief Writes every value of the octree into a dense grid, the inverse of @ref Build.
+	 *
+	 * @param values The values indexed by '(z * Size + y) * Size + x'. Must contain Size^3 values.
+	 */
+	auto Extract(std::span<uint8_t> values) const -> void
+	{
+		if(m_nodes.empty())
+		{
+			std::ranges::fill(values, m_uniformValue);
+
+			return;
+		}
+
+		std::ranges::fill(values, 0u);
+
+		ForEachLeaf(
+			[&] (const glm::uvec3& coordinate, uint8_t value) -> void
+			{
+				values[(coordinate.z * Size + coordinate.y) * Size + coordinate.x] = value;
+			});
+	}
+
+	/**
+	 * @brief Calls a function for every stored leaf in storage order.
+	 *
+	 * Uniform octrees store no leaves.
+	 *
+	 * @param function Called with the coordinate and the value of every leaf.
+	 */
+	template<typename TFunction>
+	auto ForEachLeaf(TFunction&& function) const -> void
+	{
+		if(m_nodes.empty())
+		{
+			return;
+		}
+
+		// Walk the levels in storage order, tracking the origin of every node of the current level.
+		std::vector<glm::uvec3> origins = { glm::uvec3(0u) };
+		std::vector<glm::uvec3> childOrigins;
+
+		size_t nodeIndex = 0u;
+		uint32_t half = static_cast<uint32_t>(s_half);
+		for(size_t level = 0u; level < L; ++level)
+		{
+			childOrigins.clear();
+
+			for(const glm::uvec3& origin : origins)
+			{
+				uint8_t mask = m_nodes[nodeIndex++];
+
+				for(uint32_t childIndex = 0u; childIndex < 8u; ++childIndex)
+				{
+					if(mask & (1u << childIndex))
+					{
+						childOrigins.emplace_back(origin + glm::uvec3(childIndex & 1u, (childIndex >> 1u) & 1u, (childIndex >> 2u) & 1u) * half);
+					}
+				}
+			}
+
+			std::swap(origins, childOrigins);
+			half /= 2u;
+		}
+
+		for(const glm::uvec3& origin : origins)
+		{
+			function(origin, m_nodes[nodeIndex++]);
+		}
+	}
+
+	/**
+	 * @brief Retrieves the number of stored leaves.
+	 *
+	 * The leaves are the last nodes of @ref Data.
+	 *
+	 * @return The number of leaves, 0 if the octree is uniform.
+	 */
+	[[nodiscard]] auto GetLeafCount() const noexcept -> size_t
+	{
+		if(m_nodes.empty())
+		{
+			return 0u;
+		}
+
+		// Every set bit of a level is a node of the next one.
+		size_t levelBegin = 0u;
+		size_t levelSize = 1u;
+		for(size_t level = 0u; level < L; ++level)
+		{
+			size_t childCount = PopCountRange(&m_nodes[levelBegin], &m_nodes[levelBegin] + levelSize);
+
+			levelBegin += levelSize;
+			levelSize = childCount;
+		}
+
+		return levelSize;
+	}
+
+	/**
+	 * @brief Replaces the nodes with ones previously retrieved by @ref Data.
+	 *
+	 * @param nodes The nodes of a non-uniform octree.
+	 */
+	auto Assign(std::vector<uint8_t> nodes) -> void
+	{
+		m_nodes = std::move(nodes);
+		m_uniformValue = 0u;
+	}
+
+	/**
+	 * @brief Retrieves whether the octree has the same value everywhere.
+	 *
+	 * Uniform octrees store no nodes.
+	 *
+	 * @return 'true' if the octree is uniform, otherwise 'false'.
+	 */
+	[[nodiscard]] constexpr auto IsUniform() const noexcept -> bool
+	{
+		return m_nodes.empty();
+	}
+
+	/**
+	 * @brief Retrieves the value of a uniform octree.
+	 *
+	 * @return The value of every voxel if the octree is uniform, otherwise undefined.
+	 */
+	[[nodiscard]] constexpr auto GetUniformValue() const noexcept -> uint8_t
+	{
+		return m_uniformValue;
+	}
+
 	/**
 	 * @brief Retrieves the internal data.
 	 * 
+	 * Empty if the octree is uniform.
+	 *
 	 * @return A span to the bytes of the data.
 	 */
 	[[nodiscard]] constexpr auto Data() const noexcept -> std::span<const uint8_t>
@@ -155,5 +435,21 @@ public:
 private:
 	static constexpr size_t s_half = Size / 2u;
 
+	/**
+	 * @brief The number of nodes above the leaves in a full tree.
+	 */
+	static constexpr size_t s_innerNodeCount = (PowerConstexpr(8u, L) - 1u) / 7u;
+
 	std::vector<uint8_t> m_nodes;
+	uint8_t m_uniformValue = 0u;
+
+	/**
+	 * @brief Turns a uniform octree into a full tree of nodes so it can be edited.
+	 */
+	auto Expand() -> void
+	{
+		// The nodes are stored level by level, so a full tree is every inner node with all children set followed by the leaves.
+		m_nodes.assign(s_innerNodeCount, 0xFFu);
+		m_nodes.resize(s_innerNodeCount + Size * Size * Size, m_uniformValue);
+	}
 };
@@ -0,0 +1,201 @@
+#include "Profiler.h"
+
+#if defined(ENABLE_PROFILER)
+
+#include <toml++/toml.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief The events a capture leaves out at the old end of a ring, the owning thread may be overwriting them while they are copied.
+	 */
+	constexpr size_t OverwriteMargin = 256u;
+
+	/**
+	 * @brief The number of scopes recorded to measure the overhead.
+	 */
+	constexpr size_t OverheadSampleCount = 10000u;
+
+	struct ThreadBuffer
+	{
+		std::string Name;
+		uint32_t Id;
+		uint32_t Depth = 0u;
+
+		/**
+		 * @brief The number of events ever written, only the owning thread writes it.
+		 */
+		std::atomic<uint64_t> EventCount = 0u;
+		std::array<Profiler::Event, Profiler::RingCapacity> Events;
+	};
+
+	const Clock::time_point s_start = Clock::now();
+
+	/**
+	 * @brief The buffers of every thread that recorded a scope. Never freed, so captures may read the buffers of finished threads.
+	 */
+	std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+	std::mutex s_buffersMutex;
+
+	thread_local ThreadBuffer* t_buffer = nullptr;
+
+	[[nodiscard]] auto GetThreadBuffer() -> ThreadBuffer&
+	{
+		if(t_buffer == nullptr)
+		{
+			std::scoped_lock lock(s_buffersMutex);
+
+			auto buffer = std::make_unique<ThreadBuffer>();
+			buffer->Id = static_cast<uint32_t>(s_buffers.size());
+			buffer->Name = "Thread " + std::to_string(buffer->Id);
+
+			t_buffer = s_buffers.emplace_back(std::move(buffer)).get();
+		}
+
+		return *t_buffer;
+	}
+}
+
+namespace Profiler
+{
+	Scope::Scope(const char* name) noexcept
+		: m_name(name), m_begin(GetTime())
+	{
+		++GetThreadBuffer().Depth;
+	}
+
+	Scope::~Scope()
+	{
+		int64_t end = GetTime();
+
+		ThreadBuffer& buffer = *t_buffer;
+		--buffer.Depth;
+
+		uint64_t eventCount = buffer.EventCount.load(std::memory_order_relaxed);
+		buffer.Events[eventCount % RingCapacity] = Event{
+			.Name = m_name,
+			.Begin = m_begin,
+			.End = end,
+			.Depth = buffer.Depth,
+		};
+
+		buffer.EventCount.store(eventCount + 1u, std::memory_order_release);
+	}
+
+	auto GetTime() noexcept -> int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - s_start).count();
+	}
+
+	auto SetThreadName(std::string name) -> void
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		std::scoped_lock lock(s_buffersMutex);
+		buffer.Name = std::move(name);
+	}
+
+	auto Capture(size_t maxEventCount) -> std::vector<ThreadCapture>
+	{
+		std::scoped_lock lock(s_buffersMutex);
+
+		std::vector<ThreadCapture> captures;
+		captures.reserve(s_buffers.size());
+
+		for(const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+		{
+			uint64_t eventCount = buffer->EventCount.load(std::memory_order_acquire);
+			size_t count = static_cast<size_t>(std::min<uint64_t>(eventCount, std::min(RingCapacity - OverwriteMargin, maxEventCount)));
+			if(count == 0u)
+			{
+				continue;
+			}
+
+			ThreadCapture& capture = captures.emplace_back(
+				ThreadCapture{
+					.Name = buffer->Name,
+					.Id = buffer->Id,
+				});
+
+			capture.Events.reserve(count);
+			for(uint64_t i = eventCount - count; i < eventCount; ++i)
+			{
+				capture.Events.push_back(buffer->Events[i % RingCapacity]);
+			}
+
+			// Scopes are written when they end, so parents follow their children
+			std::ranges::sort(
+				capture.Events,
+				[] (const Event& a, const Event& b) -> bool
+				{
+					return (a.Begin != b.Begin) ? a.Begin < b.Begin : a.Depth < b.Depth;
+				});
+		}
+
+		return captures;
+	}
+
+	auto WriteChromeTrace(const std::filesystem::path& path) -> bool
+	{
+		toml::array events;
+		for(const ThreadCapture& capture : Capture())
+		{
+			events.push_back(
+				toml::table{
+					{ "name", "thread_name" },
+					{ "ph", "M" },
+					{ "pid", 1 },
+					{ "tid", static_cast<int64_t>(capture.Id) },
+					{ "args", toml::table{ { "name", capture.Name } } },
+				});
+
+			for(const Event& event : capture.Events)
+			{
+				// Complete events with the times in microseconds
+				events.push_back(
+					toml::table{
+						{ "name", event.Name },
+						{ "ph", "X" },
+						{ "pid", 1 },
+						{ "tid", static_cast<int64_t>(capture.Id) },
+						{ "ts", static_cast<double>(event.Begin) / 1000.0 },
+						{ "dur", static_cast<double>(event.End - event.Begin) / 1000.0 },
+					});
+			}
+		}
+
+		std::ofstream file(path);
+		if(!file)
+		{
+			return false;
+		}
+
+		file << toml::json_formatter{ toml::table{ { "traceEvents", std::move(events) } } } << std::endl;
+
+		return static_cast<bool>(file);
+	}
+
+	auto MeasureScopeOverhead() -> double
+	{
+		int64_t begin = GetTime();
+
+		for(size_t i = 0u; i < OverheadSampleCount; ++i)
+		{
+			PROFILE_SCOPE("Profiler overhead");
+		}
+
+		return static_cast<double>(GetTime() - begin) / static_cast<double>(OverheadSampleCount);
+	}
+}
+
+#endif
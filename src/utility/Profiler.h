@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#if defined(ENABLE_PROFILER)
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+/**
+ * @brief Records the time until the end of the enclosing block under a name, which must outlive the profiler, e.g. a string literal.
+ */
+#define PROFILE_SCOPE(name) const Profiler::Scope PROFILER_CONCAT(profileScope, __LINE__)(name)
+
+/**
+ * @brief Names the calling thread in the captures.
+ */
+#define PROFILE_THREAD_NAME(name) Profiler::SetThreadName(name)
+
+#else
+
+#define PROFILE_SCOPE(name) static_cast<void>(0)
+#define PROFILE_THREAD_NAME(name) static_cast<void>(0)
+
+#endif
+
+/**
+ * @brief A hierarchical CPU profiler.
+ *
+ * Every thread records its scopes into its own ring buffer without locking, the oldest events are overwritten.
+ * Only compiled with 'ENABLE_PROFILER' defined, which premake sets with '--profiler'. Otherwise the macros expand to nothing.
+ */
+namespace Profiler
+{
+	/**
+	 * @brief The number of events kept per thread.
+	 */
+	inline constexpr size_t RingCapacity = 16384u;
+
+	/**
+	 * @brief A finished scope.
+	 */
+	struct Event
+	{
+		/**
+		 * @brief The name of the scope.
+		 */
+		const char* Name;
+
+		/**
+		 * @brief The time the scope started and ended in nanoseconds since the profiler started.
+		 */
+		int64_t Begin;
+		int64_t End;
+
+		/**
+		 * @brief The number of scopes the scope was nested in on its thread.
+		 */
+		uint32_t Depth;
+	};
+
+	/**
+	 * @brief The recent events of a thread.
+	 */
+	struct ThreadCapture
+	{
+		/**
+		 * @brief The name of the thread.
+		 */
+		std::string Name;
+
+		/**
+		 * @brief The index of the thread in the order of its first recorded scope.
+		 */
+		uint32_t Id;
+
+		/**
+		 * @brief The events ordered by their start.
+		 */
+		std::vector<Event> Events;
+	};
+
+	/**
+	 * @brief Records an event from its construction to its destruction.
+	 */
+	class Scope
+	{
+	public:
+		/**
+		 * @brief Starts the event.
+		 *
+		 * @param name The name of the event, must outlive the profiler.
+		 */
+		explicit Scope(const char* name) noexcept;
+
+		/**
+		 * @brief Finishes the event and writes it into the thread's ring buffer.
+		 */
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		auto operator=(const Scope&) -> Scope& = delete;
+
+		Scope(Scope&&) noexcept = delete;
+		auto operator=(Scope&&) noexcept -> Scope& = delete;
+
+	private:
+		const char* m_name;
+		int64_t m_begin;
+	};
+
+	/**
+	 * @brief Retrieves the time the events are measured in.
+	 *
+	 * @return The nanoseconds since the profiler started.
+	 */
+	[[nodiscard]] auto GetTime() noexcept -> int64_t;
+
+	/**
+	 * @brief Names the calling thread in the captures.
+	 *
+	 * @param name The name of the thread.
+	 */
+	auto SetThreadName(std::string name) -> void;
+
+	/**
+	 * @brief Copies the recent events of every thread.
+	 *
+	 * The threads keep recording meanwhile, so events about to be overwritten are left out.
+	 *
+	 * @param maxEventCount The largest number of events copied per thread, the newest ones are kept.
+	 *
+	 * @return The events of every thread that recorded any.
+	 */
+	[[nodiscard]] auto Capture(size_t maxEventCount = RingCapacity) -> std::vector<ThreadCapture>;
+
+	/**
+	 * @brief Writes the recent events of every thread in the Chrome trace event format, which Perfetto and chrome://tracing open.
+	 *
+	 * @param path The path of the file.
+	 *
+	 * @return Whether the file could be written.
+	 */
+	auto WriteChromeTrace(const std::filesystem::path& path) -> bool;
+
+	/**
+	 * @brief Measures the cost of recording a scope on the calling thread.
+	 *
+	 * Records a burst of empty scopes, which show up in the captures.
+	 *
+	 * @return The average time a scope takes to record in nanoseconds.
+	 */
+	[[nodiscard]] auto MeasureScopeOverhead() -> double;
+}
@@ -0,0 +1,232 @@
+#include "Socket.h"
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <arpa/inet.h>
+	#include <netdb.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <sys/socket.h>
+	#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <utility>
+
+namespace
+{
+#ifdef _WIN32
+	using NativeSocket = SOCKET;
+
+	constexpr int SendFlags = 0;
+	constexpr int ShutdownBoth = SD_BOTH;
+
+	/**
+	 * @brief Initializes Winsock for the lifetime of the program.
+	 */
+	auto InitializeSockets() -> void
+	{
+		[[maybe_unused]] static const bool s_isInitialized = [] () -> bool
+			{
+				WSADATA data;
+
+				return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+			}();
+	}
+
+	auto CloseNative(NativeSocket handle) -> void
+	{
+		closesocket(handle);
+	}
+#else
+	using NativeSocket = int;
+
+	// A closed peer mustn't kill the process with SIGPIPE.
+	constexpr int SendFlags = MSG_NOSIGNAL;
+	constexpr int ShutdownBoth = SHUT_RDWR;
+
+	auto InitializeSockets() -> void
+	{
+
+	}
+
+	auto CloseNative(NativeSocket handle) -> void
+	{
+		close(handle);
+	}
+#endif
+
+	/**
+	 * @brief Sends small messages right away instead of waiting to batch them.
+	 *
+	 * @param handle The native handle.
+	 */
+	auto DisableNagle(NativeSocket handle) -> void
+	{
+		int value = 1;
+		setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+}
+
+Socket::Socket(uintptr_t handle) noexcept
+	: m_handle(handle)
+{
+
+}
+
+Socket::~Socket()
+{
+	Close();
+}
+
+Socket::Socket(Socket&& other) noexcept
+	: m_handle(std::exchange(other.m_handle, InvalidHandle))
+{
+
+}
+
+auto Socket::operator=(Socket&& other) noexcept -> Socket&
+{
+	if(this != &other)
+	{
+		Close();
+
+		m_handle = std::exchange(other.m_handle, InvalidHandle);
+	}
+
+	return *this;
+}
+
+auto Socket::Listen(uint16_t port) -> Socket
+{
+	InitializeSockets();
+
+	NativeSocket handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	Socket listener(static_cast<uintptr_t>(handle));
+
+	int value = 1;
+	setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&value), sizeof(value));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if(
+		bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+		listen(handle, SOMAXCONN) != 0)
+	{
+		printf("Failed to listen on port %u\n", static_cast<unsigned>(port));
+
+		return Socket();
+	}
+
+	return listener;
+}
+
+auto Socket::Connect(const std::string& host, uint16_t port) -> Socket
+{
+	InitializeSockets();
+
+	addrinfo hints{};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	addrinfo* addresses = nullptr;
+	if(getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+	{
+		printf("Failed to resolve '%s'\n", host.c_str());
+
+		return Socket();
+	}
+
+	Socket connection;
+	for(addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+	{
+		NativeSocket handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+		Socket candidate(static_cast<uintptr_t>(handle));
+
+		if(connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0)
+		{
+			DisableNagle(handle);
+			connection = std::move(candidate);
+
+			break;
+		}
+	}
+
+	freeaddrinfo(addresses);
+
+	if(!connection.IsValid())
+	{
+		printf("Failed to connect to '%s:%u'\n", host.c_str(), static_cast<unsigned>(port));
+	}
+
+	return connection;
+}
+
+auto Socket::Accept() -> Socket
+{
+	NativeSocket handle = accept(static_cast<NativeSocket>(m_handle), nullptr, nullptr);
+	Socket connection(static_cast<uintptr_t>(handle));
+
+	if(connection.IsValid())
+	{
+		DisableNagle(handle);
+	}
+
+	return connection;
+}
+
+auto Socket::Send(std::span<const uint8_t> data) -> bool
+{
+	while(!data.empty())
+	{
+		auto sentSize = send(static_cast<NativeSocket>(m_handle), reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), SendFlags);
+		if(sentSize <= 0)
+		{
+			return false;
+		}
+
+		data = data.subspan(static_cast<size_t>(sentSize));
+	}
+
+	return true;
+}
+
+auto Socket::Receive(std::span<uint8_t> data) -> bool
+{
+	while(!data.empty())
+	{
+		auto receivedSize = recv(static_cast<NativeSocket>(m_handle), reinterpret_cast<char*>(data.data()), static_cast<int>(data.size()), 0);
+		if(receivedSize <= 0)
+		{
+			return false;
+		}
+
+		data = data.subspan(static_cast<size_t>(receivedSize));
+	}
+
+	return true;
+}
+
+auto Socket::Shutdown() -> void
+{
+	if(IsValid())
+	{
+		shutdown(static_cast<NativeSocket>(m_handle), ShutdownBoth);
+	}
+}
+
+auto Socket::Close() noexcept -> void
+{
+	if(IsValid())
+	{
+		CloseNative(static_cast<NativeSocket>(m_handle));
+
+		m_handle = InvalidHandle;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief A blocking TCP socket.
+ *
+ * Failures are reported through the return values, an invalid socket stands for a failed connection.
+ */
+class Socket
+{
+public:
+	/**
+	 * @brief Creates an invalid socket.
+	 */
+	Socket() = default;
+
+	/**
+	 * @brief Closes the socket.
+	 */
+	~Socket();
+
+	Socket(const Socket&) = delete;
+	auto operator=(const Socket&) -> Socket& = delete;
+
+	Socket(Socket&& other) noexcept;
+	auto operator=(Socket&& other) noexcept -> Socket&;
+
+	/**
+	 * @brief Opens a socket accepting connections on the loopback interface.
+	 *
+	 * @param port The port to listen on.
+	 *
+	 * @return The listening socket, invalid if the port couldn't be bound.
+	 */
+	[[nodiscard]] static auto Listen(uint16_t port) -> Socket;
+
+	/**
+	 * @brief Connects to a listening socket.
+	 *
+	 * @param host The name or address of the host.
+	 * @param port The port of the listening socket.
+	 *
+	 * @return The connected socket, invalid if the connection failed.
+	 */
+	[[nodiscard]] static auto Connect(const std::string& host, uint16_t port) -> Socket;
+
+	/**
+	 * @brief Waits for the next connection of a listening socket.
+	 *
+	 * @return The connected socket, invalid if the listening socket was shut down.
+	 */
+	[[nodiscard]] auto Accept() -> Socket;
+
+	/**
+	 * @brief Sends every byte of a buffer.
+	 *
+	 * @param data The bytes to send.
+	 *
+	 * @return 'false' if the connection was closed, otherwise 'true'.
+	 */
+	auto Send(std::span<const uint8_t> data) -> bool;
+
+	/**
+	 * @brief Waits until a buffer is completely filled.
+	 *
+	 * @param data The buffer receiving the bytes.
+	 *
+	 * @return 'false' if the connection was closed before, otherwise 'true'.
+	 */
+	auto Receive(std::span<uint8_t> data) -> bool;
+
+	/**
+	 * @brief Ends the connection in both directions, which wakes up the threads blocked on it.
+	 */
+	auto Shutdown() -> void;
+
+	[[nodiscard]] auto IsValid() const noexcept -> bool
+	{
+		return m_handle != InvalidHandle;
+	}
+
+private:
+	static constexpr uintptr_t InvalidHandle = ~uintptr_t(0u);
+
+	/**
+	 * @brief The native handle, a 'SOCKET' on Windows and a file descriptor elsewhere.
+	 */
+	uintptr_t m_handle = InvalidHandle;
+
+	/**
+	 * @brief Wraps a native handle.
+	 *
+	 * @param handle The native handle.
+	 */
+	explicit Socket(uintptr_t handle) noexcept;
+
+	/**
+	 * @brief Closes the native handle.
+	 */
+	auto Close() noexcept -> void;
+};
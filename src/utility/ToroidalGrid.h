@@ -0,0 +1,197 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Calls a function for every cell of a rectangle that isn't inside another one.
+ *
+ * Takes time proportional to the width of the first rectangle plus the number of visited cells.
+ *
+ * @param min The first cell of the rectangle.
+ * @param max The cell after the last one of the rectangle.
+ * @param excludedMin The first cell of the excluded rectangle.
+ * @param excludedMax The cell after the last one of the excluded rectangle.
+ * @param function Called with the coordinate of every visited cell.
+ */
+template<typename TFunction>
+auto ForEachInRectDifference(
+	const glm::ivec2& min,
+	const glm::ivec2& max,
+	const glm::ivec2& excludedMin,
+	const glm::ivec2& excludedMax,
+	TFunction&& function) -> void
+{
+	for(int32_t x = min.x; x < max.x; ++x)
+	{
+		if(x < excludedMin.x || x >= excludedMax.x)
+		{
+			for(int32_t y = min.y; y < max.y; ++y)
+			{
+				function(glm::ivec2(x, y));
+			}
+
+			continue;
+		}
+
+		for(int32_t y = min.y; y < glm::min(max.y, excludedMin.y); ++y)
+		{
+			function(glm::ivec2(x, y));
+		}
+
+		for(int32_t y = glm::max(min.y, excludedMax.y); y < max.y; ++y)
+		{
+			function(glm::ivec2(x, y));
+		}
+	}
+}
+
+/**
+ * @brief A square window of cells over an infinite grid, stored in a fixed array that wraps around.
+ *
+ * Moving the window only touches the cells that scroll in or out, the rest keep their place in memory.
+ *
+ * @tparam T The type of the cells. Cells scrolling out are reset to a default constructed value.
+ */
+template<typename T>
+class ToroidalGrid
+{
+public:
+	/**
+	 * @brief Creates a window of default constructed cells.
+	 *
+	 * @param size The number of cells along one side.
+	 * @param origin The coordinate of the first cell of the window.
+	 */
+	ToroidalGrid(int32_t size, const glm::ivec2& origin)
+		: m_cells(static_cast<size_t>(size * size)), m_size(size), m_origin(origin)
+	{
+
+	}
+
+	/**
+	 * @brief Moves the window.
+	 *
+	 * @param origin The coordinate of the new first cell of the window.
+	 * @param onLeave Called with the coordinate and the cell of every cell leaving the window, before the cell is reset.
+	 */
+	template<typename TFunction>
+	auto Move(const glm::ivec2& origin, TFunction&& onLeave) -> void
+	{
+		if(origin == m_origin)
+		{
+			return;
+		}
+
+		ForEachInRectDifference(
+			m_origin,
+			m_origin + m_size,
+			origin,
+			origin + m_size,
+			[&] (const glm::ivec2& coordinate) -> void
+			{
+				T& cell = m_cells[GetIndex(coordinate)];
+
+				onLeave(coordinate, cell);
+				cell = T();
+			});
+
+		m_origin = origin;
+	}
+
+	/**
+	 * @brief Retrieves a cell.
+	 *
+	 * @param coordinate The coordinate of the cell.
+	 *
+	 * @return A pointer to the cell or 'nullptr' if it is outside the window.
+	 */
+	[[nodiscard]] auto Find(const glm::ivec2& coordinate) noexcept -> T*
+	{
+		return Contains(coordinate) ? &m_cells[GetIndex(coordinate)] : nullptr;
+	}
+
+	/**
+	 * @brief Retrieves a cell.
+	 *
+	 * @param coordinate The coordinate of the cell.
+	 *
+	 * @return A pointer to the cell or 'nullptr' if it is outside the window.
+	 */
+	[[nodiscard]] auto Find(const glm::ivec2& coordinate) const noexcept -> const T*
+	{
+		return Contains(coordinate) ? &m_cells[GetIndex(coordinate)] : nullptr;
+	}
+
+	/**
+	 * @brief Checks whether a cell is inside the window.
+	 *
+	 * @param coordinate The coordinate of the cell.
+	 *
+	 * @return 'true' if the cell is inside the window, otherwise 'false'.
+	 */
+	[[nodiscard]] auto Contains(const glm::ivec2& coordinate) const noexcept -> bool
+	{
+		return
+			glm::all(glm::greaterThanEqual(coordinate, m_origin)) &&
+			glm::all(glm::lessThan(coordinate, m_origin + m_size));
+	}
+
+	/**
+	 * @brief Calls a function for every cell of the window.
+	 *
+	 * @param function Called with the coordinate and the cell.
+	 */
+	template<typename TFunction>
+	auto ForEach(TFunction&& function) -> void
+	{
+		for(int32_t x = m_origin.x; x < m_origin.x + m_size; ++x)
+		{
+			for(int32_t y = m_origin.y; y < m_origin.y + m_size; ++y)
+			{
+				function(glm::ivec2(x, y), m_cells[GetIndex(glm::ivec2(x, y))]);
+			}
+		}
+	}
+
+	/**
+	 * @brief Retrieves the number of cells along one side.
+	 *
+	 * @return The size of the window.
+	 */
+	[[nodiscard]] auto GetSize() const noexcept -> int32_t
+	{
+		return m_size;
+	}
+
+	/**
+	 * @brief Retrieves the coordinate of the first cell of the window.
+	 *
+	 * @return The origin of the window.
+	 */
+	[[nodiscard]] auto GetOrigin() const noexcept -> const glm::ivec2&
+	{
+		return m_origin;
+	}
+
+private:
+	std::vector<T> m_cells;
+	int32_t m_size;
+	glm::ivec2 m_origin;
+
+	/**
+	 * @brief Wraps a coordinate into the array.
+	 *
+	 * @param coordinate The coordinate of the cell.
+	 *
+	 * @return The index of the cell.
+	 */
+	[[nodiscard]] auto GetIndex(const glm::ivec2& coordinate) const noexcept -> size_t
+	{
+		glm::ivec2 wrapped = ((coordinate % m_size) + m_size) % m_size;
+
+		return static_cast<size_t>(wrapped.y * m_size + wrapped.x);
+	}
+};
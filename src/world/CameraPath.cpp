@@ -0,0 +1,101 @@
+#include "CameraPath.h"
+
+#include <toml++/toml.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+CameraPath::CameraPath(float timeStep, int32_t seed)
+	: m_timeStep(timeStep), m_seed(seed)
+{
+
+}
+
+auto CameraPath::Record(float time, const Camera& camera) -> void
+{
+	while(static_cast<float>(m_keyframes.size()) * m_timeStep <= time)
+	{
+		m_keyframes.emplace_back(
+			CameraKeyframe{
+				.Position = camera.Position,
+				.Rotation = camera.Rotation,
+			});
+	}
+}
+
+auto CameraPath::Sample(float time) const -> std::optional<CameraKeyframe>
+{
+	float index = time / m_timeStep;
+	if(m_keyframes.empty() || index > static_cast<float>(m_keyframes.size() - 1u))
+	{
+		return std::nullopt;
+	}
+
+	size_t first = static_cast<size_t>(index);
+	size_t second = std::min(first + 1u, m_keyframes.size() - 1u);
+	float t = index - std::floor(index);
+
+	return CameraKeyframe{
+		.Position = glm::mix(m_keyframes[first].Position, m_keyframes[second].Position, t),
+		.Rotation = glm::mix(m_keyframes[first].Rotation, m_keyframes[second].Rotation, t),
+	};
+}
+
+auto CameraPath::Save(const std::filesystem::path& path) const -> void
+{
+	toml::array keyframes;
+	for(const CameraKeyframe& keyframe : m_keyframes)
+	{
+		keyframes.push_back(
+			toml::array{
+				keyframe.Position.x, keyframe.Position.y, keyframe.Position.z,
+				keyframe.Rotation.x, keyframe.Rotation.y, keyframe.Rotation.z,
+			});
+	}
+
+	toml::table table{
+		{ "aKeyframes", std::move(keyframes) },
+		{ "fTimeStep", m_timeStep },
+		{ "iSeed", m_seed },
+	};
+
+	std::ofstream file(path);
+
+	file << table << std::endl;
+}
+
+auto CameraPath::Load(const std::filesystem::path& path) -> CameraPath
+{
+	toml::table table = toml::parse_file(path.string());
+
+	CameraPath cameraPath(
+		static_cast<float>(table["fTimeStep"].value_or(1.0 / 60.0)),
+		static_cast<int32_t>(table["iSeed"].value_or(int64_t(0))));
+
+	if(const toml::array* keyframes = table["aKeyframes"].as_array(); keyframes != nullptr)
+	{
+		for(const toml::node& node : *keyframes)
+		{
+			const toml::array& values = *node.as_array();
+
+			auto get = [&] (size_t index) -> float
+				{
+					return static_cast<float>(values[index].value_or(0.0));
+				};
+
+			cameraPath.m_keyframes.emplace_back(
+				CameraKeyframe{
+					.Position = glm::vec3(get(0u), get(1u), get(2u)),
+					.Rotation = glm::vec3(get(3u), get(4u), get(5u)),
+				});
+		}
+	}
+
+	return cameraPath;
+}
+
+auto CameraPath::GetDuration() const noexcept -> float
+{
+	return m_keyframes.empty() ? 0.0f : static_cast<float>(m_keyframes.size() - 1u) * m_timeStep;
+}
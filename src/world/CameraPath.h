@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Camera.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief The position and rotation of a camera at a point of a path.
+ */
+struct CameraKeyframe
+{
+	glm::vec3 Position;
+	glm::vec3 Rotation;
+};
+
+/**
+ * @brief A recorded camera movement, sampled at a fixed time step, together with the seed of the world it was recorded in.
+ */
+class CameraPath
+{
+public:
+	/**
+	 * @brief Creates an empty path.
+	 *
+	 * @param timeStep The time between two keyframes in seconds.
+	 * @param seed The seed of the world.
+	 */
+	CameraPath(float timeStep, int32_t seed);
+
+	/**
+	 * @brief Appends keyframes until the path reaches a point in time, holding the camera's current state.
+	 *
+	 * @param time The time since the start of the recording in seconds.
+	 * @param camera The camera.
+	 */
+	auto Record(float time, const Camera& camera) -> void;
+
+	/**
+	 * @brief Interpolates the keyframes around a point in time.
+	 *
+	 * @param time The time since the start of the path in seconds.
+	 *
+	 * @return The interpolated keyframe or 'std::nullopt' if the path ended.
+	 */
+	[[nodiscard]] auto Sample(float time) const -> std::optional<CameraKeyframe>;
+
+	/**
+	 * @brief Writes the path to a file.
+	 *
+	 * @param path The path of the file.
+	 */
+	auto Save(const std::filesystem::path& path) const -> void;
+
+	/**
+	 * @brief Reads a path written by @ref Save.
+	 *
+	 * @param path The path of the file.
+	 *
+	 * @return The loaded camera path.
+	 */
+	[[nodiscard]] static auto Load(const std::filesystem::path& path) -> CameraPath;
+
+	/**
+	 * @brief Retrieves the length of the path.
+	 *
+	 * @return The time between the first and the last keyframe in seconds.
+	 */
+	[[nodiscard]] auto GetDuration() const noexcept -> float;
+
+	[[nodiscard]] auto GetSeed() const noexcept -> int32_t
+	{
+		return m_seed;
+	}
+
+private:
+	float m_timeStep;
+	int32_t m_seed;
+	std::vector<CameraKeyframe> m_keyframes;
+};
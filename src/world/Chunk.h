@@ -2,6 +2,24 @@
 
 #include "../utility/Octree.h"
 
+#include <cstdint>
+
+/**
+ * @brief The material of a voxel, stored as the voxel's value.
+ *
+ * Matches the material colors in 'Shading.glsl'.
+ */
+enum class Material : uint8_t
+{
+	Air,
+	Stone,
+	Dirt,
+	Grass,
+	Sand,
+	Wood,
+	Leaves,
+};
+
 /**
  * @brief A 32*32*32 sized slice of the world.
  */
@@ -0,0 +1,81 @@
+#include "ChunkCache.h"
+
+ChunkCache::ChunkCache(size_t capacity)
+	: m_capacity(capacity)
+{
+
+}
+
+auto ChunkCache::Store(const glm::ivec3& coordinate, CompressedChunk chunk, bool isPrefetched) -> void
+{
+	if(auto it = m_entries.find(coordinate); it != m_entries.end())
+	{
+		Erase(it);
+	}
+
+	size_t entrySize = GetEntrySize(chunk);
+	if(entrySize > m_capacity)
+	{
+		return;
+	}
+
+	// Evict the least recently stored chunks until the new one fits
+	while(m_size + entrySize > m_capacity)
+	{
+		auto evicted = m_entries.find(m_recency.back());
+		if(evicted->second.IsPrefetched)
+		{
+			++m_prefetchWasteCount;
+		}
+
+		Erase(evicted);
+	}
+
+	m_recency.push_front(coordinate);
+	m_entries.emplace(
+		coordinate,
+		CacheEntry{
+			.Data = std::move(chunk),
+			.RecencyIterator = m_recency.begin(),
+			.IsPrefetched = isPrefetched,
+		});
+
+	m_size += entrySize;
+}
+
+auto ChunkCache::Take(const glm::ivec3& coordinate) -> std::optional<CompressedChunk>
+{
+	auto it = m_entries.find(coordinate);
+	if(it == m_entries.end())
+	{
+		++m_missCount;
+
+		return std::nullopt;
+	}
+
+	++m_hitCount;
+	if(it->second.IsPrefetched)
+	{
+		++m_prefetchHitCount;
+	}
+
+	CompressedChunk chunk = std::move(it->second.Data);
+	m_size -= GetEntrySize(chunk);
+	m_recency.erase(it->second.RecencyIterator);
+	m_entries.erase(it);
+
+	return chunk;
+}
+
+auto ChunkCache::Erase(std::unordered_map<glm::ivec3, CacheEntry>::iterator it) -> void
+{
+	m_size -= GetEntrySize(it->second.Data);
+	m_recency.erase(it->second.RecencyIterator);
+	m_entries.erase(it);
+}
+
+auto ChunkCache::GetEntrySize(const CompressedChunk& chunk) noexcept -> size_t
+{
+	// The bookkeeping is counted too, otherwise empty chunks would be free
+	return chunk.Data.capacity() + sizeof(CacheEntry) + sizeof(glm::ivec3) * 4u;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "ChunkCompression.h"
+
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+/**
+ * @brief Keeps the recently unloaded chunks in compressed form so they don't have to be generated again.
+ *
+ * The least recently stored chunks are evicted once the size limit is reached.
+ */
+class ChunkCache
+{
+public:
+	/**
+	 * @brief Creates an empty cache.
+	 *
+	 * @param capacity The maximum size of the stored chunks in bytes.
+	 */
+	explicit ChunkCache(size_t capacity);
+
+	/**
+	 * @brief Stores a chunk, replacing the previous version of it.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param chunk The compressed chunk.
+	 * @param isPrefetched Whether the chunk was generated ahead of the camera, only used for the statistics.
+	 */
+	auto Store(const glm::ivec3& coordinate, CompressedChunk chunk, bool isPrefetched = false) -> void;
+
+	/**
+	 * @brief Checks whether a chunk is cached.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return 'true' if the chunk is cached, otherwise 'false'.
+	 */
+	[[nodiscard]] auto Contains(const glm::ivec3& coordinate) const -> bool
+	{
+		return m_entries.contains(coordinate);
+	}
+
+	/**
+	 * @brief Removes a chunk from the cache.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return The compressed chunk or 'std::nullopt' if it isn't cached.
+	 */
+	[[nodiscard]] auto Take(const glm::ivec3& coordinate) -> std::optional<CompressedChunk>;
+
+	/**
+	 * @brief Retrieves the size of the stored chunks.
+	 *
+	 * @return The size in bytes.
+	 */
+	[[nodiscard]] auto GetSize() const noexcept -> size_t
+	{
+		return m_size;
+	}
+
+	/**
+	 * @brief Retrieves the number of chunks restored from the cache.
+	 *
+	 * @return The number of hits.
+	 */
+	[[nodiscard]] auto GetHitCount() const noexcept -> uint64_t
+	{
+		return m_hitCount;
+	}
+
+	/**
+	 * @brief Retrieves the number of chunks that had to be generated.
+	 *
+	 * @return The number of misses.
+	 */
+	[[nodiscard]] auto GetMissCount() const noexcept -> uint64_t
+	{
+		return m_missCount;
+	}
+
+	/**
+	 * @brief Retrieves the number of prefetched chunks that were restored.
+	 *
+	 * @return The number of prefetch hits.
+	 */
+	[[nodiscard]] auto GetPrefetchHitCount() const noexcept -> uint64_t
+	{
+		return m_prefetchHitCount;
+	}
+
+	/**
+	 * @brief Retrieves the number of prefetched chunks that were evicted without being restored.
+	 *
+	 * @return The number of wasted prefetches.
+	 */
+	[[nodiscard]] auto GetPrefetchWasteCount() const noexcept -> uint64_t
+	{
+		return m_prefetchWasteCount;
+	}
+
+private:
+	/**
+	 * @brief A chunk in the cache with its position in the recency list.
+	 */
+	struct CacheEntry
+	{
+		CompressedChunk Data;
+		std::list<glm::ivec3>::iterator RecencyIterator;
+		bool IsPrefetched;
+	};
+
+	size_t m_capacity;
+	size_t m_size = 0u;
+
+	std::unordered_map<glm::ivec3, CacheEntry> m_entries;
+	std::list<glm::ivec3> m_recency;
+
+	uint64_t m_hitCount = 0u;
+	uint64_t m_missCount = 0u;
+	uint64_t m_prefetchHitCount = 0u;
+	uint64_t m_prefetchWasteCount = 0u;
+
+	/**
+	 * @brief Removes an entry.
+	 *
+	 * @param it The entry.
+	 */
+	auto Erase(std::unordered_map<glm::ivec3, CacheEntry>::iterator it) -> void;
+
+	/**
+	 * @brief Retrieves the memory used by a stored chunk.
+	 *
+	 * @param chunk The compressed chunk.
+	 *
+	 * @return The size in bytes.
+	 */
+	[[nodiscard]] static auto GetEntrySize(const CompressedChunk& chunk) noexcept -> size_t;
+};
@@ -0,0 +1,134 @@
+#include "ChunkClient.h"
+
+#include "ChunkProtocol.h"
+
+#include <charconv>
+#include <cstdio>
+
+auto ChunkClient::Connect(const std::string& address, int32_t seed, int32_t height, ChunkCallback onChunk) -> std::unique_ptr<ChunkClient>
+{
+	std::string host = address;
+	uint16_t port = DefaultChunkServerPort;
+
+	if(size_t separator = address.rfind(':'); separator != std::string::npos)
+	{
+		host = address.substr(0u, separator);
+		std::from_chars(address.data() + separator + 1u, address.data() + address.size(), port);
+	}
+
+	Socket server = Socket::Connect(host, port);
+	if(!server.IsValid())
+	{
+		return nullptr;
+	}
+
+	// The server introduces its world first, chunks of another seed or height would mix with the local ones
+	std::optional<ChunkMessage> message = ReceiveChunkMessage(server, height);
+	const auto* hello = message.has_value() ? std::get_if<ChunkHelloMessage>(&*message) : nullptr;
+	if(hello == nullptr)
+	{
+		printf("The chunk server didn't describe its world\n");
+
+		return nullptr;
+	}
+
+	if(hello->Height != height || (seed != 0 && hello->Seed != seed))
+	{
+		printf("The chunk server generates seed %d with a height of %d, this world needs seed %d with a height of %d\n", hello->Seed, hello->Height, seed, height);
+
+		return nullptr;
+	}
+
+	return std::make_unique<ChunkClient>(std::move(server), hello->Seed, height, std::move(onChunk));
+}
+
+ChunkClient::ChunkClient(Socket server, int32_t seed, int32_t height, ChunkCallback onChunk)
+	: m_server(std::move(server)), m_seed(seed), m_height(height), m_onChunk(std::move(onChunk))
+{
+	m_reader = std::thread(&ChunkClient::ReadChunks, this);
+}
+
+ChunkClient::~ChunkClient()
+{
+	m_server.Shutdown();
+	m_reader.join();
+}
+
+auto ChunkClient::Request(uint64_t id, const glm::ivec3& coordinate, JobPriority priority) -> void
+{
+	std::scoped_lock lock(m_mutex);
+
+	m_pendingRequests.insert_or_assign(
+		id,
+		PendingRequest{
+			.Coordinate = coordinate,
+			.Priority = priority,
+		});
+
+	if(SendChunkMessage(m_server, ChunkRequestMessage{ .Id = id, .Coordinate = coordinate, .Priority = priority }) == 0u)
+	{
+		m_isConnected.store(false, std::memory_order_release);
+	}
+}
+
+auto ChunkClient::Cancel(uint64_t id) -> void
+{
+	std::scoped_lock lock(m_mutex);
+
+	if(m_pendingRequests.erase(id) > 0u)
+	{
+		SendChunkMessage(m_server, ChunkCancelMessage{ .Id = id });
+	}
+}
+
+auto ChunkClient::SendEdit(const glm::ivec3& coordinate, const CompressedChunk& chunk) -> void
+{
+	std::scoped_lock lock(m_mutex);
+
+	if(SendChunkMessage(m_server, ChunkEditMessage{ .Coordinate = coordinate, .Chunk = chunk }) == 0u)
+	{
+		m_isConnected.store(false, std::memory_order_release);
+	}
+}
+
+auto ChunkClient::ReadChunks() -> void
+{
+	while(std::optional<ChunkMessage> message = ReceiveChunkMessage(m_server, m_height))
+	{
+		auto* data = std::get_if<ChunkDataMessage>(&*message);
+		if(data == nullptr)
+		{
+			continue;
+		}
+
+		std::optional<PendingRequest> request;
+		{
+			std::scoped_lock lock(m_mutex);
+
+			if(auto it = m_pendingRequests.find(data->Id); it != m_pendingRequests.end())
+			{
+				request = it->second;
+				m_pendingRequests.erase(it);
+			}
+		}
+
+		// Answers to cancelled requests are dropped
+		if(!request.has_value())
+		{
+			continue;
+		}
+
+		// A broken server is dropped like a lost one, the world generates its pending chunks locally
+		std::optional<Chunk> chunk = DecompressChunk(data->Chunk);
+		if(!chunk.has_value())
+		{
+			printf("The chunk server sent a malformed chunk\n");
+
+			break;
+		}
+
+		m_onChunk(data->Id, request->Coordinate, request->Priority, std::move(*chunk), std::move(data->Chunk));
+	}
+
+	m_isConnected.store(false, std::memory_order_release);
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "ChunkCompression.h"
+#include "../utility/JobSystem.h"
+#include "../utility/Socket.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief Requests chunks from a chunk server instead of generating them.
+ *
+ * The answers are read on a separate thread, which passes them to the callback.
+ */
+class ChunkClient
+{
+public:
+	/**
+	 * @brief Called from the reading thread with the id, the coordinate and the priority of the request and the received chunk, decompressed and as received.
+	 */
+	using ChunkCallback = std::function<void(uint64_t, const glm::ivec3&, JobPriority, Chunk&&, CompressedChunk&&)>;
+
+	/**
+	 * @brief Connects to a chunk server and checks it generates the same world.
+	 *
+	 * @param address The address of the server as 'host:port' or 'host'.
+	 * @param seed The seed of the world, 0 to adopt the server's.
+	 * @param height The height of the world in chunks.
+	 * @param onChunk Called with every received chunk.
+	 *
+	 * @return The client or 'nullptr' if the connection failed or the server generates a different world.
+	 */
+	[[nodiscard]] static auto Connect(const std::string& address, int32_t seed, int32_t height, ChunkCallback onChunk) -> std::unique_ptr<ChunkClient>;
+
+	/**
+	 * @brief Starts reading from a connected socket.
+	 *
+	 * @param server The connection to the server, past its hello message.
+	 * @param seed The seed of the server's world.
+	 * @param height The height of the world in chunks.
+	 * @param onChunk Called with every received chunk.
+	 */
+	ChunkClient(Socket server, int32_t seed, int32_t height, ChunkCallback onChunk);
+
+	/**
+	 * @brief Disconnects and waits for the reading thread.
+	 */
+	~ChunkClient();
+
+	ChunkClient(const ChunkClient&) = delete;
+	auto operator=(const ChunkClient&) -> ChunkClient& = delete;
+
+	/**
+	 * @brief Asks the server for a chunk.
+	 *
+	 * @param id Identifies the request, must be unique.
+	 * @param coordinate The coordinate of the chunk.
+	 * @param priority The priority of the generation on the server.
+	 */
+	auto Request(uint64_t id, const glm::ivec3& coordinate, JobPriority priority) -> void;
+
+	/**
+	 * @brief Drops a request, its chunk won't be passed to the callback even if the server sends it.
+	 *
+	 * @param id The id of the request.
+	 */
+	auto Cancel(uint64_t id) -> void;
+
+	/**
+	 * @brief Sends an edited chunk to the server, which keeps it for every later request.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param chunk The compressed chunk.
+	 */
+	auto SendEdit(const glm::ivec3& coordinate, const CompressedChunk& chunk) -> void;
+
+	/**
+	 * @brief Retrieves the seed of the server's world.
+	 *
+	 * @return The seed.
+	 */
+	[[nodiscard]] auto GetSeed() const noexcept -> int32_t
+	{
+		return m_seed;
+	}
+
+	/**
+	 * @brief Checks whether the server is still connected.
+	 *
+	 * @return 'false' once the connection was lost, otherwise 'true'.
+	 */
+	[[nodiscard]] auto IsConnected() const noexcept -> bool
+	{
+		return m_isConnected.load(std::memory_order_acquire);
+	}
+
+private:
+	/**
+	 * @brief A request without an answer yet.
+	 */
+	struct PendingRequest
+	{
+		glm::ivec3 Coordinate;
+		JobPriority Priority;
+	};
+
+	Socket m_server;
+	int32_t m_seed;
+	int32_t m_height;
+	ChunkCallback m_onChunk;
+
+	/**
+	 * @brief Guards the pending requests and the sending side of the socket.
+	 */
+	std::mutex m_mutex;
+	std::unordered_map<uint64_t, PendingRequest> m_pendingRequests;
+
+	std::atomic<bool> m_isConnected = true;
+	std::thread m_reader;
+
+	/**
+	 * @brief Reads the answers until the connection is closed or the server sends a chunk that doesn't decompress.
+	 */
+	auto ReadChunks() -> void;
+};
@@ -0,0 +1,216 @@
+#include "ChunkCompression.h"
+
+#include "../utility/Math.h"
+#include "../utility/Profiler.h"
+
+#include <algorithm>
+#include <span>
+
+namespace
+{
+	// A control byte with the high bit set is followed by one byte repeated 'MinRunLength + (control & 0x7F)' times,
+	// otherwise it is followed by 'control + 1' literal bytes.
+	constexpr uint8_t RunFlag = 0x80u;
+	constexpr size_t MinRunLength = 3u;
+	constexpr size_t MaxRunLength = MinRunLength + 0x7Fu;
+	constexpr size_t MaxLiteralLength = 0x80u;
+
+	/**
+	 * @brief The number of nodes of a full chunk, the inner nodes of every level and a leaf per voxel.
+	 */
+	constexpr size_t MaxNodeCount = (Chunk::Size * Chunk::Size * Chunk::Size - 1u) / 7u + Chunk::Size * Chunk::Size * Chunk::Size;
+
+	auto EncodeRuns(std::span<const uint8_t> bytes, std::vector<uint8_t>& output) -> void
+	{
+		size_t literalBegin = 0u;
+
+		auto flushLiterals = [&] (size_t end) -> void
+			{
+				while(literalBegin < end)
+				{
+					size_t length = std::min(end - literalBegin, MaxLiteralLength);
+
+					output.push_back(static_cast<uint8_t>(length - 1u));
+					output.insert(output.end(), bytes.begin() + literalBegin, bytes.begin() + literalBegin + length);
+
+					literalBegin += length;
+				}
+			};
+
+		size_t i = 0u;
+		while(i < bytes.size())
+		{
+			size_t runLength = 1u;
+			while(i + runLength < bytes.size() && runLength < MaxRunLength && bytes[i + runLength] == bytes[i])
+			{
+				++runLength;
+			}
+
+			if(runLength < MinRunLength)
+			{
+				i += runLength;
+
+				continue;
+			}
+
+			flushLiterals(i);
+
+			output.push_back(static_cast<uint8_t>(RunFlag | (runLength - MinRunLength)));
+			output.push_back(bytes[i]);
+
+			i += runLength;
+			literalBegin = i;
+		}
+
+		flushLiterals(bytes.size());
+	}
+
+	/**
+	 * @brief Decodes runs, the data may come from a broken peer.
+	 *
+	 * @param encoded The runs.
+	 * @param maxSize The number of bytes the runs must not decode to more than.
+	 * @param output Receives the decoded bytes.
+	 *
+	 * @return 'false' if a run is cut off or the output exceeds the size, otherwise 'true'.
+	 */
+	auto DecodeRuns(std::span<const uint8_t> encoded, size_t maxSize, std::vector<uint8_t>& output) -> bool
+	{
+		size_t i = 0u;
+		while(i < encoded.size())
+		{
+			uint8_t control = encoded[i++];
+
+			size_t length = (control & RunFlag) ? MinRunLength + (control & ~RunFlag) : control + 1u;
+			if(output.size() + length > maxSize)
+			{
+				return false;
+			}
+
+			if(control & RunFlag)
+			{
+				if(i >= encoded.size())
+				{
+					return false;
+				}
+
+				output.insert(output.end(), length, encoded[i++]);
+			}
+			else
+			{
+				if(encoded.size() - i < length)
+				{
+					return false;
+				}
+
+				output.insert(output.end(), encoded.begin() + i, encoded.begin() + i + length);
+
+				i += length;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Finds where the leaves start by following the child counts level by level.
+	 */
+	auto GetInnerNodeCount(std::span<const uint8_t> nodes) -> size_t
+	{
+		size_t levelBegin = 0u;
+		size_t levelNodeCount = 1u;
+
+		for(size_t level = 0u; level < Chunk::LevelCount; ++level)
+		{
+			size_t childCount = PopCountRange(nodes.data() + levelBegin, nodes.data() + levelBegin + levelNodeCount);
+
+			levelBegin += levelNodeCount;
+			levelNodeCount = childCount;
+		}
+
+		return levelBegin;
+	}
+
+	/**
+	 * @brief Checks whether the child counts of every level lead exactly to the end of the nodes.
+	 *
+	 * @param nodes The nodes of a non-uniform octree.
+	 *
+	 * @return 'true' if the octree can be traversed without reading past the nodes, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsValidOctree(std::span<const uint8_t> nodes) -> bool
+	{
+		size_t levelBegin = 0u;
+		size_t levelNodeCount = 1u;
+
+		for(size_t level = 0u; level < Chunk::LevelCount; ++level)
+		{
+			if(nodes.size() - levelBegin < levelNodeCount)
+			{
+				return false;
+			}
+
+			size_t childCount = PopCountRange(nodes.data() + levelBegin, nodes.data() + levelBegin + levelNodeCount);
+
+			levelBegin += levelNodeCount;
+			levelNodeCount = childCount;
+		}
+
+		// The last level counts the leaves
+		return nodes.size() - levelBegin == levelNodeCount;
+	}
+}
+
+auto CompressChunk(const Chunk& chunk) -> CompressedChunk
+{
+	PROFILE_SCOPE("CompressChunk");
+
+	CompressedChunk compressedChunk{
+		.Data = {},
+		.NodeCount = static_cast<uint32_t>(chunk.Data().size()),
+		.UniformValue = chunk.IsUniform() ? chunk.GetUniformValue() : static_cast<uint8_t>(0u),
+	};
+
+	if(chunk.IsUniform())
+	{
+		return compressedChunk;
+	}
+
+	std::span<const uint8_t> nodes = chunk.Data();
+	size_t innerNodeCount = GetInnerNodeCount(nodes);
+
+	compressedChunk.Data.reserve(nodes.size() / 4u);
+	EncodeRuns(nodes.first(innerNodeCount), compressedChunk.Data);
+	EncodeRuns(nodes.subspan(innerNodeCount), compressedChunk.Data);
+	compressedChunk.Data.shrink_to_fit();
+
+	return compressedChunk;
+}
+
+auto DecompressChunk(const CompressedChunk& compressedChunk) -> std::optional<Chunk>
+{
+	Chunk chunk;
+
+	if(compressedChunk.NodeCount == 0u)
+	{
+		chunk.Fill(compressedChunk.UniformValue);
+
+		return chunk;
+	}
+
+	if(compressedChunk.NodeCount > MaxNodeCount)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<uint8_t> nodes;
+	nodes.reserve(compressedChunk.NodeCount);
+	if(!DecodeRuns(compressedChunk.Data, compressedChunk.NodeCount, nodes) || nodes.size() != compressedChunk.NodeCount || !IsValidOctree(nodes))
+	{
+		return std::nullopt;
+	}
+
+	chunk.Assign(std::move(nodes));
+
+	return chunk;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Chunk.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief A chunk packed for storage on the CPU.
+ */
+struct CompressedChunk
+{
+	/**
+	 * @brief The run-length encoded inner nodes followed by the run-length encoded leaves.
+	 */
+	std::vector<uint8_t> Data;
+
+	/**
+	 * @brief The number of bytes of the uncompressed nodes, 0 if the chunk is uniform.
+	 */
+	uint32_t NodeCount;
+
+	/**
+	 * @brief The value of every voxel if the chunk is uniform.
+	 */
+	uint8_t UniformValue;
+};
+
+/**
+ * @brief Compresses a chunk.
+ *
+ * The child masks and the leaf values are encoded as separate runs, long runs of full masks and of the same material rarely mix.
+ *
+ * @param chunk The chunk.
+ *
+ * @return The compressed chunk.
+ */
+[[nodiscard]] auto CompressChunk(const Chunk& chunk) -> CompressedChunk;
+
+/**
+ * @brief Restores a compressed chunk.
+ *
+ * The data is checked, so it may come from a broken peer.
+ *
+ * @param compressedChunk The compressed chunk.
+ *
+ * @return The original chunk or 'std::nullopt' if the data doesn't decode to a chunk of its node count.
+ */
+[[nodiscard]] auto DecompressChunk(const CompressedChunk& compressedChunk) -> std::optional<Chunk>;
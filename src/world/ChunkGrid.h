@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Chunk.h"
+#include "../utility/Math.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief An entry of the chunk directory uploaded to the GPU.
+ *
+ * Matches the layout of 'ChunkDirectory' in 'ChunkGrid.glsl'.
+ */
+struct ChunkDirectoryEntry
+{
+	/**
+	 * @brief The offset of the chunk's data in the chunk data buffer, @ref EmptyChunkOffset or @ref SolidChunkOffset.
+	 */
+	int32_t Offset;
+
+	/**
+	 * @brief The LOD the chunk is traced at, or the material of a solid chunk.
+	 */
+	int32_t Lod;
+
+	/**
+	 * @brief The offset of the chunk's baked lighting in the chunk data buffer.
+	 */
+	int32_t LightingOffset;
+
+	/**
+	 * @brief The offset of the chunk's first leaf in the chunk data buffer, the lighting is stored in the same order as the leaves.
+	 */
+	int32_t LeafOffset;
+};
+
+/**
+ * @brief The offset of the directory entries without loaded chunk data or with entirely empty chunks.
+ */
+inline constexpr int32_t EmptyChunkOffset = -1;
+
+/**
+ * @brief The offset of the directory entries with entirely solid chunks.
+ */
+inline constexpr int32_t SolidChunkOffset = -2;
+
+/**
+ * @brief Retrieves the column of chunks a position is in.
+ *
+ * Rounds toward negative infinity, so the chunks left of and behind the world origin aren't merged with the first ones.
+ *
+ * @param position The position in voxels.
+ *
+ * @return The horizontal coordinate of the chunk.
+ */
+[[nodiscard]] inline auto GetChunkColumn(const glm::vec3& position) noexcept -> glm::ivec2
+{
+	return glm::ivec2(glm::floor(glm::vec2(position.x, position.z) / static_cast<float>(Chunk::Size)));
+}
+
+/**
+ * @brief Marches a ray through a box of chunks front to back.
+ *
+ * CPU port of 'RayChunkGridTraversal' in 'Raygen.comp', they must be kept in sync.
+ * The grid spans the chunks [gridOrigin, gridOrigin + gridSize).
+ *
+ * @tparam TVisitor A callable with the signature 'bool(const glm::ivec3& coordinate)'.
+ *
+ * @param rayOrigin The origin of the ray.
+ * @param rayDirection The normalized direction of the ray.
+ * @param minDistance The distance along the ray the traversal starts at, chunks only passed before it are skipped.
+ * @param gridOrigin The coordinate of the first chunk of the grid.
+ * @param gridSize The size of the grid in chunks.
+ * @param visitor Called for every chunk the ray passes through in order. Returning 'true' stops the traversal.
+ *
+ * @return Whether the visitor stopped the traversal.
+ */
+template<typename TVisitor>
+auto TraverseChunkGrid(
+	const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float minDistance,
+	const glm::ivec3& gridOrigin, const glm::ivec3& gridSize,
+	TVisitor&& visitor) -> bool
+{
+	constexpr float chunkSize = static_cast<float>(Chunk::Size);
+
+	glm::vec3 boundsMin = glm::vec3(gridOrigin) * chunkSize;
+	glm::vec3 boundsMax = boundsMin + glm::vec3(gridSize) * chunkSize;
+
+	glm::vec2 gridIntersectTest = RayBoxIntersection(rayOrigin, rayDirection, boundsMin, boundsMax);
+	gridIntersectTest.x = glm::max(gridIntersectTest.x, minDistance);
+	if(gridIntersectTest.y < 0.0f || gridIntersectTest.x > gridIntersectTest.y)
+	{
+		return false;
+	}
+
+	glm::vec3 entryPoint = rayOrigin + rayDirection * gridIntersectTest.x;
+	glm::ivec3 cell = glm::clamp(
+		glm::ivec3(glm::floor(entryPoint / chunkSize)),
+		gridOrigin,
+		gridOrigin + gridSize - 1);
+
+	glm::ivec3 stepDirection = glm::ivec3(glm::sign(rayDirection));
+
+	// The distance between two cell borders and the distance to the next border along each axis.
+	glm::vec3 deltaDistance;
+	glm::vec3 nextDistance;
+	for(glm::length_t i = 0; i < 3; ++i)
+	{
+		if(stepDirection[i] == 0)
+		{
+			deltaDistance[i] = std::numeric_limits<float>::infinity();
+			nextDistance[i] = std::numeric_limits<float>::infinity();
+
+			continue;
+		}
+
+		deltaDistance[i] = std::abs(chunkSize / rayDirection[i]);
+		nextDistance[i] = (static_cast<float>(cell[i] + glm::max(stepDirection[i], 0)) * chunkSize - rayOrigin[i]) / rayDirection[i];
+	}
+
+	while(true)
+	{
+		glm::ivec3 localCell = cell - gridOrigin;
+		if(glm::any(glm::lessThan(localCell, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(localCell, gridSize)))
+		{
+			return false;
+		}
+
+		if(visitor(cell))
+		{
+			return true;
+		}
+
+		if(glm::min(glm::min(nextDistance.x, nextDistance.y), nextDistance.z) > gridIntersectTest.y)
+		{
+			return false;
+		}
+
+		glm::length_t axis = (nextDistance.x < nextDistance.y)
+			? ((nextDistance.x < nextDistance.z) ? 0 : 2)
+			: ((nextDistance.y < nextDistance.z) ? 1 : 2);
+
+		nextDistance[axis] += deltaDistance[axis];
+		cell[axis] += stepDirection[axis];
+	}
+}
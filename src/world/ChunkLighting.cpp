@@ -0,0 +1,259 @@
+#include "ChunkLighting.h"
+
+#include "../utility/Profiler.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace
+{
+	constexpr int32_t Size = static_cast<int32_t>(Chunk::Size);
+
+	/**
+	 * @brief The side of the solid mask, the chunk with a border of one voxel taken from its neighbours.
+	 */
+	constexpr int32_t PaddedSize = Size + 2;
+
+	/**
+	 * @brief The horizontal directions the horizon is searched in.
+	 */
+	constexpr std::array<glm::ivec2, 8u> HorizonDirections = {
+		glm::ivec2(1, 0),
+		glm::ivec2(1, 1),
+		glm::ivec2(0, 1),
+		glm::ivec2(-1, 1),
+		glm::ivec2(-1, 0),
+		glm::ivec2(-1, -1),
+		glm::ivec2(0, -1),
+		glm::ivec2(1, -1),
+	};
+
+	constexpr std::array<glm::ivec3, 6u> FaceDirections = {
+		glm::ivec3(-1, 0, 0),
+		glm::ivec3(1, 0, 0),
+		glm::ivec3(0, -1, 0),
+		glm::ivec3(0, 1, 0),
+		glm::ivec3(0, 0, -1),
+		glm::ivec3(0, 0, 1),
+	};
+
+	[[nodiscard]] auto GetPaddedIndex(const glm::ivec3& coordinate) noexcept -> size_t
+	{
+		return static_cast<size_t>(((coordinate.z + 1) * PaddedSize + coordinate.y + 1) * PaddedSize + coordinate.x + 1);
+	}
+
+	/**
+	 * @brief Copies the voxels of a neighbour touching the chunk into the border of the solid mask.
+	 *
+	 * @param neighbour The neighbouring chunk.
+	 * @param direction The direction of the neighbour from the chunk.
+	 * @param voxels Scratch space for Chunk::Size^3 values.
+	 * @param solid The solid mask of the chunk.
+	 */
+	auto CopyNeighbour(const Chunk& neighbour, const glm::ivec3& direction, std::span<uint8_t> voxels, std::span<uint8_t> solid) -> void
+	{
+		// The range of the mask covered by the neighbour along each axis, a single layer for the axes it is offset along
+		glm::ivec3 first = glm::ivec3(0);
+		glm::ivec3 last = glm::ivec3(Size - 1);
+		for(glm::length_t axis = 0; axis < 3; ++axis)
+		{
+			if(direction[axis] != 0)
+			{
+				first[axis] = (direction[axis] < 0) ? -1 : Size;
+				last[axis] = first[axis];
+			}
+		}
+
+		// Only faces touch enough voxels to be worth extracting, edges and corners are looked up one by one
+		bool isFace = glm::abs(direction.x) + glm::abs(direction.y) + glm::abs(direction.z) == 1;
+		if(isFace && !neighbour.IsUniform())
+		{
+			neighbour.Extract(voxels);
+		}
+
+		for(int32_t z = first.z; z <= last.z; ++z)
+		{
+			for(int32_t y = first.y; y <= last.y; ++y)
+			{
+				for(int32_t x = first.x; x <= last.x; ++x)
+				{
+					glm::ivec3 coordinate = glm::ivec3(x, y, z);
+					glm::uvec3 neighbourCoordinate = glm::uvec3(coordinate - direction * Size);
+
+					uint8_t value = neighbour.IsUniform()
+						? neighbour.GetUniformValue()
+						: (isFace
+							? voxels[(neighbourCoordinate.z * Chunk::Size + neighbourCoordinate.y) * Chunk::Size + neighbourCoordinate.x]
+							: neighbour.Get(neighbourCoordinate));
+
+					solid[GetPaddedIndex(coordinate)] = value != 0u;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Estimates how much of the sky is visible from the top of a voxel.
+	 *
+	 * @param input The surroundings of the chunk.
+	 * @param coordinate The coordinate of the voxel in the chunk.
+	 *
+	 * @return The visible portion of the sky between 0 and 1.
+	 */
+	[[nodiscard]] auto GetSkyVisibility(const ChunkLightingInput& input, const glm::ivec3& coordinate) -> float
+	{
+		float top = static_cast<float>(input.BaseHeight + coordinate.y + 1);
+
+		float visibility = 0.0f;
+		for(const glm::ivec2& direction : HorizonDirections)
+		{
+			float stepLength = glm::length(glm::vec2(direction));
+
+			// The steepest slope to the columns along the direction is the horizon
+			float maxSlope = 0.0f;
+			for(int32_t step = 1; step <= SkyOcclusionRadius; ++step)
+			{
+				glm::ivec2 column = glm::ivec2(coordinate.x, coordinate.z) + direction * step + SkyOcclusionRadius;
+				int32_t height = input.SkyHeights[static_cast<size_t>(column.y * ChunkLightingInput::SkyHeightsSize + column.x)];
+
+				maxSlope = glm::max(maxSlope, (static_cast<float>(height) - top) / (static_cast<float>(step) * stepLength));
+			}
+
+			// The cosine weighted part of the sky above a horizon at angle a is 1 - sin(a)
+			visibility += 1.0f - maxSlope / std::sqrt(1.0f + maxSlope * maxSlope);
+		}
+
+		return visibility / static_cast<float>(HorizonDirections.size());
+	}
+
+	/**
+	 * @brief Calculates the occlusion of the corners of a voxel.
+	 *
+	 * @param solid The solid mask of the chunk.
+	 * @param coordinate The coordinate of the voxel in the chunk.
+	 *
+	 * @return The occlusion of the corners, 2 bits each from 0 for the darkest to 3 for unoccluded.
+	 */
+	[[nodiscard]] auto GetCornerOcclusion(std::span<const uint8_t> solid, const glm::ivec3& coordinate) -> uint16_t
+	{
+		uint16_t occlusion = 0u;
+		for(uint32_t corner = 0u; corner < 8u; ++corner)
+		{
+			glm::ivec3 cornerOffset = glm::ivec3(corner & 1u, (corner >> 1u) & 1u, (corner >> 2u) & 1u);
+
+			// The voxel itself is one of the 8 sharing the corner, so at most 7 are empty. A flat surface leaves 4 of them empty.
+			int32_t emptyCount = 0;
+			for(uint32_t i = 0u; i < 8u; ++i)
+			{
+				glm::ivec3 offset = glm::ivec3(i & 1u, (i >> 1u) & 1u, (i >> 2u) & 1u);
+
+				emptyCount += solid[GetPaddedIndex(coordinate + cornerOffset + offset - 1)] == 0u;
+			}
+
+			occlusion |= static_cast<uint16_t>(glm::clamp(emptyCount - 1, 0, 3) << (corner * 2u));
+		}
+
+		return occlusion;
+	}
+}
+
+auto GetChunkHeights(const Chunk& chunk) -> ChunkHeights
+{
+	ChunkHeights heights;
+
+	if(chunk.IsUniform())
+	{
+		heights.fill((chunk.GetUniformValue() != 0u) ? static_cast<uint8_t>(Chunk::Size) : 0u);
+
+		return heights;
+	}
+
+	heights.fill(0u);
+
+	// Every stored leaf is solid
+	chunk.ForEachLeaf(
+		[&] (const glm::uvec3& coordinate, uint8_t) -> void
+		{
+			uint8_t& height = heights[coordinate.z * Chunk::Size + coordinate.x];
+			height = glm::max(height, static_cast<uint8_t>(coordinate.y + 1u));
+		});
+
+	return heights;
+}
+
+auto GetChunkLightingSize(const Chunk& chunk) -> size_t
+{
+	return chunk.GetLeafCount() * ChunkLightingStride;
+}
+
+auto BakeChunkLighting(const ChunkLightingInput& input) -> std::vector<uint8_t>
+{
+	PROFILE_SCOPE("BakeChunkLighting");
+
+	constexpr size_t centerIndex = 13u;
+
+	Chunk chunk = *DecompressChunk(*input.Neighbourhood[centerIndex]);
+
+	std::vector<uint8_t> lighting(GetChunkLightingSize(chunk), UnbakedLighting);
+	if(lighting.empty())
+	{
+		return lighting;
+	}
+
+	// The solidity of the chunk's voxels and of the neighbouring ones touching it
+	std::vector<uint8_t> voxels(Chunk::Size * Chunk::Size * Chunk::Size);
+	std::vector<uint8_t> solid(static_cast<size_t>(PaddedSize * PaddedSize * PaddedSize), 0u);
+
+	chunk.ForEachLeaf(
+		[&] (const glm::uvec3& coordinate, uint8_t) -> void
+		{
+			solid[GetPaddedIndex(glm::ivec3(coordinate))] = 1u;
+		});
+
+	for(size_t i = 0u; i < input.Neighbourhood.size(); ++i)
+	{
+		if(i == centerIndex || !input.Neighbourhood[i].has_value())
+		{
+			continue;
+		}
+
+		glm::ivec3 direction = glm::ivec3(
+			static_cast<int32_t>(i % 3u) - 1,
+			static_cast<int32_t>(i / 9u) - 1,
+			static_cast<int32_t>((i / 3u) % 3u) - 1);
+
+		CopyNeighbour(*DecompressChunk(*input.Neighbourhood[i]), direction, voxels, solid);
+	}
+
+	size_t leafIndex = 0u;
+	chunk.ForEachLeaf(
+		[&] (const glm::uvec3& leafCoordinate, uint8_t) -> void
+		{
+			glm::ivec3 coordinate = glm::ivec3(leafCoordinate);
+			std::span<uint8_t> leafLighting = std::span<uint8_t>(lighting).subspan((leafIndex++) * ChunkLightingStride, ChunkLightingStride);
+
+			// Voxels buried on every side can't be seen
+			bool isSurface = std::ranges::any_of(
+				FaceDirections,
+				[&] (const glm::ivec3& direction) -> bool
+				{
+					return solid[GetPaddedIndex(coordinate + direction)] == 0u;
+				});
+
+			if(!isSurface)
+			{
+				return;
+			}
+
+			uint16_t occlusion = GetCornerOcclusion(solid, coordinate);
+
+			leafLighting[0] = static_cast<uint8_t>(std::lround(GetSkyVisibility(input, coordinate) * 255.0f));
+			leafLighting[1] = static_cast<uint8_t>(occlusion & 0xFFu);
+			leafLighting[2] = static_cast<uint8_t>(occlusion >> 8u);
+		});
+
+	return lighting;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Chunk.h"
+#include "ChunkCompression.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief The number of bytes of baked lighting stored for every leaf of a chunk.
+ *
+ * The first byte is the sky visibility, the other two hold the occlusion of the voxel's 8 corners with 2 bits each,
+ * the corners are ordered like the children of an octree node. Matches 'GetLeafLighting' in 'Octree.glsl'.
+ */
+inline constexpr size_t ChunkLightingStride = 3u;
+
+/**
+ * @brief The value of every byte of lighting that wasn't baked yet, fully lit.
+ */
+inline constexpr uint8_t UnbakedLighting = 0xFFu;
+
+/**
+ * @brief The horizontal distance in voxels within which the terrain can hide the sky from a voxel.
+ */
+inline constexpr int32_t SkyOcclusionRadius = 16;
+
+/**
+ * @brief The height above the highest solid voxel of every voxel column of a chunk, 0 if the column is empty.
+ *
+ * Indexed by 'z * Chunk::Size + x'.
+ */
+using ChunkHeights = std::array<uint8_t, Chunk::Size * Chunk::Size>;
+
+/**
+ * @brief Everything the lighting of a chunk depends on, copied so it can be baked on a worker thread.
+ */
+struct ChunkLightingInput
+{
+	/**
+	 * @brief The side of the area covered by @ref SkyHeights.
+	 */
+	static constexpr int32_t SkyHeightsSize = static_cast<int32_t>(Chunk::Size) + 2 * SkyOcclusionRadius;
+
+	/**
+	 * @brief The chunk and its neighbours, indexed by '((dy + 1) * 3 + (dz + 1)) * 3 + (dx + 1)'.
+	 *
+	 * Neighbours which aren't loaded are empty and count as air.
+	 */
+	std::array<std::optional<CompressedChunk>, 27u> Neighbourhood;
+
+	/**
+	 * @brief The height above the highest solid voxel of the voxel columns around the chunk, 0 if the column is empty.
+	 *
+	 * Indexed by '(z + SkyOcclusionRadius) * SkyHeightsSize + x + SkyOcclusionRadius' in the local coordinates of the chunk.
+	 */
+	std::vector<int32_t> SkyHeights;
+
+	/**
+	 * @brief The height of the lowest voxel of the chunk.
+	 */
+	int32_t BaseHeight;
+};
+
+/**
+ * @brief Collects the height of every voxel column of a chunk.
+ *
+ * @param chunk The chunk.
+ *
+ * @return The heights relative to the bottom of the chunk.
+ */
+[[nodiscard]] auto GetChunkHeights(const Chunk& chunk) -> ChunkHeights;
+
+/**
+ * @brief Retrieves the number of bytes of lighting stored with a chunk.
+ *
+ * @param chunk The chunk.
+ *
+ * @return The size of the lighting in bytes, 0 for uniform chunks.
+ */
+[[nodiscard]] auto GetChunkLightingSize(const Chunk& chunk) -> size_t;
+
+/**
+ * @brief Computes the sky visibility and the corner occlusion of the surface voxels of a chunk.
+ *
+ * The sky visibility is estimated from the horizon of the surrounding voxel columns in 8 directions.
+ * A corner is occluded by the solid voxels among the 8 voxels sharing it. Voxels without an exposed face are left unbaked.
+ *
+ * @param input The chunk and its surroundings.
+ *
+ * @return The lighting of every leaf in storage order, @ref ChunkLightingStride bytes each.
+ */
+[[nodiscard]] auto BakeChunkLighting(const ChunkLightingInput& input) -> std::vector<uint8_t>;
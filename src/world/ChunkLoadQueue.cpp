@@ -0,0 +1,85 @@
+#include "ChunkLoadQueue.h"
+
+#include <algorithm>
+
+auto ChunkLoadQueue::Push(const glm::ivec3& coordinate, float priority) -> void
+{
+	auto [it, isInserted] = m_entries.try_emplace(coordinate);
+	if(!isInserted && it->second.Priority == priority)
+	{
+		return;
+	}
+
+	it->second = Entry{
+		.Priority = priority,
+		.Generation = ++m_generation,
+	};
+
+	m_heap.push_back(
+		HeapEntry{
+			.Priority = priority,
+			.Coordinate = coordinate,
+			.Generation = m_generation,
+		});
+	std::push_heap(m_heap.begin(), m_heap.end());
+}
+
+auto ChunkLoadQueue::Pop() -> std::optional<glm::ivec3>
+{
+	while(!m_heap.empty())
+	{
+		std::pop_heap(m_heap.begin(), m_heap.end());
+		HeapEntry top = m_heap.back();
+		m_heap.pop_back();
+
+		// Skip the entries that were removed or pushed again since.
+		auto it = m_entries.find(top.Coordinate);
+		if(it == m_entries.end() || it->second.Generation != top.Generation)
+		{
+			continue;
+		}
+
+		m_entries.erase(it);
+
+		return top.Coordinate;
+	}
+
+	return std::nullopt;
+}
+
+auto ChunkLoadQueue::Remove(const glm::ivec3& coordinate) -> void
+{
+	m_entries.erase(coordinate);
+}
+
+auto ChunkLoadQueue::Reprioritize(const PriorityFunction& priority) -> void
+{
+	m_heap.clear();
+
+	for(auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		std::optional<float> newPriority = priority(it->first);
+		if(!newPriority.has_value())
+		{
+			it = m_entries.erase(it);
+
+			continue;
+		}
+
+		it->second = Entry{
+			.Priority = *newPriority,
+			.Generation = ++m_generation,
+		};
+
+		m_heap.push_back(
+			HeapEntry{
+				.Priority = *newPriority,
+				.Coordinate = it->first,
+				.Generation = m_generation,
+			});
+
+		++it;
+	}
+
+	std::make_heap(m_heap.begin(), m_heap.end());
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A priority queue of chunk coordinates waiting to be loaded.
+ *
+ * Membership tests are O(1). Re-pushing or removing a coordinate leaves a stale heap entry behind, which is skipped when it reaches the top.
+ */
+class ChunkLoadQueue
+{
+public:
+	/**
+	 * @brief Computes the priority of a chunk. Lower values are loaded first, 'std::nullopt' removes the chunk from the queue.
+	 */
+	using PriorityFunction = std::function<std::optional<float>(const glm::ivec3&)>;
+
+	/**
+	 * @brief Adds a chunk to the queue or changes its priority if it is already queued.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param priority The priority of the chunk. Lower values are loaded first.
+	 */
+	auto Push(const glm::ivec3& coordinate, float priority) -> void;
+
+	/**
+	 * @brief Removes the most important chunk from the queue.
+	 *
+	 * @return The coordinate of the chunk or 'std::nullopt' if the queue is empty.
+	 */
+	auto Pop() -> std::optional<glm::ivec3>;
+
+	/**
+	 * @brief Removes a chunk from the queue.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 */
+	auto Remove(const glm::ivec3& coordinate) -> void;
+
+	/**
+	 * @brief Recomputes the priority of every queued chunk and drops the ones that are no longer needed.
+	 *
+	 * @param priority Computes the new priorities.
+	 */
+	auto Reprioritize(const PriorityFunction& priority) -> void;
+
+	/**
+	 * @brief Retrieves whether a chunk is queued.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return 'true' if the chunk is queued, otherwise 'false'.
+	 */
+	[[nodiscard]] auto Contains(const glm::ivec3& coordinate) const noexcept -> bool
+	{
+		return m_entries.contains(coordinate);
+	}
+
+	/**
+	 * @brief Retrieves the number of queued chunks.
+	 *
+	 * @return The number of queued chunks.
+	 */
+	[[nodiscard]] auto GetSize() const noexcept -> size_t
+	{
+		return m_entries.size();
+	}
+
+	/**
+	 * @brief Retrieves whether the queue is empty.
+	 *
+	 * @return 'true' if no chunks are queued, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsEmpty() const noexcept -> bool
+	{
+		return m_entries.empty();
+	}
+
+private:
+	struct HeapEntry
+	{
+		float Priority;
+		glm::ivec3 Coordinate;
+		uint32_t Generation;
+
+		[[nodiscard]] auto operator<(const HeapEntry& other) const noexcept -> bool
+		{
+			// The standard heap is a max-heap, so the comparison is reversed.
+			return Priority > other.Priority;
+		}
+	};
+
+	struct Entry
+	{
+		float Priority;
+		uint32_t Generation;
+	};
+
+	std::vector<HeapEntry> m_heap;
+	std::unordered_map<glm::ivec3, Entry> m_entries;
+	uint32_t m_generation = 0u;
+};
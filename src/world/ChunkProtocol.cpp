@@ -0,0 +1,203 @@
+#include "ChunkProtocol.h"
+
+#include "../utility/Socket.h"
+
+#include <bit>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+	static_assert(std::endian::native == std::endian::little, "The protocol is written in the native byte order");
+
+	/**
+	 * @brief The size of the payload size and the message type in bytes.
+	 */
+	constexpr size_t HeaderSize = 5u;
+
+	/**
+	 * @brief Rejects frames from a broken peer before allocating them.
+	 */
+	constexpr uint32_t MaxPayloadSize = 16u * 1024u * 1024u;
+
+	/**
+	 * @brief Appends the bytes of a value to a buffer.
+	 *
+	 * @param buffer The buffer.
+	 * @param value The value.
+	 */
+	template<typename T>
+	auto Write(std::vector<uint8_t>& buffer, const T& value) -> void
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		std::memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	/**
+	 * @brief Reads a value from the front of a buffer and advances it.
+	 *
+	 * @param buffer The remaining bytes.
+	 * @param value Receives the value.
+	 *
+	 * @return 'false' if the buffer is too short, otherwise 'true'.
+	 */
+	template<typename T>
+	auto Read(std::span<const uint8_t>& buffer, T& value) -> bool
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		if(buffer.size() < sizeof(T))
+		{
+			return false;
+		}
+
+		std::memcpy(&value, buffer.data(), sizeof(T));
+		buffer = buffer.subspan(sizeof(T));
+
+		return true;
+	}
+
+	auto WritePayload(std::vector<uint8_t>& buffer, const ChunkRequestMessage& message) -> void
+	{
+		Write(buffer, message.Id);
+		Write(buffer, message.Coordinate);
+		Write(buffer, message.Priority);
+	}
+
+	auto WritePayload(std::vector<uint8_t>& buffer, const ChunkCancelMessage& message) -> void
+	{
+		Write(buffer, message.Id);
+	}
+
+	auto WritePayload(std::vector<uint8_t>& buffer, const ChunkDataMessage& message) -> void
+	{
+		Write(buffer, message.Id);
+		Write(buffer, message.Chunk.NodeCount);
+		Write(buffer, message.Chunk.UniformValue);
+		buffer.insert(buffer.end(), message.Chunk.Data.begin(), message.Chunk.Data.end());
+	}
+
+	auto WritePayload(std::vector<uint8_t>& buffer, const ChunkHelloMessage& message) -> void
+	{
+		Write(buffer, message.Seed);
+		Write(buffer, message.Height);
+	}
+
+	auto WritePayload(std::vector<uint8_t>& buffer, const ChunkEditMessage& message) -> void
+	{
+		Write(buffer, message.Coordinate);
+		Write(buffer, message.Chunk.NodeCount);
+		Write(buffer, message.Chunk.UniformValue);
+		buffer.insert(buffer.end(), message.Chunk.Data.begin(), message.Chunk.Data.end());
+	}
+
+	auto ReadPayload(std::span<const uint8_t> buffer, int32_t height, ChunkRequestMessage& message) -> bool
+	{
+		if(!Read(buffer, message.Id) || !Read(buffer, message.Coordinate) || !Read(buffer, message.Priority) || !buffer.empty())
+		{
+			return false;
+		}
+
+		// The priority indexes the job queues and the height the chunk columns, a broken peer mustn't reach past them
+		return message.Priority <= JobPriority::Low && message.Coordinate.y >= 0 && message.Coordinate.y < height;
+	}
+
+	auto ReadPayload(std::span<const uint8_t> buffer, int32_t, ChunkCancelMessage& message) -> bool
+	{
+		return Read(buffer, message.Id) && buffer.empty();
+	}
+
+	auto ReadPayload(std::span<const uint8_t> buffer, int32_t, ChunkDataMessage& message) -> bool
+	{
+		if(!Read(buffer, message.Id) || !Read(buffer, message.Chunk.NodeCount) || !Read(buffer, message.Chunk.UniformValue))
+		{
+			return false;
+		}
+
+		message.Chunk.Data.assign(buffer.begin(), buffer.end());
+
+		return true;
+	}
+
+	auto ReadPayload(std::span<const uint8_t> buffer, int32_t, ChunkHelloMessage& message) -> bool
+	{
+		return Read(buffer, message.Seed) && Read(buffer, message.Height) && buffer.empty();
+	}
+
+	auto ReadPayload(std::span<const uint8_t> buffer, int32_t height, ChunkEditMessage& message) -> bool
+	{
+		if(!Read(buffer, message.Coordinate) || !Read(buffer, message.Chunk.NodeCount) || !Read(buffer, message.Chunk.UniformValue))
+		{
+			return false;
+		}
+
+		message.Chunk.Data.assign(buffer.begin(), buffer.end());
+
+		return message.Coordinate.y >= 0 && message.Coordinate.y < height;
+	}
+
+	/**
+	 * @brief Creates the alternative of a message variant by its index.
+	 *
+	 * @param index The index of the alternative.
+	 *
+	 * @return The default constructed alternative or 'std::nullopt' if the index is out of range.
+	 */
+	template<size_t I = 0u>
+	auto CreateMessage(size_t index) -> std::optional<ChunkMessage>
+	{
+		if constexpr(I < std::variant_size_v<ChunkMessage>)
+		{
+			return (index == I) ? std::optional<ChunkMessage>(std::in_place, std::in_place_index<I>) : CreateMessage<I + 1u>(index);
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+}
+
+auto SendChunkMessage(Socket& socket, const ChunkMessage& message) -> size_t
+{
+	std::vector<uint8_t> buffer(HeaderSize);
+	std::visit([&] (const auto& alternative) -> void { WritePayload(buffer, alternative); }, message);
+
+	uint32_t payloadSize = static_cast<uint32_t>(buffer.size() - HeaderSize);
+	std::memcpy(buffer.data(), &payloadSize, sizeof(payloadSize));
+	buffer[4] = static_cast<uint8_t>(message.index());
+
+	return socket.Send(buffer) ? buffer.size() : 0u;
+}
+
+auto ReceiveChunkMessage(Socket& socket, int32_t height) -> std::optional<ChunkMessage>
+{
+	uint8_t header[HeaderSize];
+	if(!socket.Receive(header))
+	{
+		return std::nullopt;
+	}
+
+	uint32_t payloadSize;
+	std::memcpy(&payloadSize, header, sizeof(payloadSize));
+
+	std::optional<ChunkMessage> message = CreateMessage(header[4]);
+	if(!message.has_value() || payloadSize > MaxPayloadSize)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<uint8_t> payload(payloadSize);
+	if(!socket.Receive(payload))
+	{
+		return std::nullopt;
+	}
+
+	bool isValid = std::visit([&] (auto& alternative) -> bool { return ReadPayload(payload, height, alternative); }, *message);
+
+	return isValid ? message : std::nullopt;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "ChunkCompression.h"
+#include "../utility/JobSystem.h"
+
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+#include <glm/glm.hpp>
+
+class Socket;
+
+/**
+ * @brief The default port of the chunk server.
+ */
+constexpr uint16_t DefaultChunkServerPort = 27015u;
+
+/**
+ * @brief Asks the server for a chunk.
+ *
+ * Encoded as the id, the coordinate and the priority, 21 bytes.
+ */
+struct ChunkRequestMessage
+{
+	/**
+	 * @brief Chosen by the client, echoed by the answer.
+	 */
+	uint64_t Id;
+
+	glm::ivec3 Coordinate;
+	JobPriority Priority;
+};
+
+/**
+ * @brief Tells the server a requested chunk is no longer needed.
+ *
+ * Encoded as the id of the request, 8 bytes. A request that is already being generated may still be answered.
+ */
+struct ChunkCancelMessage
+{
+	uint64_t Id;
+};
+
+/**
+ * @brief Answers a request with the compressed chunk.
+ *
+ * Encoded as the id of the request, the node count, the uniform value and the compressed data.
+ */
+struct ChunkDataMessage
+{
+	uint64_t Id;
+	CompressedChunk Chunk;
+};
+
+/**
+ * @brief Sent by the server right after accepting a client, describes the world it generates.
+ *
+ * Encoded as the seed and the height, 8 bytes.
+ */
+struct ChunkHelloMessage
+{
+	int32_t Seed;
+
+	/**
+	 * @brief The height of the world in chunks.
+	 */
+	int32_t Height;
+};
+
+/**
+ * @brief Sends a chunk edited by the client to the server, which serves it instead of the generated one from then on.
+ *
+ * Encoded as the coordinate, the node count, the uniform value and the compressed data.
+ */
+struct ChunkEditMessage
+{
+	glm::ivec3 Coordinate;
+	CompressedChunk Chunk;
+};
+
+/**
+ * @brief Any message of the chunk protocol.
+ *
+ * Every message is framed by a 5 byte header, the size of the payload as a little endian 32-bit integer followed by the index of the message's type in this variant.
+ */
+using ChunkMessage = std::variant<ChunkRequestMessage, ChunkCancelMessage, ChunkDataMessage, ChunkHelloMessage, ChunkEditMessage>;
+
+/**
+ * @brief Encodes and sends a message.
+ *
+ * @param socket The connected socket.
+ * @param message The message.
+ *
+ * @return The number of sent bytes or 0 if the connection was closed.
+ */
+auto SendChunkMessage(Socket& socket, const ChunkMessage& message) -> size_t;
+
+/**
+ * @brief Waits for the next message and decodes it.
+ *
+ * @param socket The connected socket.
+ * @param height The height of the world in chunks, requests and edits above it or requests with an unknown priority are malformed.
+ *
+ * @return The message or 'std::nullopt' if the connection was closed or the message is malformed.
+ */
+[[nodiscard]] auto ReceiveChunkMessage(Socket& socket, int32_t height) -> std::optional<ChunkMessage>;
@@ -0,0 +1,290 @@
+#include "ChunkServer.h"
+
+#include "ChunkProtocol.h"
+#include "World.h"
+#include "../utility/Config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+ChunkServer::ChunkServer(const ChunkServerSettings& settings, const WorldSettings& worldSettings)
+	: m_settings(settings), m_seed(worldSettings.Seed), m_height(worldSettings.Height), m_cache(settings.CacheSize),
+	m_store(settings.SaveDirectory.empty() ? std::filesystem::path() : settings.SaveDirectory / std::to_string(worldSettings.Seed))
+{
+	if(m_store.GetCount() > 0u)
+	{
+		printf("Loaded %zu edited chunks\n", m_store.GetCount());
+	}
+
+	m_generator = std::make_unique<WorldGenerator>(
+		worldSettings.Seed,
+		worldSettings.Height * static_cast<int32_t>(Chunk::Size),
+		worldSettings.HeightmapCacheSize);
+}
+
+ChunkServer::~ChunkServer()
+{
+	m_isStopping = true;
+
+	// Closing a listening socket doesn't wake up 'accept' everywhere, a last connection does.
+	if(m_acceptor.joinable())
+	{
+		Socket wakeUp = Socket::Connect("127.0.0.1", m_settings.Port);
+		m_listener.Shutdown();
+
+		m_acceptor.join();
+	}
+
+	std::scoped_lock lock(m_connectionMutex);
+	for(const std::unique_ptr<Connection>& connection : m_connections)
+	{
+		connection->Client.Shutdown();
+	}
+
+	for(const std::unique_ptr<Connection>& connection : m_connections)
+	{
+		connection->Reader.join();
+	}
+}
+
+auto ChunkServer::Start() -> bool
+{
+	m_listener = Socket::Listen(m_settings.Port);
+	if(!m_listener.IsValid())
+	{
+		return false;
+	}
+
+	m_acceptor = std::thread(&ChunkServer::AcceptClients, this);
+
+	return true;
+}
+
+auto ChunkServer::GetStatistics() const -> ChunkServerStatistics
+{
+	size_t clientCount = 0u;
+	{
+		std::scoped_lock lock(m_connectionMutex);
+
+		clientCount = static_cast<size_t>(std::ranges::count_if(
+			m_connections,
+			[] (const std::unique_ptr<Connection>& connection) -> bool
+			{
+				return !connection->IsClosed;
+			}));
+	}
+
+	return ChunkServerStatistics{
+		.ClientCount = clientCount,
+		.RequestCount = m_requestCount,
+		.GeneratedChunkCount = m_generatedChunkCount,
+		.CacheHitCount = m_cacheHitCount,
+		.EditCount = m_editCount,
+		.SentSize = m_sentSize,
+	};
+}
+
+auto ChunkServer::AcceptClients() -> void
+{
+	while(!m_isStopping)
+	{
+		Socket client = m_listener.Accept();
+		if(!client.IsValid() || m_isStopping)
+		{
+			continue;
+		}
+
+		std::scoped_lock lock(m_connectionMutex);
+
+		// Forget the clients that left
+		std::erase_if(
+			m_connections,
+			[] (std::unique_ptr<Connection>& connection) -> bool
+			{
+				if(!connection->IsClosed)
+				{
+					return false;
+				}
+
+				connection->Reader.join();
+
+				return true;
+			});
+
+		Connection& connection = *m_connections.emplace_back(std::make_unique<Connection>());
+		connection.Client = std::move(client);
+
+		// Sent before the reader starts, nothing else can send to the client yet
+		SendChunkMessage(connection.Client, ChunkHelloMessage{ .Seed = m_seed, .Height = m_height });
+
+		connection.Reader = std::thread(&ChunkServer::ServeClient, this, std::ref(connection));
+	}
+}
+
+auto ChunkServer::ServeClient(Connection& connection) -> void
+{
+	while(std::optional<ChunkMessage> message = ReceiveChunkMessage(connection.Client, m_height))
+	{
+		if(const auto* request = std::get_if<ChunkRequestMessage>(&*message))
+		{
+			HandleRequest(connection, *request);
+		}
+		else if(const auto* cancel = std::get_if<ChunkCancelMessage>(&*message))
+		{
+			std::scoped_lock lock(connection.PendingMutex);
+
+			if(auto it = connection.PendingChunks.find(cancel->Id); it != connection.PendingChunks.end())
+			{
+				it->second.Cancellation.Cancel();
+			}
+		}
+		else if(auto* edit = std::get_if<ChunkEditMessage>(&*message))
+		{
+			// A broken client is dropped, its chunk would break every other client
+			if(!HandleEdit(*edit))
+			{
+				printf("A client sent a malformed chunk\n");
+
+				break;
+			}
+		}
+	}
+
+	// The jobs refer to the connection, so they have to finish before it goes away.
+	std::vector<JobHandle> handles;
+	{
+		std::scoped_lock lock(connection.PendingMutex);
+
+		for(auto& [id, pendingChunk] : connection.PendingChunks)
+		{
+			pendingChunk.Cancellation.Cancel();
+			handles.push_back(pendingChunk.Handle);
+		}
+	}
+
+	for(const JobHandle& handle : handles)
+	{
+		JobSystem::Wait(handle);
+	}
+
+	connection.Client.Shutdown();
+	connection.IsClosed = true;
+}
+
+auto ChunkServer::HandleRequest(Connection& connection, const ChunkRequestMessage& request) -> void
+{
+	++m_requestCount;
+
+	std::optional<CompressedChunk> cachedChunk;
+	{
+		std::scoped_lock lock(m_cacheMutex);
+
+		if(const CompressedChunk* storedChunk = m_store.Find(request.Coordinate))
+		{
+			cachedChunk = *storedChunk;
+		}
+		else
+		{
+			// Taken and stored again to mark it as recently used
+			cachedChunk = m_cache.Take(request.Coordinate);
+			if(cachedChunk.has_value())
+			{
+				m_cache.Store(request.Coordinate, *cachedChunk);
+			}
+		}
+	}
+
+	if(cachedChunk.has_value())
+	{
+		++m_cacheHitCount;
+
+		SendChunk(connection, request.Id, std::move(*cachedChunk));
+
+		return;
+	}
+
+	std::scoped_lock lock(connection.PendingMutex);
+
+	CancellationToken cancellation;
+	JobHandle handle = m_generator->Schedule(
+		request.Coordinate,
+		request.Priority,
+		cancellation,
+		[this, &connection, id = request.Id, coordinate = request.Coordinate] (Chunk&& chunk) -> void
+		{
+			CompressedChunk compressedChunk = CompressChunk(chunk);
+
+			++m_generatedChunkCount;
+
+			{
+				std::scoped_lock lock(m_cacheMutex);
+
+				// An edit that arrived during the generation wins over the generated chunk
+				if(const CompressedChunk* storedChunk = m_store.Find(coordinate))
+				{
+					compressedChunk = *storedChunk;
+				}
+				else
+				{
+					m_cache.Store(coordinate, compressedChunk);
+				}
+			}
+
+			SendChunk(connection, id, std::move(compressedChunk));
+		});
+
+	JobHandle cleanup = JobSystem::Then(
+		handle,
+		[&connection, id = request.Id] () -> void
+		{
+			std::scoped_lock lock(connection.PendingMutex);
+
+			connection.PendingChunks.erase(id);
+		},
+		request.Priority);
+
+	connection.PendingChunks.insert_or_assign(
+		request.Id,
+		PendingChunk{
+			.Handle = std::move(cleanup),
+			.Cancellation = std::move(cancellation),
+		});
+}
+
+auto ChunkServer::HandleEdit(const ChunkEditMessage& edit) -> bool
+{
+	if(!DecompressChunk(edit.Chunk).has_value())
+	{
+		return false;
+	}
+
+	++m_editCount;
+
+	std::scoped_lock lock(m_cacheMutex);
+
+	m_store.Store(edit.Coordinate, edit.Chunk);
+
+	return true;
+}
+
+auto ChunkServer::SendChunk(Connection& connection, uint64_t id, CompressedChunk chunk) -> void
+{
+	std::scoped_lock lock(connection.SendMutex);
+
+	m_sentSize += SendChunkMessage(
+		connection.Client,
+		ChunkDataMessage{
+			.Id = id,
+			.Chunk = std::move(chunk),
+		});
+}
+
+auto ChunkServerSettings::LoadFromConfig() -> ChunkServerSettings
+{
+	return ChunkServerSettings{
+		.Port = static_cast<uint16_t>(std::clamp<int64_t>(Config::Get<int64_t>("server", "iPort"), 1, 65535)),
+		.CacheSize = static_cast<size_t>(std::max<int64_t>(Config::Get<int64_t>("server", "iCacheSize"), 0)),
+		.SaveDirectory = Config::Get<std::string>("server", "sSaveDirectory"),
+	};
+}
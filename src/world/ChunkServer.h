@@ -0,0 +1,224 @@
+#pragma once
+
+#include "ChunkCache.h"
+#include "ChunkProtocol.h"
+#include "ChunkStore.h"
+#include "WorldGenerator.h"
+#include "../utility/JobSystem.h"
+#include "../utility/Socket.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct WorldSettings;
+
+/**
+ * @brief Holds settings related to the chunk server.
+ */
+struct ChunkServerSettings
+{
+	/**
+	 * @brief The loopback port the server listens on.
+	 */
+	uint16_t Port;
+
+	/**
+	 * @brief The maximum size of the generated chunks kept for later requests in bytes.
+	 */
+	size_t CacheSize;
+
+	/**
+	 * @brief The directory the edited chunks are saved to, in a subdirectory per seed. Empty to keep the edits in memory only.
+	 */
+	std::filesystem::path SaveDirectory;
+
+	/**
+	 * @brief Loads the settings from the config file.
+	 *
+	 * @return The settings loaded from the file.
+	 */
+	static auto LoadFromConfig() -> ChunkServerSettings;
+};
+
+/**
+ * @brief Counts the work of a chunk server.
+ */
+struct ChunkServerStatistics
+{
+	size_t ClientCount;
+	uint64_t RequestCount;
+	uint64_t GeneratedChunkCount;
+
+	/**
+	 * @brief The number of requests answered from the cache.
+	 */
+	uint64_t CacheHitCount;
+
+	/**
+	 * @brief The number of edited chunks received from the clients.
+	 */
+	uint64_t EditCount;
+	uint64_t SentSize;
+};
+
+/**
+ * @brief Generates chunks for any number of clients connected over a loopback socket.
+ *
+ * Every client has a thread reading its requests, the chunks are generated on the job system and sent from the job that finished them.
+ * Generated chunks are kept compressed, so a chunk requested by several clients is only generated once.
+ * Chunks edited by a client are saved and served instead of the generated ones, clients that already loaded the chunk see the edit on their next request.
+ */
+class ChunkServer
+{
+public:
+	/**
+	 * @brief Sets up the generator of the served world.
+	 *
+	 * @param settings The settings of the server.
+	 * @param worldSettings The settings of the served world, it must have a seed, see @ref WorldSettings::GetRandomSeed.
+	 */
+	ChunkServer(const ChunkServerSettings& settings, const WorldSettings& worldSettings);
+
+	/**
+	 * @brief Disconnects every client and waits for the pending chunks.
+	 */
+	~ChunkServer();
+
+	ChunkServer(const ChunkServer&) = delete;
+	auto operator=(const ChunkServer&) -> ChunkServer& = delete;
+
+	/**
+	 * @brief Starts accepting clients.
+	 *
+	 * Every client is sent the seed and the height of the world first.
+	 *
+	 * @return 'false' if the port couldn't be bound, otherwise 'true'.
+	 */
+	auto Start() -> bool;
+
+	[[nodiscard]] auto GetStatistics() const -> ChunkServerStatistics;
+
+	/**
+	 * @brief Retrieves the seed of the served world.
+	 *
+	 * @return The seed.
+	 */
+	[[nodiscard]] auto GetSeed() const noexcept -> int32_t
+	{
+		return m_seed;
+	}
+
+	[[nodiscard]] auto GetGenerator() const noexcept -> const WorldGenerator&
+	{
+		return *m_generator;
+	}
+
+private:
+	/**
+	 * @brief A chunk being generated for a client.
+	 */
+	struct PendingChunk
+	{
+		/**
+		 * @brief The job removing the chunk from the pending ones, which runs after the generation even if it was cancelled.
+		 */
+		JobHandle Handle;
+		CancellationToken Cancellation;
+	};
+
+	/**
+	 * @brief A connected client.
+	 */
+	struct Connection
+	{
+		Socket Client;
+		std::thread Reader;
+
+		/**
+		 * @brief Serializes the messages sent from different jobs.
+		 */
+		std::mutex SendMutex;
+
+		std::mutex PendingMutex;
+		std::unordered_map<uint64_t, PendingChunk> PendingChunks;
+		std::atomic<bool> IsClosed = false;
+	};
+
+	ChunkServerSettings m_settings;
+	std::unique_ptr<WorldGenerator> m_generator;
+
+	int32_t m_seed;
+
+	/**
+	 * @brief The height of the served world in chunks.
+	 */
+	int32_t m_height;
+
+	Socket m_listener;
+	std::thread m_acceptor;
+	std::atomic<bool> m_isStopping = false;
+
+	mutable std::mutex m_connectionMutex;
+	std::vector<std::unique_ptr<Connection>> m_connections;
+
+	/**
+	 * @brief Shared by every client, guarded by its own mutex since the jobs store into it.
+	 */
+	ChunkCache m_cache;
+
+	/**
+	 * @brief The edited chunks, guarded by the cache's mutex. Checked before the cache, it may still hold the generated version.
+	 */
+	ChunkStore m_store;
+	mutable std::mutex m_cacheMutex;
+
+	std::atomic<uint64_t> m_requestCount = 0u;
+	std::atomic<uint64_t> m_generatedChunkCount = 0u;
+	std::atomic<uint64_t> m_cacheHitCount = 0u;
+	std::atomic<uint64_t> m_editCount = 0u;
+	std::atomic<uint64_t> m_sentSize = 0u;
+
+	/**
+	 * @brief Accepts clients until the server stops.
+	 */
+	auto AcceptClients() -> void;
+
+	/**
+	 * @brief Reads the requests of a client until it disconnects, then cancels its chunks.
+	 *
+	 * @param connection The client.
+	 */
+	auto ServeClient(Connection& connection) -> void;
+
+	/**
+	 * @brief Answers a request from the cache or schedules its generation.
+	 *
+	 * @param connection The client.
+	 * @param request The request.
+	 */
+	auto HandleRequest(Connection& connection, const ChunkRequestMessage& request) -> void;
+
+	/**
+	 * @brief Keeps a chunk edited by a client.
+	 *
+	 * @param edit The edit.
+	 *
+	 * @return 'false' if the chunk doesn't decompress, otherwise 'true'.
+	 */
+	auto HandleEdit(const ChunkEditMessage& edit) -> bool;
+
+	/**
+	 * @brief Sends a chunk to a client.
+	 *
+	 * @param connection The client.
+	 * @param id The id of the request.
+	 * @param chunk The compressed chunk.
+	 */
+	auto SendChunk(Connection& connection, uint64_t id, CompressedChunk chunk) -> void;
+};
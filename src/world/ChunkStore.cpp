@@ -0,0 +1,142 @@
+#include "ChunkStore.h"
+
+#include "../utility/IO.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief The size of the node count and the uniform value in front of the compressed data.
+	 */
+	constexpr size_t HeaderSize = sizeof(uint32_t) + sizeof(uint8_t);
+}
+
+ChunkStore::ChunkStore(std::filesystem::path directory)
+	: m_directory(std::move(directory))
+{
+	std::error_code error;
+	if(m_directory.empty() || !std::filesystem::is_directory(m_directory, error))
+	{
+		return;
+	}
+
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(m_directory, error))
+	{
+		std::optional<glm::ivec3> coordinate = ParseFileName(entry.path());
+		if(!coordinate.has_value())
+		{
+			continue;
+		}
+
+		std::vector<uint8_t> data = LoadBinaryFile(entry.path());
+
+		CompressedChunk chunk{
+			.Data = {},
+			.NodeCount = 0u,
+			.UniformValue = 0u,
+		};
+
+		// A file cut short by a crash mustn't reach the clients, they drop servers sending broken chunks
+		if(data.size() >= HeaderSize)
+		{
+			std::memcpy(&chunk.NodeCount, data.data(), sizeof(chunk.NodeCount));
+			chunk.UniformValue = data[sizeof(chunk.NodeCount)];
+			chunk.Data.assign(data.begin() + HeaderSize, data.end());
+		}
+
+		if(data.size() < HeaderSize || !DecompressChunk(chunk).has_value())
+		{
+			printf("Skipped the broken chunk file '%s'\n", entry.path().string().c_str());
+
+			continue;
+		}
+
+		m_chunks.insert_or_assign(*coordinate, std::move(chunk));
+	}
+}
+
+auto ChunkStore::Store(const glm::ivec3& coordinate, CompressedChunk chunk) -> bool
+{
+	CompressedChunk& storedChunk = m_chunks.insert_or_assign(coordinate, std::move(chunk)).first->second;
+
+	if(m_directory.empty())
+	{
+		return true;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+
+	// Written next to the file and moved over it, so a crash leaves either version intact
+	std::filesystem::path path = m_directory / GetFileName(coordinate);
+	std::filesystem::path temporaryPath = std::filesystem::path(path).replace_extension(".tmp");
+	{
+		std::ofstream file(temporaryPath, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(&storedChunk.NodeCount), sizeof(storedChunk.NodeCount));
+		file.write(reinterpret_cast<const char*>(&storedChunk.UniformValue), sizeof(storedChunk.UniformValue));
+		file.write(reinterpret_cast<const char*>(storedChunk.Data.data()), static_cast<std::streamsize>(storedChunk.Data.size()));
+
+		if(!file.good())
+		{
+			printf("Couldn't write the chunk file '%s'\n", temporaryPath.string().c_str());
+
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path, error);
+	if(error)
+	{
+		printf("Couldn't replace the chunk file '%s'\n", path.string().c_str());
+
+		return false;
+	}
+
+	return true;
+}
+
+auto ChunkStore::Find(const glm::ivec3& coordinate) const -> const CompressedChunk*
+{
+	auto it = m_chunks.find(coordinate);
+
+	return it != m_chunks.end() ? &it->second : nullptr;
+}
+
+auto ChunkStore::GetFileName(const glm::ivec3& coordinate) -> std::string
+{
+	return std::to_string(coordinate.x) + "_" + std::to_string(coordinate.y) + "_" + std::to_string(coordinate.z) + ".chunk";
+}
+
+auto ChunkStore::ParseFileName(const std::filesystem::path& path) -> std::optional<glm::ivec3>
+{
+	if(path.extension() != ".chunk")
+	{
+		return std::nullopt;
+	}
+
+	std::string name = path.stem().string();
+	const char* begin = name.data();
+	const char* end = name.data() + name.size();
+
+	glm::ivec3 coordinate;
+	for(int32_t i = 0; i < 3; ++i)
+	{
+		auto [next, error] = std::from_chars(begin, end, coordinate[i]);
+		if(error != std::errc() || (i < 2 && (next == end || *next != '_')))
+		{
+			return std::nullopt;
+		}
+
+		begin = i < 2 ? next + 1 : next;
+	}
+
+	return begin == end ? std::optional<glm::ivec3>(coordinate) : std::nullopt;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ChunkCompression.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+/**
+ * @brief Keeps the chunks edited by the clients of a chunk server and writes them through to a directory.
+ *
+ * Edited chunks replace the generated ones for good, so unlike @ref ChunkCache nothing is ever evicted.
+ * Every chunk is saved to its own file named after its coordinate, the saved chunks are loaded again on construction.
+ */
+class ChunkStore
+{
+public:
+	/**
+	 * @brief Loads the chunks saved in a directory.
+	 *
+	 * Files that don't hold a valid chunk are skipped.
+	 *
+	 * @param directory The directory of the world's chunks, created on the first save. Empty to keep the chunks in memory only.
+	 */
+	explicit ChunkStore(std::filesystem::path directory);
+
+	/**
+	 * @brief Stores a chunk, replacing the previous version of it, and saves it.
+	 *
+	 * The chunk is kept in memory even if it couldn't be saved.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param chunk The compressed chunk, it must decompress.
+	 *
+	 * @return 'false' if the chunk couldn't be saved, otherwise 'true'.
+	 */
+	auto Store(const glm::ivec3& coordinate, CompressedChunk chunk) -> bool;
+
+	/**
+	 * @brief Retrieves a stored chunk.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return A pointer to the compressed chunk or 'nullptr' if it wasn't edited.
+	 */
+	[[nodiscard]] auto Find(const glm::ivec3& coordinate) const -> const CompressedChunk*;
+
+	/**
+	 * @brief Retrieves the number of stored chunks.
+	 *
+	 * @return The number of chunks.
+	 */
+	[[nodiscard]] auto GetCount() const noexcept -> size_t
+	{
+		return m_chunks.size();
+	}
+
+private:
+	std::filesystem::path m_directory;
+	std::unordered_map<glm::ivec3, CompressedChunk> m_chunks;
+
+	/**
+	 * @brief Retrieves the name of a chunk's file.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return The file name, 'x_y_z.chunk'.
+	 */
+	[[nodiscard]] static auto GetFileName(const glm::ivec3& coordinate) -> std::string;
+
+	/**
+	 * @brief Parses the coordinate of a chunk from its file name.
+	 *
+	 * @param path The path of the file.
+	 *
+	 * @return The coordinate or 'std::nullopt' if the file isn't named like a chunk.
+	 */
+	[[nodiscard]] static auto ParseFileName(const std::filesystem::path& path) -> std::optional<glm::ivec3>;
+};
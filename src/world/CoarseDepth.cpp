@@ -0,0 +1,224 @@
+#include "CoarseDepth.h"
+
+#include "../utility/Math.h"
+
+#include <limits>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief The cells of a chunk on its lowest layer along each axis, the highest layer is the same shifted by 3 cells.
+	 */
+	constexpr uint64_t LowX = 0x1111111111111111ull;
+	constexpr uint64_t LowY = 0x000F000F000F000Full;
+	constexpr uint64_t LowZ = 0x000000000000FFFFull;
+
+	[[nodiscard]] constexpr auto GetCellBit(int32_t x, int32_t y, int32_t z) noexcept -> uint64_t
+	{
+		return 1ull << static_cast<uint32_t>((z * CoarseCellsPerChunk + y) * CoarseCellsPerChunk + x);
+	}
+
+	/**
+	 * @brief Dilates the occupancy of a grid along one axis.
+	 *
+	 * @param source The occupancy of the grid.
+	 * @param destination Receives the dilated occupancy.
+	 * @param gridSize The size of the grid in chunks.
+	 * @param axis The axis, 0 for x, 1 for y and 2 for z.
+	 * @param lowLayer The cells on the lowest layer of a chunk along the axis.
+	 * @param shift The distance between the bits of neighbouring cells along the axis.
+	 */
+	auto DilateAxis(
+		std::span<const uint64_t> source,
+		std::span<uint64_t> destination,
+		const glm::ivec3& gridSize,
+		glm::length_t axis,
+		uint64_t lowLayer,
+		uint32_t shift) -> void
+	{
+		uint64_t highLayer = lowLayer << (3u * shift);
+
+		for(int32_t y = 0; y < gridSize.y; ++y)
+		{
+			for(int32_t z = 0; z < gridSize.z; ++z)
+			{
+				for(int32_t x = 0; x < gridSize.x; ++x)
+				{
+					glm::ivec3 coordinate = glm::ivec3(x, y, z);
+
+					auto getOccupancy = [&] (const glm::ivec3& chunkCoordinate) -> uint64_t
+						{
+							if(glm::any(glm::lessThan(chunkCoordinate, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(chunkCoordinate, gridSize)))
+							{
+								return 0u;
+							}
+
+							return source[static_cast<size_t>((chunkCoordinate.y * gridSize.z + chunkCoordinate.z) * gridSize.x + chunkCoordinate.x)];
+						};
+
+					glm::ivec3 offset = glm::ivec3(0);
+					offset[axis] = 1;
+
+					uint64_t occupancy = getOccupancy(coordinate);
+					uint64_t previous = getOccupancy(coordinate - offset);
+					uint64_t next = getOccupancy(coordinate + offset);
+
+					destination[static_cast<size_t>((y * gridSize.z + z) * gridSize.x + x)] =
+						occupancy |
+						((occupancy << shift) & ~lowLayer) |
+						((occupancy >> shift) & ~highLayer) |
+						((previous & highLayer) >> (3u * shift)) |
+						((next & lowLayer) << (3u * shift));
+				}
+			}
+		}
+	}
+}
+
+auto GetCoarseOccupancy(const Chunk& chunk) -> uint64_t
+{
+	if(chunk.IsUniform())
+	{
+		return (chunk.GetUniformValue() != 0u) ? ~0ull : 0ull;
+	}
+
+	std::span<const uint8_t> nodes = chunk.Data();
+
+	// The second level follows the root in the order of the root's children
+	uint64_t occupancy = 0u;
+	size_t nodeIndex = 1u;
+	for(uint32_t childIndex = 0u; childIndex < 8u; ++childIndex)
+	{
+		if(!(nodes[0] & (1u << childIndex)))
+		{
+			continue;
+		}
+
+		glm::ivec3 childOrigin = glm::ivec3(childIndex & 1u, (childIndex >> 1u) & 1u, (childIndex >> 2u) & 1u) * 2;
+
+		uint8_t childMask = nodes[nodeIndex++];
+		for(uint32_t cellIndex = 0u; cellIndex < 8u; ++cellIndex)
+		{
+			if(childMask & (1u << cellIndex))
+			{
+				glm::ivec3 cell = childOrigin + glm::ivec3(cellIndex & 1u, (cellIndex >> 1u) & 1u, (cellIndex >> 2u) & 1u);
+
+				occupancy |= GetCellBit(cell.x, cell.y, cell.z);
+			}
+		}
+	}
+
+	return occupancy;
+}
+
+auto CoarsenOccupancy(uint64_t occupancy) -> uint64_t
+{
+	for(int32_t z = 0; z < CoarseCellsPerChunk; z += 2)
+	{
+		for(int32_t y = 0; y < CoarseCellsPerChunk; y += 2)
+		{
+			for(int32_t x = 0; x < CoarseCellsPerChunk; x += 2)
+			{
+				uint64_t block =
+					GetCellBit(x, y, z) | GetCellBit(x + 1, y, z) | GetCellBit(x, y + 1, z) | GetCellBit(x + 1, y + 1, z) |
+					GetCellBit(x, y, z + 1) | GetCellBit(x + 1, y, z + 1) | GetCellBit(x, y + 1, z + 1) | GetCellBit(x + 1, y + 1, z + 1);
+
+				if(occupancy & block)
+				{
+					occupancy |= block;
+				}
+			}
+		}
+	}
+
+	return occupancy;
+}
+
+auto DilateCoarseOccupancy(std::span<const uint64_t> occupancy, std::span<uint64_t> dilated, const glm::ivec3& gridSize) -> void
+{
+	// The 3*3*3 neighbourhood is separable, so it is dilated along each axis in turn
+	std::vector<uint64_t> scratch(occupancy.size());
+
+	DilateAxis(occupancy, dilated, gridSize, 0, LowX, 1u);
+	DilateAxis(dilated, scratch, gridSize, 1, LowY, static_cast<uint32_t>(CoarseCellsPerChunk));
+	DilateAxis(scratch, dilated, gridSize, 2, LowZ, static_cast<uint32_t>(CoarseCellsPerChunk * CoarseCellsPerChunk));
+}
+
+auto TraceCoarseDistance(
+	const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float sinHalfAngle,
+	const glm::ivec3& gridOrigin, const glm::ivec3& gridSize,
+	std::span<const uint64_t> dilated) -> float
+{
+	constexpr float cellSize = static_cast<float>(CoarseCellSize);
+
+	// The dilation reaches one cell past the grid
+	glm::ivec3 firstCell = gridOrigin * CoarseCellsPerChunk - 1;
+	glm::ivec3 cellCount = gridSize * CoarseCellsPerChunk + 2;
+
+	glm::vec2 boundsIntersectTest = RayBoxIntersection(
+		rayOrigin,
+		rayDirection,
+		glm::vec3(firstCell) * cellSize,
+		glm::vec3(firstCell + cellCount) * cellSize);
+
+	if(boundsIntersectTest.x < 0.0f)
+	{
+		return -1.0f;
+	}
+
+	// Beyond this distance a ray of the bundle may pass further than a cell from the central ray
+	float maxDistance = (sinHalfAngle > 0.0f) ? cellSize / sinHalfAngle : std::numeric_limits<float>::max();
+
+	float distance = boundsIntersectTest.x;
+
+	glm::vec3 entryPoint = rayOrigin + rayDirection * distance;
+	glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor(entryPoint / cellSize)), firstCell, firstCell + cellCount - 1);
+
+	glm::ivec3 stepDirection = glm::ivec3(glm::sign(rayDirection));
+
+	glm::vec3 deltaDistance = glm::abs(glm::vec3(cellSize) / rayDirection);
+	glm::vec3 nextDistance = (glm::vec3(cell + glm::max(stepDirection, glm::ivec3(0))) * cellSize - rayOrigin) / rayDirection;
+	nextDistance = glm::mix(nextDistance, glm::vec3(std::numeric_limits<float>::max()), glm::equal(stepDirection, glm::ivec3(0)));
+
+	glm::ivec3 innerMin = gridOrigin * CoarseCellsPerChunk;
+	glm::ivec3 innerMax = (gridOrigin + gridSize) * CoarseCellsPerChunk - 1;
+
+	while(true)
+	{
+		if(distance > maxDistance)
+		{
+			return maxDistance;
+		}
+
+		glm::ivec3 localCell = cell - firstCell;
+		if(glm::any(glm::lessThan(localCell, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(localCell, cellCount)))
+		{
+			return -1.0f;
+		}
+
+		// The cells around the grid read the closest cell inside, whose neighbourhood covers theirs within the grid
+		glm::ivec3 innerCell = glm::clamp(cell, innerMin, innerMax) - innerMin;
+		glm::ivec3 chunk = innerCell / CoarseCellsPerChunk;
+		glm::ivec3 cellInChunk = innerCell % CoarseCellsPerChunk;
+
+		uint64_t occupancy = dilated[static_cast<size_t>((chunk.y * gridSize.z + chunk.z) * gridSize.x + chunk.x)];
+		if(occupancy & GetCellBit(cellInChunk.x, cellInChunk.y, cellInChunk.z))
+		{
+			return distance;
+		}
+
+		if(glm::min(glm::min(nextDistance.x, nextDistance.y), nextDistance.z) > boundsIntersectTest.y)
+		{
+			return -1.0f;
+		}
+
+		glm::length_t axis = (nextDistance.x < nextDistance.y)
+			? ((nextDistance.x < nextDistance.z) ? 0 : 2)
+			: ((nextDistance.y < nextDistance.z) ? 1 : 2);
+
+		distance = nextDistance[axis];
+		nextDistance[axis] += deltaDistance[axis];
+		cell[axis] += stepDirection[axis];
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Chunk.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief The edge size of the cells of the coarse occupancy in voxels.
+ */
+inline constexpr int32_t CoarseCellSize = 8;
+
+/**
+ * @brief The number of coarse cells along one edge of a chunk.
+ */
+inline constexpr int32_t CoarseCellsPerChunk = static_cast<int32_t>(Chunk::Size) / CoarseCellSize;
+
+/**
+ * @brief Collects which coarse cells of a chunk contain solid voxels.
+ *
+ * The cells are the nodes of the third level of the octree, read from the first two levels.
+ *
+ * @param chunk The chunk.
+ *
+ * @return A bit for every cell, the bit '(z * 4 + y) * 4 + x' belongs to the cell (x, y, z).
+ */
+[[nodiscard]] auto GetCoarseOccupancy(const Chunk& chunk) -> uint64_t;
+
+/**
+ * @brief Extends the occupancy to whole blocks of 2*2*2 cells.
+ *
+ * Chunks traced at a LOD with nodes larger than a cell are hit anywhere in the occupied nodes.
+ *
+ * @param occupancy The occupancy of a chunk.
+ *
+ * @return The occupancy with every block containing an occupied cell filled.
+ */
+[[nodiscard]] auto CoarsenOccupancy(uint64_t occupancy) -> uint64_t;
+
+/**
+ * @brief Marks every cell next to an occupied one, including the diagonal neighbours and across chunk borders.
+ *
+ * @param occupancy The occupancy of every chunk of a grid, indexed like the chunk directory.
+ * @param dilated Receives the dilated occupancy, indexed the same way.
+ * @param gridSize The size of the grid in chunks.
+ */
+auto DilateCoarseOccupancy(std::span<const uint64_t> occupancy, std::span<uint64_t> dilated, const glm::ivec3& gridSize) -> void;
+
+/**
+ * @brief Finds a distance no ray of a bundle can hit anything before.
+ *
+ * Marches the coarse cells along the central ray of the bundle and stops at the first cell with a dilated occupied cell.
+ * A ray of the bundle hitting a voxel at distance t passes within t * sin(halfAngle) of the central ray, so as long as that is
+ * within a cell, the central ray passes a neighbouring cell of the hit no later than t. Beyond that range the march gives up.
+ *
+ * CPU port of 'TraceCoarseDistance' in 'CoarseDepth.glsl', they must be kept in sync.
+ *
+ * @param rayOrigin The origin of the rays.
+ * @param rayDirection The normalized direction of the central ray.
+ * @param sinHalfAngle The sine of the largest angle between the central ray and any ray of the bundle.
+ * @param gridOrigin The coordinate of the first chunk of the grid.
+ * @param gridSize The size of the grid in chunks.
+ * @param dilated The dilated occupancy of the grid, see @ref DilateCoarseOccupancy.
+ *
+ * @return The distance the rays may start at, or -1 if none of them can hit anything.
+ */
+[[nodiscard]] auto TraceCoarseDistance(
+	const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float sinHalfAngle,
+	const glm::ivec3& gridOrigin, const glm::ivec3& gridSize,
+	std::span<const uint64_t> dilated) -> float;
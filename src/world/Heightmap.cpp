@@ -0,0 +1,107 @@
+#include "Heightmap.h"
+
+#include <algorithm>
+#include <limits>
+
+HeightmapGenerator::HeightmapGenerator(int32_t seed, int32_t terrainHeight, size_t capacity)
+	: m_noise(FractalNoiseSettings{
+		.Seed = seed,
+		.Frequency = 0.01f,
+		.Octaves = 8,
+		.Gain = 0.5f,
+		.Lacunarity = 2.0f,
+	}), m_biomeNoise(FractalNoiseSettings{
+		.Seed = seed + 1,
+		.Frequency = 0.002f,
+		.Octaves = 3,
+		.Gain = 0.5f,
+		.Lacunarity = 2.0f,
+	}), m_terrainHeight(terrainHeight), m_capacity(std::max<size_t>(capacity, 1u))
+{
+
+}
+
+auto HeightmapGenerator::GetTile(const glm::ivec2& coordinate) -> std::shared_ptr<const HeightmapTile>
+{
+	{
+		std::scoped_lock lock(m_cacheMutex);
+
+		if(auto it = m_cache.find(coordinate); it != m_cache.end())
+		{
+			m_recency.splice(m_recency.begin(), m_recency, it->second.RecencyIterator);
+			m_hitCount.fetch_add(1u, std::memory_order_relaxed);
+
+			return it->second.Tile;
+		}
+	}
+
+	// Generate outside the lock, two threads racing for the same tile produce identical results
+	std::shared_ptr<const HeightmapTile> tile = GenerateTile(coordinate);
+	m_missCount.fetch_add(1u, std::memory_order_relaxed);
+
+	std::scoped_lock lock(m_cacheMutex);
+
+	if(auto it = m_cache.find(coordinate); it != m_cache.end())
+	{
+		return it->second.Tile;
+	}
+
+	while(m_cache.size() >= m_capacity)
+	{
+		m_cache.erase(m_recency.back());
+		m_recency.pop_back();
+	}
+
+	m_recency.push_front(coordinate);
+	m_cache.emplace(
+		coordinate,
+		CacheEntry{
+			.Tile = tile,
+			.RecencyIterator = m_recency.begin(),
+		});
+
+	return tile;
+}
+
+auto HeightmapGenerator::GenerateTile(const glm::ivec2& coordinate) const -> std::shared_ptr<const HeightmapTile>
+{
+	constexpr size_t columnCount = Chunk::Size * Chunk::Size;
+
+	std::array<float, columnCount> xs;
+	std::array<float, columnCount> zs;
+	std::array<float, columnCount> noise;
+	std::array<float, columnCount> biomeNoise;
+
+	for(uint8_t z = 0u; z < Chunk::Size; z++)
+	{
+		for(uint8_t x = 0u; x < Chunk::Size; x++)
+		{
+			glm::vec2 p = glm::vec2(x, z) + glm::vec2(coordinate) * static_cast<float>(Chunk::Size);
+			p /= 2.0f;
+
+			xs[z * Chunk::Size + x] = p.x;
+			zs[z * Chunk::Size + x] = p.y;
+		}
+	}
+
+	m_noise.GetNoise(xs, zs, noise);
+	m_biomeNoise.GetNoise(xs, zs, biomeNoise);
+
+	auto tile = std::make_shared<HeightmapTile>();
+	tile->MinHeight = std::numeric_limits<int32_t>::max();
+	tile->MaxHeight = std::numeric_limits<int32_t>::min();
+
+	for(size_t i = 0u; i < columnCount; ++i)
+	{
+		int32_t h = static_cast<int32_t>(((noise[i] + 1.0f) / 2.0f) * static_cast<float>(m_terrainHeight));
+
+		tile->Heights[i] = h;
+		tile->Biomes[i] = (biomeNoise[i] < -0.2f)
+			? Biome::Desert
+			: ((biomeNoise[i] > 0.2f) ? Biome::Forest : Biome::Plains);
+		tile->MinHeight = std::min(tile->MinHeight, h);
+		tile->MaxHeight = std::max(tile->MaxHeight, h);
+	}
+
+	return tile;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Chunk.h"
+#include "../utility/Noise.h"
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+/**
+ * @brief The climate of a column, selects the surface materials and decorations.
+ */
+enum class Biome : uint8_t
+{
+	Plains,
+	Desert,
+	Forest,
+};
+
+/**
+ * @brief The terrain heights and biomes of one chunk column.
+ */
+struct HeightmapTile
+{
+	/**
+	 * @brief The surface height of every column in voxels, indexed by 'z * Chunk::Size + x'.
+	 */
+	std::array<int32_t, Chunk::Size * Chunk::Size> Heights;
+
+	/**
+	 * @brief The biome of every column, indexed like @ref Heights.
+	 */
+	std::array<Biome, Chunk::Size * Chunk::Size> Biomes;
+
+	/**
+	 * @brief The lowest height in the tile.
+	 */
+	int32_t MinHeight;
+
+	/**
+	 * @brief The highest height in the tile.
+	 */
+	int32_t MaxHeight;
+};
+
+/**
+ * @brief Generates heightmap tiles and keeps the recently used ones.
+ *
+ * A tile is shared by every chunk of a column, so it is generated once instead of once per chunk.
+ */
+class HeightmapGenerator
+{
+public:
+	/**
+	 * @brief Sets up the height and biome noise.
+	 *
+	 * @param seed The seed of the noise.
+	 * @param terrainHeight The height of the terrain in voxels.
+	 * @param capacity The maximum number of cached tiles.
+	 */
+	HeightmapGenerator(int32_t seed, int32_t terrainHeight, size_t capacity);
+
+	/**
+	 * @brief Retrieves the tile of a chunk column, generating it if it is not cached.
+	 *
+	 * Thread safe.
+	 *
+	 * @param coordinate The horizontal coordinate of the chunk column.
+	 *
+	 * @return The tile of the column.
+	 */
+	[[nodiscard]] auto GetTile(const glm::ivec2& coordinate) -> std::shared_ptr<const HeightmapTile>;
+
+	/**
+	 * @brief Retrieves the number of lookups served from the cache.
+	 *
+	 * @return The number of hits.
+	 */
+	[[nodiscard]] auto GetHitCount() const noexcept -> uint64_t
+	{
+		return m_hitCount.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Retrieves the number of lookups that generated a tile.
+	 *
+	 * @return The number of misses.
+	 */
+	[[nodiscard]] auto GetMissCount() const noexcept -> uint64_t
+	{
+		return m_missCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	/**
+	 * @brief A tile in the cache with its position in the recency list.
+	 */
+	struct CacheEntry
+	{
+		std::shared_ptr<const HeightmapTile> Tile;
+		std::list<glm::ivec2>::iterator RecencyIterator;
+	};
+
+	FractalNoise m_noise;
+	FractalNoise m_biomeNoise;
+	int32_t m_terrainHeight;
+	size_t m_capacity;
+
+	std::unordered_map<glm::ivec2, CacheEntry> m_cache;
+	std::list<glm::ivec2> m_recency;
+	std::mutex m_cacheMutex;
+
+	std::atomic<uint64_t> m_hitCount = 0u;
+	std::atomic<uint64_t> m_missCount = 0u;
+
+	/**
+	 * @brief Generates the tile of a chunk column.
+	 *
+	 * @param coordinate The horizontal coordinate of the chunk column.
+	 *
+	 * @return The generated tile.
+	 */
+	[[nodiscard]] auto GenerateTile(const glm::ivec2& coordinate) const -> std::shared_ptr<const HeightmapTile>;
+};
@@ -1,145 +1,1044 @@
 #include "World.h"
 
+#include "ChunkClient.h"
+#include "ChunkGrid.h"
 #include "../renderer/GUI.h"
 #include "../renderer/Renderer.h"
 #include "../utility/Config.h"
+#include "../utility/Profiler.h"
+#include "../utility/Time.h"
 
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/vec_swizzle.hpp>
 #include <imgui/imgui.h>
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
 #include <ranges>
 
-#include <random>
+namespace
+{
+	/**
+	 * @brief The speed in voxels per second below which the camera is considered stationary.
+	 */
+	constexpr float MinPrefetchSpeed = 1.0f;
+
+	/**
+	 * @brief The maximum number of points sampled along the predicted path.
+	 */
+	constexpr int32_t MaxPrefetchSampleCount = 8;
+
+	/**
+	 * @brief The weight of the latest frame in the smoothed camera motion.
+	 */
+	constexpr float CameraMotionSmoothing = 0.2f;
+}
 
 World::World(const WorldSettings& settings, ChunkAllocator& allocator)
-	: m_allocator(allocator), m_settings(settings), m_camera{
-		.Position = glm::vec3(0.0f, 64.0f, 0.0f),
+	: m_settings(settings),
+	m_loadDistanceConfig("world", "iLoadDistance"), m_unloadMarginConfig("world", "iUnloadMargin"),
+	m_chunkLoadingBudgetConfig("world", "fChunkLoadingBudget"), m_prefetchHorizonConfig("world", "fPrefetchHorizon"),
+	m_camera{
+		.Position = glm::vec3(0.0f, static_cast<float>(settings.Height * static_cast<int32_t>(Chunk::Size)) + 16.0f, 0.0f),
 		.Rotation = glm::vec3(-20.0f, 70.0f, 0.0f),
 		.FieldOfView = static_cast<float>(Config::Get<double>("camera", "fFieldOfView"))
-	}
+	},
+	m_allocator(allocator), m_chunkCache(settings.ChunkCacheSize)
 {
-	std::random_device randomDevice;
-	std::mt19937_64 randomEngine(randomDevice());
-	m_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-	m_noise.SetFractalType(FastNoiseLite::FractalType_FBm);
-	m_noise.SetFractalOctaves(8);
-	m_noise.SetFractalGain(0.5f);
-	m_noise.SetFractalLacunarity(2.0f);
-	m_noise.SetSeed(static_cast<int>(randomEngine()));
+	m_previousCameraPosition = m_camera.Position;
+	m_previousCameraYaw = m_camera.Rotation.y;
+
+	// Clamped like in 'WorldSettings::LoadFromConfig', a changed load distance rebuilds the chunk grid on the next update
+	m_loadDistanceConfig.OnChanged += [this] (const int64_t& loadDistance) -> void
+		{
+			m_settings.LoadDistance = static_cast<uint8_t>(std::clamp<int64_t>(loadDistance, 1, WorldSettings::MaxLoadDistance));
+		};
+
+	m_unloadMarginConfig.OnChanged += [this] (const int64_t& unloadMargin) -> void
+		{
+			m_settings.UnloadMargin = static_cast<uint8_t>(std::clamp<int64_t>(unloadMargin, 0, WorldSettings::MaxLoadDistance));
+		};
+
+	m_chunkLoadingBudgetConfig.OnChanged += [this] (const double& chunkLoadingBudget) -> void
+		{
+			m_settings.ChunkLoadingBudget = std::max(static_cast<float>(chunkLoadingBudget), WorldSettings::MinChunkLoadingBudget);
+		};
+
+	m_prefetchHorizonConfig.OnChanged += [this] (const double& prefetchHorizon) -> void
+		{
+			m_settings.PrefetchHorizon = std::max(static_cast<float>(prefetchHorizon), 0.0f);
+		};
+
+	m_seed = settings.Seed;
+
+	if(!settings.ServerAddress.empty())
+	{
+		m_chunkClient = ChunkClient::Connect(
+			settings.ServerAddress,
+			settings.Seed,
+			settings.Height,
+			[this] (uint64_t id, const glm::ivec3& coordinate, JobPriority priority, Chunk&& chunk, CompressedChunk&& compressedChunk) -> void
+			{
+				m_generatedChunks.Push(
+					GeneratedChunk{
+						.JobId = id,
+						.Coordinate = coordinate,
+						.Data = std::move(chunk),
+						.CompressedData = std::move(compressedChunk),
+						.IsPrefetched = priority == JobPriority::Low,
+					});
+			});
+
+		// The local generator takes over if the server is lost, so it generates the server's world
+		if(m_chunkClient != nullptr)
+		{
+			m_seed = m_chunkClient->GetSeed();
+		}
+		else
+		{
+			printf("Generating the chunks locally instead\n");
+		}
+	}
+
+	if(m_seed == 0)
+	{
+		m_seed = WorldSettings::GetRandomSeed();
+	}
+
+	m_generator = std::make_unique<WorldGenerator>(
+		m_seed,
+		settings.Height * static_cast<int32_t>(Chunk::Size),
+		settings.HeightmapCacheSize);
 
 	GUI::OnGui += [&] (const glm::uvec2& size) -> void
 		{
-			ImGui::SetNextWindowSize(ImVec2(350.0f, 55.0f));
+			ImGui::SetNextWindowSize(ImVec2(350.0f, 280.0f));
 			ImGui::SetNextWindowPos(ImVec2(0.0f, 100.0f));
 			ImGui::Begin("World", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
 			int ld = m_settings.LoadDistance;
-			ImGui::SliderInt("Load Distance", &ld, 2, 16);
-			m_settings.LoadDistance = ld;
-			Config::Get<int64_t>("world", "iLoadDistance") = m_settings.LoadDistance;
+			if(ImGui::SliderInt("Load Distance", &ld, 2, WorldSettings::MaxLoadDistance))
+			{
+				m_loadDistanceConfig.Set(ld);
+			}
+
+			ImGui::Text(
+				"Chunk cache: %.1f MiB, %llu hits, %llu misses",
+				static_cast<double>(m_chunkCache.GetSize()) / (1024.0 * 1024.0),
+				static_cast<unsigned long long>(m_chunkCache.GetHitCount()),
+				static_cast<unsigned long long>(m_chunkCache.GetMissCount()));
+			ImGui::Text(
+				"Edits: %llu chunks, %.1f KiB uploaded",
+				static_cast<unsigned long long>(m_editedChunkCount),
+				static_cast<double>(m_editUploadSize) / 1024.0);
+			ImGui::Text(
+				"Lighting: %llu chunks baked, %zu outdated",
+				static_cast<unsigned long long>(m_bakedChunkCount),
+				m_dirtyLighting.size());
+			ImGui::Text(
+				"Prefetch: %llu requested, %llu hits, %llu wasted, %llu misses",
+				static_cast<unsigned long long>(m_prefetchRequestCount),
+				static_cast<unsigned long long>(m_prefetchHitCount + m_chunkCache.GetPrefetchHitCount()),
+				static_cast<unsigned long long>(m_chunkCache.GetPrefetchWasteCount()),
+				static_cast<unsigned long long>(m_prefetchMissCount));
+
+			// The average time per chunk of every generation stage
+			if(ImGui::BeginTable("Generation", 4))
+			{
+				ImGui::TableSetupColumn("Stage");
+				ImGui::TableSetupColumn("ms/chunk");
+				ImGui::TableSetupColumn("Runs");
+				ImGui::TableSetupColumn("Skips");
+				ImGui::TableHeadersRow();
+
+				for(size_t i = 0u; i < static_cast<size_t>(GenerationStage::Count); ++i)
+				{
+					GenerationStage stage = static_cast<GenerationStage>(i);
+					GenerationStageStatistics statistics = m_generator->GetStageStatistics(stage);
+					uint64_t count = statistics.RunCount + statistics.SkipCount;
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(WorldGenerator::GetStageName(stage));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.3f", (count > 0u) ? statistics.TotalTime / static_cast<double>(count) : 0.0);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", static_cast<unsigned long long>(statistics.RunCount));
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", static_cast<unsigned long long>(statistics.SkipCount));
+				}
+
+				ImGui::EndTable();
+			}
+
 			ImGui::End();
 		};
 }
 
 World::~World()
 {
-	for(auto& job : m_chunkLoadingJobs)
+	for(const auto& [chunkCoordinate, job] : m_chunkLoadingJobs)
+	{
+		job.Cancellation.Cancel();
+	}
+
+	for(const auto& [chunkCoordinate, job] : m_chunkLoadingJobs)
 	{
-		job.wait();
+		JobSystem::Wait(job.Handle);
+	}
+
+	for(const JobHandle& handle : m_cancelledJobs)
+	{
+		JobSystem::Wait(handle);
+	}
+
+	for(const auto& [chunkCoordinate, handle] : m_lightingJobs)
+	{
+		JobSystem::Wait(handle);
 	}
 }
 
 auto World::Update() -> void
 {
-	glm::ivec2 cameraCoordinate = glm::ivec2(glm::xz(m_camera.Position)) / static_cast<int32_t>(Chunk::Size);
+	PROFILE_SCOPE("World::Update");
 
-	std::unordered_set<glm::ivec2> visibleChunks;
-	for(int32_t x = -m_settings.LoadDistance; x < m_settings.LoadDistance; ++x)
+	glm::ivec2 cameraCoordinate = GetChunkColumn(m_camera.Position);
+	bool hasCameraMoved = m_camera.Position != m_previousCameraPosition || m_camera.Rotation.y != m_previousCameraYaw;
+
+	if(m_chunkClient != nullptr && !m_chunkClient->IsConnected())
 	{
-		for(int32_t y = -m_settings.LoadDistance; y < m_settings.LoadDistance; ++y)
+		DisconnectChunkServer();
+	}
+
+	UpdateCameraMotion();
+	bool hasPrefetchChanged = UpdatePrefetchColumns(cameraCoordinate);
+	bool hasGridMoved = UpdateChunkGrid(cameraCoordinate);
+
+	// Store the chunks finished since the last frame, the ones out of range are kept in the cache
+	m_generatedChunks.Drain(
+		[&] (GeneratedChunk&& generatedChunk) -> void
 		{
-			glm::ivec2 chunkCoordinate = glm::ivec2(x, y) + cameraCoordinate;
+			++m_generatedChunkCount;
+
+			if(auto it = m_chunkLoadingJobs.find(generatedChunk.Coordinate); it != m_chunkLoadingJobs.end() && it->second.Id == generatedChunk.JobId)
+			{
+				m_chunkLoadingJobs.erase(it);
+			}
 
-			visibleChunks.insert(chunkCoordinate);
-			if(
-				!m_loadedChunks.contains(chunkCoordinate) &&
-				std::ranges::find(m_neededChunks, chunkCoordinate) == m_neededChunks.end())
+			if(!IsChunkRetained(generatedChunk.Coordinate, cameraCoordinate))
 			{
-				m_neededChunks.push_back(chunkCoordinate);
+				// A cached copy may contain edits
+				if(m_chunkCache.Contains(generatedChunk.Coordinate))
+				{
+					return;
+				}
+
+				m_chunkCache.Store(generatedChunk.Coordinate, std::move(generatedChunk.CompressedData), generatedChunk.IsPrefetched);
+
+				return;
+			}
+
+			if(generatedChunk.IsPrefetched && IsChunkInLoadRange(generatedChunk.Coordinate, cameraCoordinate))
+			{
+				++m_prefetchHitCount;
+			}
+
+			LoadChunk(generatedChunk.Coordinate, generatedChunk.Data, std::move(generatedChunk.CompressedData));
+		});
+
+	if(!m_voxelEdits.empty())
+	{
+		ApplyVoxelEdits();
+	}
+
+	UpdateLighting(cameraCoordinate);
+
+	if(hasPrefetchChanged)
+	{
+		// Queue the chunks along the predicted path behind every chunk in range
+		for(const glm::ivec2& column : m_prefetchColumns)
+		{
+			RequestChunkColumn(column, cameraCoordinate, true);
+		}
+
+		// Cancel the jobs outside the grid the camera no longer heads for
+		for(auto it = m_chunkLoadingJobs.begin(); it != m_chunkLoadingJobs.end();)
+		{
+			const glm::ivec3 chunkCoordinate = (it++)->first;
+
+			if(!IsChunkRetained(chunkCoordinate, cameraCoordinate) && !m_prefetchColumns.contains(glm::xz(chunkCoordinate)))
+			{
+				CancelChunkLoadingJob(chunkCoordinate);
 			}
 		}
 	}
 
-	// Lunch one job per frame
-	if(!m_neededChunks.empty())
+	// Drop the requests that fell out of range and sort the rest for the current camera
+	if((hasCameraMoved || hasGridMoved || hasPrefetchChanged) && !m_chunkLoadQueue.IsEmpty())
 	{
-		glm::ivec2& chunkCoordinate = m_neededChunks.front();
+		m_chunkLoadQueue.Reprioritize(
+			[&] (const glm::ivec3& chunkCoordinate) -> std::optional<float>
+			{
+				return GetChunkLoadPriority(chunkCoordinate, cameraCoordinate);
+			});
+	}
 
-		m_chunkLoadingJobs.emplace_back(std::move(std::async(std::launch::async, &World::LoadChunk, this, chunkCoordinate)));
+	if(!m_cancelledJobs.empty())
+	{
+		std::erase_if(m_cancelledJobs, [] (const JobHandle& handle) -> bool { return handle.IsFinished(); });
+	}
 
-		m_neededChunks.pop_front();
+	if(m_chunkLoadQueue.IsEmpty())
+	{
+		return;
 	}
 
-	// Remove chunks that have been loaded
-	std::erase_if(
-		m_loadedChunks,
-		[&] (const glm::ivec2& chunkCoordinate) -> bool
+	// Restore or launch the most important chunks until either budget runs out, the first one is launched regardless of the time
+	PROFILE_SCOPE("World::LaunchChunkLoads");
+
+	auto budgetEnd = std::chrono::steady_clock::now() + std::chrono::duration<float, std::milli>(m_settings.ChunkLoadingBudget);
+	bool hasLaunched = false;
+	while(m_chunkLoadingJobs.size() < m_settings.MaxChunkLoadingJobs && (!hasLaunched || std::chrono::steady_clock::now() < budgetEnd))
+	{
+		std::optional<glm::ivec3> chunkCoordinate = m_chunkLoadQueue.Pop();
+		if(!chunkCoordinate.has_value())
+		{
+			break;
+		}
+
+		// A cancelled job may have delivered the chunk after it was requested again
+		if(IsChunkLoaded(*chunkCoordinate))
+		{
+			continue;
+		}
+
+		// Prefetched chunks are only generated into the cache
+		bool isPrefetch = !IsChunkInLoadRange(*chunkCoordinate, cameraCoordinate);
+		if(isPrefetch)
 		{
-			if(!visibleChunks.contains(chunkCoordinate))
+			if(m_chunkCache.Contains(*chunkCoordinate))
 			{
-				m_allocator.Free(chunkCoordinate);
+				continue;
+			}
+
+			++m_prefetchRequestCount;
+		}
+		else if(std::optional<CompressedChunk> compressedChunk = m_chunkCache.Take(*chunkCoordinate))
+		{
+			++m_restoredChunkCount;
+
+			LoadChunk(*chunkCoordinate, *DecompressChunk(*compressedChunk), std::move(*compressedChunk));
+			hasLaunched = true;
 
-				return true;
+			continue;
+		}
+		else if(IsPrefetching())
+		{
+			++m_prefetchMissCount;
+		}
+
+		JobPriority priority = isPrefetch
+			? JobPriority::Low
+			: (IsChunkInView(*chunkCoordinate) ? JobPriority::High : JobPriority::Normal);
+
+		ChunkLoadingJob job{
+			.Id = m_nextChunkLoadingJobId++,
+			.Handle = {},
+			.Cancellation = {},
+		};
+		hasLaunched = true;
+
+		// Remote requests have no local job to wait for
+		if(m_chunkClient != nullptr)
+		{
+			m_chunkClient->Request(job.Id, *chunkCoordinate, priority);
+			m_chunkLoadingJobs.emplace(*chunkCoordinate, std::move(job));
+
+			continue;
+		}
+
+		job.Handle = m_generator->Schedule(
+			*chunkCoordinate,
+			priority,
+			job.Cancellation,
+			[this, jobId = job.Id, coordinate = *chunkCoordinate, isPrefetch] (Chunk&& chunk) -> void
+			{
+				CompressedChunk compressedChunk = CompressChunk(chunk);
+
+				m_generatedChunks.Push(
+					GeneratedChunk{
+						.JobId = jobId,
+						.Coordinate = coordinate,
+						.Data = std::move(chunk),
+						.CompressedData = std::move(compressedChunk),
+						.IsPrefetched = isPrefetch,
+					});
+			});
+
+		m_chunkLoadingJobs.emplace(*chunkCoordinate, std::move(job));
+	}
+}
+
+auto World::GetStatistics() const noexcept -> WorldStatistics
+{
+	return WorldStatistics{
+		.GeneratedChunkCount = m_generatedChunkCount,
+		.RestoredChunkCount = m_restoredChunkCount,
+		.UnloadedChunkCount = m_unloadedChunkCount,
+		.BakedChunkCount = m_bakedChunkCount,
+		.LoadedChunkCount = m_loadedChunkCount,
+		.PendingChunkCount = m_chunkLoadQueue.GetSize() + m_chunkLoadingJobs.size(),
+		.CacheSize = m_chunkCache.GetSize(),
+	};
+}
+
+auto World::SetVoxel(const glm::ivec3& position, Material material) -> void
+{
+	EditRegion(position, position, material);
+}
+
+auto World::EditRegion(const glm::ivec3& min, const glm::ivec3& max, Material material) -> void
+{
+	constexpr int32_t chunkSize = static_cast<int32_t>(Chunk::Size);
+
+	glm::ivec3 first = glm::min(min, max);
+	glm::ivec3 last = glm::max(min, max);
+
+	// Floor division, so negative positions fall into the chunk below
+	glm::ivec3 firstChunk = (first - glm::ivec3(glm::lessThan(first, glm::ivec3(0))) * (chunkSize - 1)) / chunkSize;
+	glm::ivec3 lastChunk = (last - glm::ivec3(glm::lessThan(last, glm::ivec3(0))) * (chunkSize - 1)) / chunkSize;
+
+	for(int32_t x = firstChunk.x; x <= lastChunk.x; ++x)
+	{
+		for(int32_t y = firstChunk.y; y <= lastChunk.y; ++y)
+		{
+			for(int32_t z = firstChunk.z; z <= lastChunk.z; ++z)
+			{
+				glm::ivec3 chunkCoordinate = glm::ivec3(x, y, z);
+				glm::ivec3 chunkOrigin = chunkCoordinate * chunkSize;
+
+				m_voxelEdits[chunkCoordinate].emplace_back(
+					VoxelEdit{
+						.Min = glm::u8vec3(glm::max(first - chunkOrigin, glm::ivec3(0))),
+						.Max = glm::u8vec3(glm::min(last - chunkOrigin, glm::ivec3(chunkSize - 1))),
+						.Value = material,
+					});
 			}
+		}
+	}
+}
 
-			return false;
-		});
+auto World::GetChunkLoadPriority(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> std::optional<float>
+{
+	glm::vec3 chunkCenter = (glm::vec3(coordinate) + 0.5f) * static_cast<float>(Chunk::Size);
+	float distance = glm::distance(chunkCenter, m_camera.Position) / static_cast<float>(Chunk::Size);
+
+	if(!IsChunkInLoadRange(coordinate, cameraCoordinate))
+	{
+		if(coordinate.y < 0 || coordinate.y >= m_settings.Height || !m_prefetchColumns.contains(glm::xz(coordinate)))
+		{
+			return std::nullopt;
+		}
+
+		// Behind the chunks in range, even the ones outside the view
+		return distance + 4.0f * static_cast<float>(m_settings.LoadDistance);
+	}
+
+	// Chunks outside the view are pushed behind every chunk inside it.
+	return IsChunkInView(coordinate)
+		? distance
+		: distance + 2.0f * static_cast<float>(m_settings.LoadDistance);
+}
+
+auto World::UpdateCameraMotion() -> void
+{
+	float deltaTime = Time::GetDeltaTime();
+	if(deltaTime > 0.0f)
+	{
+		glm::vec3 velocity = (m_camera.Position - m_previousCameraPosition) / deltaTime;
+		float yawRate = (m_camera.Rotation.y - m_previousCameraYaw) / deltaTime;
 
-	// Remove the jobs that are finished
-	std::erase_if(
-		m_chunkLoadingJobs,
-		[] (const std::future<void>& job) -> bool
+		m_cameraVelocity = glm::mix(m_cameraVelocity, velocity, CameraMotionSmoothing);
+		m_cameraYawRate = glm::mix(m_cameraYawRate, yawRate, CameraMotionSmoothing);
+	}
+
+	m_previousCameraPosition = m_camera.Position;
+	m_previousCameraYaw = m_camera.Rotation.y;
+}
+
+auto World::DisconnectChunkServer() -> void
+{
+	printf("Lost the chunk server, generating the chunks locally\n");
+
+	m_chunkClient.reset();
+
+	glm::ivec2 cameraCoordinate = GetChunkColumn(m_camera.Position);
+
+	for(const auto& [chunkCoordinate, job] : m_chunkLoadingJobs)
+	{
+		if(std::optional<float> priority = GetChunkLoadPriority(chunkCoordinate, cameraCoordinate))
 		{
-			return job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			m_chunkLoadQueue.Push(chunkCoordinate, *priority);
+		}
+	}
+
+	m_chunkLoadingJobs.clear();
+}
+
+auto World::ApplyVoxelEdits() -> void
+{
+	PROFILE_SCOPE("World::ApplyVoxelEdits");
+
+	std::vector<uint8_t> voxels(Chunk::Size * Chunk::Size * Chunk::Size);
+
+	for(const auto& [chunkCoordinate, edits] : m_voxelEdits)
+	{
+		if(!IsChunkLoaded(chunkCoordinate))
+		{
+			continue;
+		}
+
+		std::optional<CompressedChunk>& compressedChunk = m_chunkGrid->Find(glm::xz(chunkCoordinate))->Chunks[static_cast<size_t>(chunkCoordinate.y)];
+
+		Chunk previous = *DecompressChunk(*compressedChunk);
+		previous.Extract(voxels);
+
+		for(const VoxelEdit& edit : edits)
+		{
+			for(size_t z = edit.Min.z; z <= edit.Max.z; ++z)
+			{
+				for(size_t y = edit.Min.y; y <= edit.Max.y; ++y)
+				{
+					std::ranges::fill(
+						voxels.begin() + static_cast<ptrdiff_t>((z * Chunk::Size + y) * Chunk::Size + edit.Min.x),
+						voxels.begin() + static_cast<ptrdiff_t>((z * Chunk::Size + y) * Chunk::Size + edit.Max.x + 1u),
+						static_cast<uint8_t>(edit.Value));
+				}
+			}
+		}
+
+		Chunk chunk;
+		chunk.Build(voxels);
+
+		// Without space for the edited chunk the edits are dropped, the previous chunk stays with its lighting
+		std::optional<size_t> uploadSize = m_allocator.Update(chunkCoordinate, previous, chunk);
+		if(!uploadSize.has_value())
+		{
+			continue;
+		}
+
+		compressedChunk = CompressChunk(chunk);
+
+		// The server owns the world, it keeps the edit past this client's cache and serves it to every later request
+		if(m_chunkClient != nullptr)
+		{
+			m_chunkClient->SendEdit(chunkCoordinate, *compressedChunk);
+		}
+
+		++m_editedChunkCount;
+		m_editUploadSize += *uploadSize;
+
+		InvalidateLighting(chunkCoordinate, UpdateSkyHeights(chunkCoordinate, chunk));
+	}
+
+	m_voxelEdits.clear();
+}
+
+auto World::UpdateLighting(const glm::ivec2& cameraCoordinate) -> void
+{
+	PROFILE_SCOPE("World::UpdateLighting");
+
+	// A chunk which changed its leaves since the bake was started is rejected and baked again
+	m_bakedLighting.Drain(
+		[&] (BakedLighting&& bakedLighting) -> void
+		{
+			m_lightingJobs.erase(bakedLighting.Coordinate);
+
+			if(IsChunkLoaded(bakedLighting.Coordinate) && m_allocator.UpdateLighting(bakedLighting.Coordinate, bakedLighting.Lighting))
+			{
+				++m_bakedChunkCount;
+			}
 		});
+
+	for(auto it = m_dirtyLighting.begin(); it != m_dirtyLighting.end() && m_lightingJobs.size() < m_settings.MaxChunkLoadingJobs;)
+	{
+		glm::ivec3 chunkCoordinate = *it;
+
+		if(!IsChunkLoaded(chunkCoordinate))
+		{
+			it = m_dirtyLighting.erase(it);
+
+			continue;
+		}
+
+		// Only one bake of a chunk runs at a time, so the results arrive in order
+		if(m_lightingJobs.contains(chunkCoordinate) || IsLightingPending(chunkCoordinate, cameraCoordinate))
+		{
+			++it;
+
+			continue;
+		}
+
+		it = m_dirtyLighting.erase(it);
+
+		m_lightingJobs.emplace(
+			chunkCoordinate,
+			JobSystem::Schedule(
+				[this, chunkCoordinate, input = GetLightingInput(chunkCoordinate)] () -> void
+				{
+					m_bakedLighting.Push(
+						BakedLighting{
+							.Coordinate = chunkCoordinate,
+							.Lighting = BakeChunkLighting(input),
+						});
+				}));
+	}
+}
+
+auto World::InvalidateLighting(const glm::ivec3& coordinate, bool hasSkyChanged) -> void
+{
+	int32_t minHeight = hasSkyChanged ? 0 : glm::max(coordinate.y - 1, 0);
+	int32_t maxHeight = hasSkyChanged ? m_settings.Height - 1 : glm::min(coordinate.y + 1, m_settings.Height - 1);
+
+	for(int32_t x = -1; x <= 1; ++x)
+	{
+		for(int32_t z = -1; z <= 1; ++z)
+		{
+			const ChunkColumn* column = m_chunkGrid->Find(glm::xz(coordinate) + glm::ivec2(x, z));
+			if(column == nullptr)
+			{
+				continue;
+			}
+
+			for(int32_t y = minHeight; y <= maxHeight; ++y)
+			{
+				// Uniform chunks store no lighting
+				const std::optional<CompressedChunk>& compressedChunk = column->Chunks[static_cast<size_t>(y)];
+				if(compressedChunk.has_value() && compressedChunk->NodeCount != 0u)
+				{
+					m_dirtyLighting.insert(glm::ivec3(coordinate.x + x, y, coordinate.z + z));
+				}
+			}
+		}
+	}
+}
+
+auto World::UpdateSkyHeights(const glm::ivec3& coordinate, const Chunk& chunk) -> bool
+{
+	constexpr int32_t chunkSize = static_cast<int32_t>(Chunk::Size);
+
+	ChunkColumn& column = *m_chunkGrid->Find(glm::xz(coordinate));
+	column.Heights[static_cast<size_t>(coordinate.y)] = GetChunkHeights(chunk);
+
+	std::array<int32_t, Chunk::Size * Chunk::Size> skyHeights;
+	skyHeights.fill(0);
+
+	for(int32_t y = 0; y < WorldSettings::MaxHeight; ++y)
+	{
+		if(!column.Chunks[static_cast<size_t>(y)].has_value())
+		{
+			continue;
+		}
+
+		const ChunkHeights& heights = column.Heights[static_cast<size_t>(y)];
+		for(size_t i = 0u; i < heights.size(); ++i)
+		{
+			if(heights[i] != 0u)
+			{
+				skyHeights[i] = y * chunkSize + static_cast<int32_t>(heights[i]);
+			}
+		}
+	}
+
+	if(skyHeights == column.SkyHeights)
+	{
+		return false;
+	}
+
+	column.SkyHeights = skyHeights;
+
+	return true;
+}
+
+auto World::GetLightingInput(const glm::ivec3& coordinate) const -> ChunkLightingInput
+{
+	constexpr int32_t chunkSize = static_cast<int32_t>(Chunk::Size);
+
+	ChunkLightingInput input{
+		.Neighbourhood = {},
+		.SkyHeights = std::vector<int32_t>(static_cast<size_t>(ChunkLightingInput::SkyHeightsSize * ChunkLightingInput::SkyHeightsSize), 0),
+		.BaseHeight = coordinate.y * chunkSize,
+	};
+
+	for(size_t i = 0u; i < input.Neighbourhood.size(); ++i)
+	{
+		glm::ivec3 neighbourCoordinate = coordinate + glm::ivec3(
+			static_cast<int32_t>(i % 3u) - 1,
+			static_cast<int32_t>(i / 9u) - 1,
+			static_cast<int32_t>((i / 3u) % 3u) - 1);
+
+		if(IsChunkLoaded(neighbourCoordinate))
+		{
+			input.Neighbourhood[i] = m_chunkGrid->Find(glm::xz(neighbourCoordinate))->Chunks[static_cast<size_t>(neighbourCoordinate.y)];
+		}
+	}
+
+	// The occlusion radius is shorter than a chunk, so only the surrounding columns are read
+	for(int32_t columnX = -1; columnX <= 1; ++columnX)
+	{
+		for(int32_t columnZ = -1; columnZ <= 1; ++columnZ)
+		{
+			const ChunkColumn* column = m_chunkGrid->Find(glm::xz(coordinate) + glm::ivec2(columnX, columnZ));
+			if(column == nullptr)
+			{
+				continue;
+			}
+
+			for(int32_t z = 0; z < chunkSize; ++z)
+			{
+				for(int32_t x = 0; x < chunkSize; ++x)
+				{
+					glm::ivec2 local = glm::ivec2(columnX, columnZ) * chunkSize + glm::ivec2(x, z) + SkyOcclusionRadius;
+					if(glm::any(glm::lessThan(local, glm::ivec2(0))) || glm::any(glm::greaterThanEqual(local, glm::ivec2(ChunkLightingInput::SkyHeightsSize))))
+					{
+						continue;
+					}
+
+					input.SkyHeights[static_cast<size_t>(local.y * ChunkLightingInput::SkyHeightsSize + local.x)] = column->SkyHeights[static_cast<size_t>(z * chunkSize + x)];
+				}
+			}
+		}
+	}
+
+	return input;
+}
+
+auto World::IsLightingPending(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> bool
+{
+	for(int32_t x = -1; x <= 1; ++x)
+	{
+		for(int32_t z = -1; z <= 1; ++z)
+		{
+			for(int32_t y = 0; y < m_settings.Height; ++y)
+			{
+				glm::ivec3 chunkCoordinate = glm::ivec3(coordinate.x + x, y, coordinate.z + z);
+
+				if(
+					IsChunkInLoadRange(chunkCoordinate, cameraCoordinate) &&
+					(m_chunkLoadingJobs.contains(chunkCoordinate) || m_chunkLoadQueue.Contains(chunkCoordinate)))
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+auto World::UpdateChunkGrid(const glm::ivec2& cameraCoordinate) -> bool
+{
+	PROFILE_SCOPE("World::UpdateChunkGrid");
+
+	int32_t loadDistance = m_settings.LoadDistance;
+	int32_t retainDistance = loadDistance + m_settings.UnloadMargin;
+	glm::ivec2 origin = cameraCoordinate - retainDistance;
+
+	if(m_chunkGrid.has_value() && m_chunkGrid->GetSize() == 2 * retainDistance)
+	{
+		if(m_chunkGrid->GetOrigin() == origin)
+		{
+			return false;
+		}
+
+		glm::ivec2 previousCameraCoordinate = m_chunkGrid->GetOrigin() + retainDistance;
+
+		m_chunkGrid->Move(
+			origin,
+			[&] (const glm::ivec2& coordinate, ChunkColumn& column) -> void
+			{
+				UnloadChunkColumn(coordinate, column);
+			});
+
+		ForEachInRectDifference(
+			cameraCoordinate - loadDistance,
+			cameraCoordinate + loadDistance,
+			previousCameraCoordinate - loadDistance,
+			previousCameraCoordinate + loadDistance,
+			[&] (const glm::ivec2& column) -> void
+			{
+				RequestChunkColumn(column, cameraCoordinate, false);
+			});
+
+		return true;
+	}
+
+	// On the first update or after the load distance changed, the columns still in range move over to the new grid.
+	std::optional<ToroidalGrid<ChunkColumn>> previousGrid = std::move(m_chunkGrid);
+	m_chunkGrid.emplace(2 * retainDistance, origin);
+
+	if(previousGrid.has_value())
+	{
+		previousGrid->ForEach(
+			[&] (const glm::ivec2& coordinate, ChunkColumn& column) -> void
+			{
+				if(ChunkColumn* newColumn = m_chunkGrid->Find(coordinate))
+				{
+					*newColumn = std::move(column);
+				}
+				else
+				{
+					UnloadChunkColumn(coordinate, column);
+				}
+			});
+	}
+
+	for(int32_t x = -loadDistance; x < loadDistance; ++x)
+	{
+		for(int32_t z = -loadDistance; z < loadDistance; ++z)
+		{
+			RequestChunkColumn(cameraCoordinate + glm::ivec2(x, z), cameraCoordinate, false);
+		}
+	}
+
+	return true;
 }
 
-auto World::LoadChunk(glm::ivec2 coordinate) -> void
+auto World::RequestChunkColumn(const glm::ivec2& column, const glm::ivec2& cameraCoordinate, bool skipCached) -> void
 {
-	Chunk chunk = GenerateChunk(coordinate);
-	if(m_allocator.Allocate(coordinate, chunk))
+	for(int32_t y = 0; y < m_settings.Height; ++y)
 	{
-		m_loadedChunks.insert(coordinate);
+		glm::ivec3 chunkCoordinate = glm::ivec3(column.x, y, column.y);
+
+		if(
+			!IsChunkLoaded(chunkCoordinate) &&
+			!m_chunkLoadingJobs.contains(chunkCoordinate) &&
+			!m_chunkLoadQueue.Contains(chunkCoordinate) &&
+			!(skipCached && m_chunkCache.Contains(chunkCoordinate)))
+		{
+			m_chunkLoadQueue.Push(chunkCoordinate, *GetChunkLoadPriority(chunkCoordinate, cameraCoordinate));
+		}
 	}
 }
 
-auto World::GenerateChunk(const glm::ivec2& coordinate) const -> Chunk
+auto World::UnloadChunkColumn(const glm::ivec2& coordinate, ChunkColumn& column) -> void
 {
-	Chunk chunk;
+	for(int32_t y = 0; y < WorldSettings::MaxHeight; ++y)
+	{
+		std::optional<CompressedChunk>& compressedChunk = column.Chunks[static_cast<size_t>(y)];
+		if(!compressedChunk.has_value())
+		{
+			continue;
+		}
 
-	for(uint8_t z = 0u; z < Chunk::Size; z++)
+		glm::ivec3 chunkCoordinate = glm::ivec3(coordinate.x, y, coordinate.y);
+
+		m_allocator.Free(chunkCoordinate);
+		m_chunkCache.Store(chunkCoordinate, std::move(*compressedChunk));
+		compressedChunk.reset();
+
+		++m_unloadedChunkCount;
+		--m_loadedChunkCount;
+	}
+
+	// Columns on the predicted path keep generating into the cache
+	if(m_prefetchColumns.contains(coordinate))
+	{
+		return;
+	}
+
+	for(int32_t y = 0; y < m_settings.Height; ++y)
+	{
+		CancelChunkLoadingJob(glm::ivec3(coordinate.x, y, coordinate.y));
+	}
+}
+
+auto World::CancelChunkLoadingJob(const glm::ivec3& coordinate) -> void
+{
+	auto it = m_chunkLoadingJobs.find(coordinate);
+	if(it == m_chunkLoadingJobs.end())
 	{
-		for(uint8_t x = 0u; x < Chunk::Size; x++)
+		return;
+	}
+
+	if(m_chunkClient != nullptr)
+	{
+		m_chunkClient->Cancel(it->second.Id);
+	}
+
+	it->second.Cancellation.Cancel();
+	m_cancelledJobs.push_back(std::move(it->second.Handle));
+
+	m_chunkLoadingJobs.erase(it);
+}
+
+auto World::UpdatePrefetchColumns(const glm::ivec2& cameraCoordinate) -> bool
+{
+	if(!IsPrefetching())
+	{
+		if(m_prefetchColumns.empty())
 		{
-			glm::vec2 p = glm::vec2(x, z) + glm::vec2(coordinate) * static_cast<float>(Chunk::Size);
-			p /= 2.0f;
+			return false;
+		}
 
-			uint8_t h = static_cast<uint8_t>(((m_noise.GetNoise(p.x, p.y) + 1.0f) / 2.0f) * Chunk::Size);
+		m_prefetchColumns.clear();
 
-			for(uint8_t y = 0u; y < Chunk::Size; y++)
+		return true;
+	}
+
+	m_prefetchColumns.clear();
+
+	// Sample the path about every half load distance, each sample covers a whole load square
+	float travelDistance = glm::length(glm::xz(m_cameraVelocity)) * m_settings.PrefetchHorizon;
+	float sampleSpacing = static_cast<float>(m_settings.LoadDistance * static_cast<int32_t>(Chunk::Size)) / 2.0f;
+	int32_t sampleCount = glm::clamp(static_cast<int32_t>(std::ceil(travelDistance / sampleSpacing)), 1, MaxPrefetchSampleCount);
+
+	for(int32_t i = 1; i <= sampleCount; ++i)
+	{
+		float time = m_settings.PrefetchHorizon * static_cast<float>(i) / static_cast<float>(sampleCount);
+
+		glm::vec3 position = m_camera.Position + m_cameraVelocity * time;
+		glm::vec3 rotation = glm::vec3(m_camera.Rotation.x, m_camera.Rotation.y + m_cameraYawRate * time, m_camera.Rotation.z);
+		glm::vec2 forward = glm::xz(glm::quat(glm::radians(rotation)) * glm::vec3(0.0f, 0.0f, -1.0f));
+
+		glm::ivec2 predictedCoordinate = GetChunkColumn(position);
+
+		for(int32_t x = -m_settings.LoadDistance; x < m_settings.LoadDistance; ++x)
+		{
+			for(int32_t z = -m_settings.LoadDistance; z < m_settings.LoadDistance; ++z)
 			{
-				chunk.Set(glm::uvec3(x, y, z), y <= h);
+				glm::ivec3 chunkCoordinate = glm::ivec3(predictedCoordinate.x + x, 0, predictedCoordinate.y + z);
+
+				if(
+					!IsChunkInLoadRange(chunkCoordinate, cameraCoordinate) &&
+					!m_prefetchColumns.contains(glm::xz(chunkCoordinate)) &&
+					IsChunkInView(chunkCoordinate, position, forward))
+				{
+					m_prefetchColumns.insert(glm::xz(chunkCoordinate));
+				}
 			}
 		}
 	}
 
-	return chunk;
+	return true;
+}
+
+auto World::IsPrefetching() const -> bool
+{
+	return m_settings.PrefetchHorizon > 0.0f && glm::length(glm::xz(m_cameraVelocity)) >= MinPrefetchSpeed;
+}
+
+auto World::IsChunkInLoadRange(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> bool
+{
+	glm::ivec2 localCoordinate = glm::xz(coordinate) - cameraCoordinate;
+
+	return
+		glm::all(glm::greaterThanEqual(localCoordinate, glm::ivec2(-m_settings.LoadDistance))) &&
+		glm::all(glm::lessThan(localCoordinate, glm::ivec2(m_settings.LoadDistance))) &&
+		coordinate.y >= 0 && coordinate.y < m_settings.Height;
+}
+
+auto World::IsChunkRetained(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> bool
+{
+	int32_t distance = m_settings.LoadDistance + m_settings.UnloadMargin;
+
+	glm::ivec2 localCoordinate = glm::xz(coordinate) - cameraCoordinate;
+
+	return
+		glm::all(glm::greaterThanEqual(localCoordinate, glm::ivec2(-distance))) &&
+		glm::all(glm::lessThan(localCoordinate, glm::ivec2(distance))) &&
+		coordinate.y >= 0 && coordinate.y < m_settings.Height;
+}
+
+auto World::IsChunkInView(const glm::ivec3& coordinate) const -> bool
+{
+	glm::vec3 forward = glm::quat(glm::radians(m_camera.Rotation)) * glm::vec3(0.0f, 0.0f, -1.0f);
+
+	return IsChunkInView(coordinate, m_camera.Position, glm::xz(forward));
+}
+
+auto World::IsChunkInView(const glm::ivec3& coordinate, const glm::vec3& position, const glm::vec2& forwardXZ) const -> bool
+{
+	constexpr float chunkRadius = static_cast<float>(Chunk::Size) * 0.70710678f;
+
+	glm::vec2 chunkCenter = (glm::vec2(glm::xz(coordinate)) + 0.5f) * static_cast<float>(Chunk::Size);
+	glm::vec2 toChunk = chunkCenter - glm::xz(position);
+
+	float distance = glm::length(toChunk);
+	if(distance <= chunkRadius || glm::length(forwardXZ) < 0.01f)
+	{
+		return true;
+	}
+
+	// The vertical field of view is used as the half angle, which is wider than the horizontal one for the usual aspect ratios.
+	float halfAngle = glm::radians(m_camera.FieldOfView) + glm::asin(chunkRadius / distance);
+	float angle = glm::acos(glm::clamp(glm::dot(toChunk / distance, glm::normalize(forwardXZ)), -1.0f, 1.0f));
+
+	return angle <= halfAngle;
+}
+
+auto World::IsChunkLoaded(const glm::ivec3& coordinate) const -> bool
+{
+	if(!m_chunkGrid.has_value() || coordinate.y < 0 || coordinate.y >= WorldSettings::MaxHeight)
+	{
+		return false;
+	}
+
+	const ChunkColumn* column = m_chunkGrid->Find(glm::xz(coordinate));
+
+	return column != nullptr && column->Chunks[static_cast<size_t>(coordinate.y)].has_value();
+}
+
+auto World::LoadChunk(const glm::ivec3& coordinate, const Chunk& chunk, CompressedChunk compressedChunk) -> void
+{
+	PROFILE_SCOPE("World::LoadChunk");
+
+	if(IsChunkLoaded(coordinate))
+	{
+		return;
+	}
+
+	ChunkColumn* column = m_chunkGrid->Find(glm::xz(coordinate));
+
+	// Without space the chunk waits in the cache until its column scrolls into range again
+	if(column == nullptr || !m_allocator.Allocate(coordinate, chunk))
+	{
+		m_chunkCache.Store(coordinate, std::move(compressedChunk));
+
+		return;
+	}
+
+	column->Chunks[static_cast<size_t>(coordinate.y)] = std::move(compressedChunk);
+	++m_loadedChunkCount;
+
+	InvalidateLighting(coordinate, UpdateSkyHeights(coordinate, chunk));
 }
 
 auto WorldSettings::LoadFromConfig() -> WorldSettings
 {
 	return WorldSettings{
-		.LoadDistance = static_cast<uint8_t>(Config::Get<int64_t>("world", "iLoadDistance")),
+		.LoadDistance = static_cast<uint8_t>(std::clamp<int64_t>(Config::Get<int64_t>("world", "iLoadDistance"), 1, MaxLoadDistance)),
+		.Height = static_cast<int32_t>(std::clamp<int64_t>(Config::Get<int64_t>("world", "iHeight"), 1, MaxHeight)),
+		// By default keep every worker busy with one job queued up behind it.
+		.MaxChunkLoadingJobs = (Config::Get<int64_t>("world", "iMaxChunkLoadingJobs") > 0)
+			? static_cast<uint32_t>(Config::Get<int64_t>("world", "iMaxChunkLoadingJobs"))
+			: static_cast<uint32_t>(2u * JobSystem::GetWorkerCount()),
+		.ChunkLoadingBudget = std::max(static_cast<float>(Config::Get<double>("world", "fChunkLoadingBudget")), MinChunkLoadingBudget),
+		.HeightmapCacheSize = static_cast<uint32_t>(std::max<int64_t>(Config::Get<int64_t>("world", "iHeightmapCacheSize"), 1)),
+		.UnloadMargin = static_cast<uint8_t>(std::clamp<int64_t>(Config::Get<int64_t>("world", "iUnloadMargin"), 0, MaxLoadDistance)),
+		.ChunkCacheSize = static_cast<size_t>(std::max<int64_t>(Config::Get<int64_t>("world", "iChunkCacheSize"), 0)),
+		.PrefetchHorizon = std::max(static_cast<float>(Config::Get<double>("world", "fPrefetchHorizon")), 0.0f),
+		.Seed = static_cast<int32_t>(Config::Get<int64_t>("world", "iSeed")),
+		.ServerAddress = Config::Get<std::string>("world", "sServerAddress"),
 	};
 }
+
+auto WorldSettings::GetRandomSeed() -> int32_t
+{
+	std::random_device randomDevice;
+	std::mt19937_64 randomEngine(randomDevice());
+
+	return static_cast<int32_t>(randomEngine());
+}
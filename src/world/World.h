@@ -2,34 +2,155 @@
 
 #include "Camera.h"
 #include "Chunk.h"
+#include "ChunkCache.h"
+#include "ChunkLighting.h"
+#include "ChunkLoadQueue.h"
+#include "WorldGenerator.h"
+#include "../utility/Config.h"
+#include "../utility/JobSystem.h"
+#include "../utility/MpscQueue.h"
+#include "../utility/ToroidalGrid.h"
 
-#include <deque>
-#include <future>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
 #include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/hash.hpp>
 
-#include <fastnoiselite/FastNoiseLite.h>
-
 class ChunkAllocator;
+class ChunkClient;
 
 /**
  * @brief Holds settings related to a world.
  */
 struct WorldSettings
 {
+	/**
+	 * @brief The largest allowed load distance.
+	 */
+	static constexpr int32_t MaxLoadDistance = 16;
+
+	/**
+	 * @brief The largest allowed world height.
+	 */
+	static constexpr int32_t MaxHeight = 16;
+
+	/**
+	 * @brief The smallest allowed chunk loading budget in milliseconds.
+	 */
+	static constexpr float MinChunkLoadingBudget = 0.05f;
+
 	/**
 	 * @brief The number of chunks visible from the camera in one direction.
 	 */
 	uint8_t LoadDistance;
 
+	/**
+	 * @brief The height of the world in chunks.
+	 */
+	int32_t Height;
+
+	/**
+	 * @brief The maximum number of chunks being generated at the same time.
+	 */
+	uint32_t MaxChunkLoadingJobs;
+
+	/**
+	 * @brief The time the main thread may spend on launching chunk loading jobs per frame in milliseconds.
+	 *
+	 * The first chunk of a frame is always launched, so loading never stalls on a budget shorter than one launch.
+	 */
+	float ChunkLoadingBudget;
+
+	/**
+	 * @brief The maximum number of cached heightmap tiles.
+	 */
+	uint32_t HeightmapCacheSize;
+
+	/**
+	 * @brief The number of chunks beyond the load distance that stay loaded, so moving back and forth over a border doesn't reload them.
+	 */
+	uint8_t UnloadMargin;
+
+	/**
+	 * @brief The maximum size of the compressed unloaded chunks kept in memory in bytes.
+	 */
+	size_t ChunkCacheSize;
+
+	/**
+	 * @brief How far ahead the camera's movement is extrapolated to prefetch chunks in seconds. 0 disables prefetching.
+	 */
+	float PrefetchHorizon;
+
+	/**
+	 * @brief The seed of the world. 0 adopts the chunk server's or picks a random one.
+	 */
+	int32_t Seed;
+
+	/**
+	 * @brief The address of the chunk server as 'host:port'. Empty generates the chunks locally.
+	 */
+	std::string ServerAddress;
+
 	/**
 	 * @brief Loads the settings from the config file.
 	 * 
 	 * @return The settings loaded from the file.
 	 */
 	static auto LoadFromConfig() -> WorldSettings;
+
+	/**
+	 * @brief Picks a random seed for a world without one.
+	 *
+	 * @return The seed.
+	 */
+	[[nodiscard]] static auto GetRandomSeed() -> int32_t;
+};
+
+/**
+ * @brief Counts the streaming work of a world.
+ */
+struct WorldStatistics
+{
+	/**
+	 * @brief The number of chunks the generator finished, including prefetched ones.
+	 */
+	uint64_t GeneratedChunkCount;
+
+	/**
+	 * @brief The number of chunks restored from the cache.
+	 */
+	uint64_t RestoredChunkCount;
+
+	/**
+	 * @brief The number of chunks moved to the cache.
+	 */
+	uint64_t UnloadedChunkCount;
+
+	/**
+	 * @brief The number of times the lighting of a chunk was baked and uploaded.
+	 */
+	uint64_t BakedChunkCount;
+
+	/**
+	 * @brief The number of chunks in the chunk grid that are allocated in the chunk buffer.
+	 */
+	size_t LoadedChunkCount;
+
+	/**
+	 * @brief The number of chunks queued or being generated.
+	 */
+	size_t PendingChunkCount;
+
+	/**
+	 * @brief The size of the chunk cache in bytes.
+	 */
+	size_t CacheSize;
 };
 
 class World
@@ -44,7 +165,7 @@ public:
 	World(const WorldSettings& settings, ChunkAllocator& allocator);
 
 	/**
-	 * @brief Waits for the chunk generation jobs to finish.
+	 * @brief Cancels the pending chunk generation jobs and waits for the running ones to finish.
 	 */
 	~World();
 
@@ -53,6 +174,54 @@ public:
 	 */
 	auto Update() -> void;
 
+	/**
+	 * @brief Changes a voxel.
+	 *
+	 * Edits are collected per chunk and applied together on the next update. Edits of chunks that aren't loaded are dropped.
+	 *
+	 * @param position The position of the voxel.
+	 * @param material The new material of the voxel.
+	 */
+	auto SetVoxel(const glm::ivec3& position, Material material) -> void;
+
+	/**
+	 * @brief Changes every voxel inside a box.
+	 *
+	 * Edits are collected per chunk and applied together on the next update. Edits of chunks that aren't loaded are dropped.
+	 *
+	 * @param min The position of the first voxel of the box.
+	 * @param max The position of the last voxel of the box, inclusive.
+	 * @param material The new material of the voxels.
+	 */
+	auto EditRegion(const glm::ivec3& min, const glm::ivec3& max, Material material) -> void;
+
+	/**
+	 * @brief Retrieves the counters of the chunk streaming.
+	 *
+	 * @return The statistics of the world.
+	 */
+	[[nodiscard]] auto GetStatistics() const noexcept -> WorldStatistics;
+
+	/**
+	 * @brief Retrieves the seed the world is generated with.
+	 *
+	 * @return The chunk server's seed if one is connected, otherwise the seed of the settings or a random one if that is 0.
+	 */
+	[[nodiscard]] auto GetSeed() const noexcept -> int32_t
+	{
+		return m_seed;
+	}
+
+	/**
+	 * @brief Retrieves the generator of the world.
+	 *
+	 * @return A const reference to the generator.
+	 */
+	[[nodiscard]] auto GetGenerator() const noexcept -> const WorldGenerator&
+	{
+		return *m_generator;
+	}
+
 	/**
 	 * @brief Retrieves the world's camera.
 	 * 
@@ -74,27 +243,334 @@ public:
 	}
 
 private:
+	/**
+	 * @brief A chunk being generated by the job system.
+	 */
+	struct ChunkLoadingJob
+	{
+		/**
+		 * @brief Identifies the job's result, the chunk may have been requested again after the job was cancelled.
+		 */
+		uint64_t Id;
+
+		JobHandle Handle;
+		CancellationToken Cancellation;
+	};
+
+	/**
+	 * @brief A chunk finished by the job system, waiting to be stored by the main thread.
+	 */
+	struct GeneratedChunk
+	{
+		uint64_t JobId;
+		glm::ivec3 Coordinate;
+		Chunk Data;
+		CompressedChunk CompressedData;
+		bool IsPrefetched;
+	};
+
+	/**
+	 * @brief The loaded chunks of a chunk column.
+	 */
+	struct ChunkColumn
+	{
+		/**
+		 * @brief The compressed copies of the loaded chunks, indexed by height.
+		 */
+		std::array<std::optional<CompressedChunk>, WorldSettings::MaxHeight> Chunks;
+
+		/**
+		 * @brief The heights of the voxel columns of the loaded chunks, indexed like @ref Chunks.
+		 */
+		std::array<ChunkHeights, WorldSettings::MaxHeight> Heights;
+
+		/**
+		 * @brief The height above the highest solid voxel of every voxel column over all loaded chunks, indexed by 'z * Chunk::Size + x'.
+		 */
+		std::array<int32_t, Chunk::Size * Chunk::Size> SkyHeights;
+	};
+
+	/**
+	 * @brief The lighting of a chunk baked by the job system, waiting to be uploaded by the main thread.
+	 */
+	struct BakedLighting
+	{
+		glm::ivec3 Coordinate;
+		std::vector<uint8_t> Lighting;
+	};
+
+	/**
+	 * @brief A box of voxels set to the same material, in the local coordinates of a chunk.
+	 */
+	struct VoxelEdit
+	{
+		glm::u8vec3 Min;
+
+		/**
+		 * @brief The last voxel of the box, inclusive.
+		 */
+		glm::u8vec3 Max;
+
+		Material Value;
+	};
+
 	WorldSettings m_settings;
+
+	/**
+	 * @brief The handles of the settings that apply while running, they overwrite the ones in @ref m_settings when they change.
+	 */
+	ConfigValue<int64_t> m_loadDistanceConfig;
+	ConfigValue<int64_t> m_unloadMarginConfig;
+	ConfigValue<double> m_chunkLoadingBudgetConfig;
+	ConfigValue<double> m_prefetchHorizonConfig;
+
+	int32_t m_seed;
 	Camera m_camera;
 	ChunkAllocator& m_allocator;
-	FastNoiseLite m_noise;
-	std::deque<glm::ivec2> m_neededChunks;
-	std::vector<std::future<void>> m_chunkLoadingJobs;
-	std::unordered_set<glm::ivec2> m_loadedChunks;
+	std::unique_ptr<WorldGenerator> m_generator;
+	ChunkLoadQueue m_chunkLoadQueue;
+	std::unordered_map<glm::ivec3, ChunkLoadingJob> m_chunkLoadingJobs;
+	uint64_t m_nextChunkLoadingJobId = 0u;
 
 	/**
-	 * @brief Loads a chunk.
-	 * 
+	 * @brief The cancelled jobs which may still be running.
+	 */
+	std::vector<JobHandle> m_cancelledJobs;
+
+	/**
+	 * @brief The chunk columns within the load distance extended by the unload margin, centered on the camera.
+	 *
+	 * Empty until the first update.
+	 */
+	std::optional<ToroidalGrid<ChunkColumn>> m_chunkGrid;
+
+	/**
+	 * @brief The edits of every chunk since the last update, in the order they were made.
+	 */
+	std::unordered_map<glm::ivec3, std::vector<VoxelEdit>> m_voxelEdits;
+	uint64_t m_generatedChunkCount = 0u;
+	uint64_t m_restoredChunkCount = 0u;
+	uint64_t m_unloadedChunkCount = 0u;
+	size_t m_loadedChunkCount = 0u;
+	uint64_t m_editedChunkCount = 0u;
+
+	/**
+	 * @brief The total number of bytes written to the chunk buffer by edits.
+	 */
+	uint64_t m_editUploadSize = 0u;
+	ChunkCache m_chunkCache;
+
+	glm::vec3 m_previousCameraPosition;
+	float m_previousCameraYaw;
+	glm::vec3 m_cameraVelocity = glm::vec3(0.0f);
+	float m_cameraYawRate = 0.0f;
+
+	/**
+	 * @brief The chunk columns outside the load distance the camera is predicted to see within the prefetch horizon.
+	 */
+	std::unordered_set<glm::ivec2> m_prefetchColumns;
+	uint64_t m_prefetchRequestCount = 0u;
+	uint64_t m_prefetchHitCount = 0u;
+	uint64_t m_prefetchMissCount = 0u;
+	MpscQueue<GeneratedChunk> m_generatedChunks;
+
+	/**
+	 * @brief The loaded chunks whose lighting is outdated.
+	 */
+	std::unordered_set<glm::ivec3> m_dirtyLighting;
+	std::unordered_map<glm::ivec3, JobHandle> m_lightingJobs;
+	uint64_t m_bakedChunkCount = 0u;
+	MpscQueue<BakedLighting> m_bakedLighting;
+
+	/**
+	 * @brief Requests the chunks from a chunk server instead of the generator, if one is connected.
+	 *
+	 * Declared after the queue its thread pushes into, so it is destroyed first.
+	 */
+	std::unique_ptr<ChunkClient> m_chunkClient;
+
+	/**
+	 * @brief Calculates the load priority of a chunk.
+	 *
+	 * Chunks in front of the camera come first, the rest follows by distance and prefetched chunks come last.
+	 *
 	 * @param coordinate The coordinate of the chunk.
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 *
+	 * @return The priority of the chunk or 'std::nullopt' if it is out of range.
 	 */
-	auto LoadChunk(glm::ivec2 coordinate) -> void;
+	[[nodiscard]] auto GetChunkLoadPriority(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> std::optional<float>;
 
 	/**
-	 * @brief Generates a chunk.
-	 * 
+	 * @brief Updates the smoothed velocity and turn rate of the camera.
+	 */
+	auto UpdateCameraMotion() -> void;
+
+	/**
+	 * @brief Centers the chunk grid on the camera.
+	 *
+	 * Unloads the columns scrolling out of the grid and requests the columns scrolling into the load distance.
+	 * Rebuilds the grid when the load distance changed.
+	 *
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 *
+	 * @return 'true' if the grid moved, otherwise 'false'.
+	 */
+	auto UpdateChunkGrid(const glm::ivec2& cameraCoordinate) -> bool;
+
+	/**
+	 * @brief Queues the chunks of a column which are neither loaded nor being loaded.
+	 *
+	 * @param column The coordinate of the column.
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 * @param skipCached Whether chunks in the cache are skipped as well.
+	 */
+	auto RequestChunkColumn(const glm::ivec2& column, const glm::ivec2& cameraCoordinate, bool skipCached) -> void;
+
+	/**
+	 * @brief Moves the chunks of a column to the cache and cancels its jobs, unless the column is prefetched.
+	 *
+	 * @param coordinate The coordinate of the column.
+	 * @param column The column.
+	 */
+	auto UnloadChunkColumn(const glm::ivec2& coordinate, ChunkColumn& column) -> void;
+
+	/**
+	 * @brief Cancels a job and keeps its handle until it finished.
+	 *
 	 * @param coordinate The coordinate of the chunk.
-	 * 
-	 * @return The generated chunk data.
 	 */
-	auto GenerateChunk(const glm::ivec2& coordinate) const -> Chunk;
+	auto CancelChunkLoadingJob(const glm::ivec3& coordinate) -> void;
+
+	/**
+	 * @brief Falls back to local generation after the chunk server was lost, requeuing its requests.
+	 */
+	auto DisconnectChunkServer() -> void;
+
+	/**
+	 * @brief Applies the collected edits to the loaded chunks, rebuilding every edited chunk once.
+	 */
+	auto ApplyVoxelEdits() -> void;
+
+	/**
+	 * @brief Uploads the baked lighting and bakes the dirty chunks whose surroundings finished loading.
+	 *
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 */
+	auto UpdateLighting(const glm::ivec2& cameraCoordinate) -> void;
+
+	/**
+	 * @brief Marks the lighting of a changed chunk and of the chunks it may shadow as outdated.
+	 *
+	 * @param coordinate The coordinate of the changed chunk.
+	 * @param hasSkyChanged Whether the sky heights of the chunk's column changed, which affects every chunk of the surrounding columns.
+	 */
+	auto InvalidateLighting(const glm::ivec3& coordinate, bool hasSkyChanged) -> void;
+
+	/**
+	 * @brief Stores the heights of a chunk and recalculates the sky heights of its column.
+	 *
+	 * @param coordinate The coordinate of the loaded chunk.
+	 * @param chunk The chunk.
+	 *
+	 * @return 'true' if the sky heights changed, otherwise 'false'.
+	 */
+	auto UpdateSkyHeights(const glm::ivec3& coordinate, const Chunk& chunk) -> bool;
+
+	/**
+	 * @brief Copies the chunks and the sky heights a chunk's lighting depends on.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return The input of the bake.
+	 */
+	[[nodiscard]] auto GetLightingInput(const glm::ivec3& coordinate) const -> ChunkLightingInput;
+
+	/**
+	 * @brief Checks whether a chunk the lighting of a chunk depends on is still being loaded.
+	 *
+	 * Baking waits for the surroundings, so streaming in a region bakes each chunk about once.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 *
+	 * @return 'true' if a chunk of the surrounding columns within the load distance is queued or being loaded, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsLightingPending(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> bool;
+
+	/**
+	 * @brief Collects the chunk columns along the extrapolated path of the camera.
+	 *
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 *
+	 * @return 'true' if the columns may have changed, otherwise 'false'.
+	 */
+	auto UpdatePrefetchColumns(const glm::ivec2& cameraCoordinate) -> bool;
+
+	/**
+	 * @brief Checks whether the camera moves fast enough for prefetching.
+	 *
+	 * @return 'true' if prefetching is enabled and the camera is moving, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsPrefetching() const -> bool;
+
+	/**
+	 * @brief Checks whether a chunk is within the load distance.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 *
+	 * @return 'true' if the chunk should be loaded, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsChunkInLoadRange(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> bool;
+
+	/**
+	 * @brief Checks whether a chunk is close enough to stay loaded.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param cameraCoordinate The coordinate of the chunk containing the camera.
+	 *
+	 * @return 'true' if the chunk is within the load distance extended by the unload margin, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsChunkRetained(const glm::ivec3& coordinate, const glm::ivec2& cameraCoordinate) const -> bool;
+
+	/**
+	 * @brief Checks whether a chunk is loaded.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return 'true' if the chunk is loaded, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsChunkLoaded(const glm::ivec3& coordinate) const -> bool;
+
+	/**
+	 * @brief Checks whether a chunk may be visible from the camera.
+	 *
+	 * Conservative test against a cone around the horizontal view direction.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return 'true' if the chunk may be visible, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsChunkInView(const glm::ivec3& coordinate) const -> bool;
+
+	/**
+	 * @brief Checks whether a chunk may be visible from a point looking in a horizontal direction.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param position The position of the viewer.
+	 * @param forwardXZ The horizontal view direction, doesn't have to be normalized.
+	 *
+	 * @return 'true' if the chunk may be visible, otherwise 'false'.
+	 */
+	[[nodiscard]] auto IsChunkInView(const glm::ivec3& coordinate, const glm::vec3& position, const glm::vec2& forwardXZ) const -> bool;
+
+	/**
+	 * @brief Stores a generated or restored chunk, or caches it if it can't be allocated.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param chunk The chunk.
+	 * @param compressedChunk The compressed copy of the chunk, kept until the chunk is unloaded.
+	 */
+	auto LoadChunk(const glm::ivec3& coordinate, const Chunk& chunk, CompressedChunk compressedChunk) -> void;
 };
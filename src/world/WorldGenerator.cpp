@@ -0,0 +1,398 @@
+#include "WorldGenerator.h"
+
+#include "../utility/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace
+{
+	constexpr int32_t ChunkSize = static_cast<int32_t>(Chunk::Size);
+
+	/**
+	 * @brief The number of voxels kept between the caves and the surface.
+	 */
+	constexpr int32_t CaveSurfaceMargin = 6;
+
+	/**
+	 * @brief The distance between the cave noise samples in voxels, the rest is interpolated.
+	 */
+	constexpr int32_t CaveLatticeSpacing = 4;
+	constexpr int32_t CaveLatticeSize = ChunkSize / CaveLatticeSpacing + 1;
+	static_assert(ChunkSize % CaveLatticeSpacing == 0, "The chunk size must be a multiple of the cave lattice spacing.");
+
+	constexpr float CaveThreshold = 0.45f;
+
+	/**
+	 * @brief The number of voxels below the surface painted by the surface stage.
+	 */
+	constexpr int32_t SurfaceDepth = 4;
+
+	constexpr int32_t TreeTrunkHeight = 5;
+	constexpr int32_t TreeCanopyRadius = 2;
+
+	/**
+	 * @brief The chance of a tree growing on a column, in thousandths.
+	 */
+	constexpr uint32_t TreeDensity[] = {
+		2u, // Plains
+		0u, // Desert
+		20u, // Forest
+	};
+
+	auto GetVoxelIndex(int32_t x, int32_t y, int32_t z) noexcept -> size_t
+	{
+		return static_cast<size_t>((z * ChunkSize + y) * ChunkSize + x);
+	}
+
+	auto HashColumn(int32_t seed, int32_t x, int32_t z) noexcept -> uint32_t
+	{
+		uint32_t hash = static_cast<uint32_t>(seed) ^ (static_cast<uint32_t>(x) * 501125321u) ^ (static_cast<uint32_t>(z) * 1136930381u);
+		hash *= 0x27d4eb2du;
+		hash ^= hash >> 15u;
+
+		return hash;
+	}
+}
+
+constexpr std::array<WorldGenerator::StageDescription, static_cast<size_t>(GenerationStage::Count)> WorldGenerator::s_stages = {
+	StageDescription{ .Name = "Height", .NeighbourRadius = 0, .Run = &WorldGenerator::GenerateHeight },
+	StageDescription{ .Name = "Fill", .NeighbourRadius = 0, .Run = &WorldGenerator::FillTerrain },
+	StageDescription{ .Name = "Caves", .NeighbourRadius = 0, .Run = &WorldGenerator::CarveCaves },
+	StageDescription{ .Name = "Surface", .NeighbourRadius = 0, .Run = &WorldGenerator::PaintSurface },
+	StageDescription{ .Name = "Decoration", .NeighbourRadius = 1, .Run = &WorldGenerator::PlaceDecorations },
+	StageDescription{ .Name = "Build", .NeighbourRadius = 0, .Run = &WorldGenerator::BuildChunk },
+};
+
+WorldGenerator::WorldGenerator(int32_t seed, int32_t terrainHeight, size_t heightmapCacheSize)
+	: m_seed(seed), m_heightmap(std::make_unique<HeightmapGenerator>(seed, terrainHeight, heightmapCacheSize))
+{
+	m_caveNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+	m_caveNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
+	m_caveNoise.SetFractalOctaves(2);
+	m_caveNoise.SetFrequency(0.03f);
+	m_caveNoise.SetSeed(seed + 2);
+}
+
+auto WorldGenerator::Schedule(
+	const glm::ivec3& coordinate,
+	JobPriority priority,
+	const CancellationToken& token,
+	std::function<void(Chunk&&)> onGenerated) -> JobHandle
+{
+	auto state = std::make_shared<ChunkGenerationState>();
+	state->Coordinate = coordinate;
+
+	JobHandle handle;
+	for(size_t stage = 0u; stage < s_stages.size(); ++stage)
+	{
+		auto runStage = [this, state, stage] () -> void
+			{
+				RunStage(static_cast<GenerationStage>(stage), *state);
+			};
+
+		handle = handle
+			? JobSystem::Then(handle, std::move(runStage), priority, token)
+			: JobSystem::Schedule(std::move(runStage), priority, token);
+	}
+
+	return JobSystem::Then(
+		handle,
+		[state, onGenerated = std::move(onGenerated)] () -> void
+		{
+			onGenerated(std::move(state->Result));
+		},
+		priority,
+		token);
+}
+
+auto WorldGenerator::Generate(const glm::ivec3& coordinate) -> Chunk
+{
+	ChunkGenerationState state;
+	state.Coordinate = coordinate;
+
+	for(size_t stage = 0u; stage < s_stages.size(); ++stage)
+	{
+		RunStage(static_cast<GenerationStage>(stage), state);
+	}
+
+	return std::move(state.Result);
+}
+
+auto WorldGenerator::GetStageStatistics(GenerationStage stage) const noexcept -> GenerationStageStatistics
+{
+	const StageCounters& counters = m_counters[static_cast<size_t>(stage)];
+
+	return GenerationStageStatistics{
+		.RunCount = counters.RunCount.load(std::memory_order_relaxed),
+		.SkipCount = counters.SkipCount.load(std::memory_order_relaxed),
+		.TotalTime = static_cast<double>(counters.TotalNanoseconds.load(std::memory_order_relaxed)) / 1'000'000.0,
+	};
+}
+
+auto WorldGenerator::GetStageName(GenerationStage stage) noexcept -> const char*
+{
+	return s_stages[static_cast<size_t>(stage)].Name;
+}
+
+auto WorldGenerator::RunStage(GenerationStage stage, ChunkGenerationState& state) -> void
+{
+	const StageDescription& description = s_stages[static_cast<size_t>(stage)];
+	StageCounters& counters = m_counters[static_cast<size_t>(stage)];
+
+	PROFILE_SCOPE(description.Name);
+
+	auto start = std::chrono::steady_clock::now();
+	bool hasRun = (this->*description.Run)(state);
+	auto duration = std::chrono::steady_clock::now() - start;
+
+	(hasRun ? counters.RunCount : counters.SkipCount).fetch_add(1u, std::memory_order_relaxed);
+	counters.TotalNanoseconds.fetch_add(
+		static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()),
+		std::memory_order_relaxed);
+}
+
+auto WorldGenerator::GenerateHeight(ChunkGenerationState& state) const -> bool
+{
+	constexpr int32_t radius = std::ranges::max(s_stages, {}, &StageDescription::NeighbourRadius).NeighbourRadius;
+	static_assert(radius <= MaxNeighbourRadius, "The tiles only hold the columns within the max neighbour radius.");
+
+	for(int32_t dz = -radius; dz <= radius; ++dz)
+	{
+		for(int32_t dx = -radius; dx <= radius; ++dx)
+		{
+			state.Tiles[GetTileIndex(dx, dz)] = m_heightmap->GetTile(glm::ivec2(state.Coordinate.x + dx, state.Coordinate.z + dz));
+		}
+	}
+
+	state.Voxels.assign(Chunk::Size * Chunk::Size * Chunk::Size, static_cast<uint8_t>(Material::Air));
+
+	return true;
+}
+
+auto WorldGenerator::FillTerrain(ChunkGenerationState& state) const -> bool
+{
+	const HeightmapTile& tile = *state.Tiles[GetTileIndex(0, 0)];
+	int32_t bottom = state.Coordinate.y * ChunkSize;
+
+	if(tile.MaxHeight < bottom)
+	{
+		return false;
+	}
+
+	if(tile.MinHeight >= bottom + ChunkSize - 1)
+	{
+		std::ranges::fill(state.Voxels, static_cast<uint8_t>(Material::Stone));
+
+		return true;
+	}
+
+	for(int32_t z = 0; z < ChunkSize; ++z)
+	{
+		for(int32_t x = 0; x < ChunkSize; ++x)
+		{
+			int32_t h = tile.Heights[z * ChunkSize + x] - bottom;
+
+			for(int32_t y = 0; y <= glm::min(h, ChunkSize - 1); ++y)
+			{
+				state.Voxels[GetVoxelIndex(x, y, z)] = static_cast<uint8_t>(Material::Stone);
+			}
+		}
+	}
+
+	return true;
+}
+
+auto WorldGenerator::CarveCaves(ChunkGenerationState& state) const -> bool
+{
+	const HeightmapTile& tile = *state.Tiles[GetTileIndex(0, 0)];
+	int32_t bottom = state.Coordinate.y * ChunkSize;
+
+	// The lowest voxel of the world is never carved so the caves can't be seen through
+	int32_t minY = (state.Coordinate.y == 0) ? 1 : 0;
+	int32_t maxY = glm::min(tile.MaxHeight - CaveSurfaceMargin - bottom, ChunkSize - 1);
+	if(maxY < minY)
+	{
+		return false;
+	}
+
+	// Only the lattice layers up to the highest carvable voxel are sampled
+	int32_t latticeHeight = maxY / CaveLatticeSpacing + 2;
+
+	std::array<float, CaveLatticeSize * CaveLatticeSize * CaveLatticeSize> lattice;
+	for(int32_t z = 0; z < CaveLatticeSize; ++z)
+	{
+		for(int32_t y = 0; y < latticeHeight; ++y)
+		{
+			for(int32_t x = 0; x < CaveLatticeSize; ++x)
+			{
+				glm::vec3 p = glm::vec3(glm::ivec3(x, y, z) * CaveLatticeSpacing + state.Coordinate * ChunkSize);
+
+				// Squashed vertically so the caves are wider than they are tall
+				lattice[(z * CaveLatticeSize + y) * CaveLatticeSize + x] = m_caveNoise.GetNoise(p.x, p.y * 1.6f, p.z);
+			}
+		}
+	}
+
+	for(int32_t z = 0; z < ChunkSize; ++z)
+	{
+		for(int32_t x = 0; x < ChunkSize; ++x)
+		{
+			int32_t columnMaxY = glm::min(tile.Heights[z * ChunkSize + x] - CaveSurfaceMargin - bottom, maxY);
+
+			for(int32_t y = minY; y <= columnMaxY; ++y)
+			{
+				glm::ivec3 cell = glm::ivec3(x, y, z) / CaveLatticeSpacing;
+				glm::vec3 t = glm::vec3(glm::ivec3(x, y, z) % CaveLatticeSpacing) / static_cast<float>(CaveLatticeSpacing);
+
+				auto sample = [&] (int32_t dx, int32_t dy, int32_t dz) -> float
+					{
+						return lattice[((cell.z + dz) * CaveLatticeSize + (cell.y + dy)) * CaveLatticeSize + (cell.x + dx)];
+					};
+
+				float value = glm::mix(
+					glm::mix(glm::mix(sample(0, 0, 0), sample(1, 0, 0), t.x), glm::mix(sample(0, 1, 0), sample(1, 1, 0), t.x), t.y),
+					glm::mix(glm::mix(sample(0, 0, 1), sample(1, 0, 1), t.x), glm::mix(sample(0, 1, 1), sample(1, 1, 1), t.x), t.y),
+					t.z);
+
+				if(value > CaveThreshold)
+				{
+					state.Voxels[GetVoxelIndex(x, y, z)] = static_cast<uint8_t>(Material::Air);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+auto WorldGenerator::PaintSurface(ChunkGenerationState& state) const -> bool
+{
+	const HeightmapTile& tile = *state.Tiles[GetTileIndex(0, 0)];
+	int32_t bottom = state.Coordinate.y * ChunkSize;
+
+	if(tile.MaxHeight < bottom || tile.MinHeight - SurfaceDepth >= bottom + ChunkSize - 1)
+	{
+		return false;
+	}
+
+	for(int32_t z = 0; z < ChunkSize; ++z)
+	{
+		for(int32_t x = 0; x < ChunkSize; ++x)
+		{
+			int32_t h = tile.Heights[z * ChunkSize + x] - bottom;
+			Biome biome = tile.Biomes[z * ChunkSize + x];
+
+			for(int32_t y = glm::max(h - SurfaceDepth + 1, 0); y <= glm::min(h, ChunkSize - 1); ++y)
+			{
+				uint8_t& voxel = state.Voxels[GetVoxelIndex(x, y, z)];
+				if(voxel == static_cast<uint8_t>(Material::Air))
+				{
+					continue;
+				}
+
+				if(biome == Biome::Desert)
+				{
+					voxel = static_cast<uint8_t>(Material::Sand);
+				}
+				else
+				{
+					voxel = static_cast<uint8_t>((y == h) ? Material::Grass : Material::Dirt);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+auto WorldGenerator::PlaceDecorations(ChunkGenerationState& state) const -> bool
+{
+	constexpr int32_t treeHeight = TreeTrunkHeight + 1;
+
+	int32_t bottom = state.Coordinate.y * ChunkSize;
+
+	int32_t minHeight = std::numeric_limits<int32_t>::max();
+	int32_t maxHeight = std::numeric_limits<int32_t>::min();
+	for(const auto& tile : state.Tiles)
+	{
+		minHeight = glm::min(minHeight, tile->MinHeight);
+		maxHeight = glm::max(maxHeight, tile->MaxHeight);
+	}
+
+	// Trees occupy the voxels from right above the surface to the top of the canopy
+	if(maxHeight + treeHeight < bottom || minHeight + 1 > bottom + ChunkSize - 1)
+	{
+		return false;
+	}
+
+	auto setVoxel = [&] (int32_t x, int32_t y, int32_t z, Material material) -> void
+		{
+			if(x < 0 || y < 0 || z < 0 || x >= ChunkSize || y >= ChunkSize || z >= ChunkSize)
+			{
+				return;
+			}
+
+			uint8_t& voxel = state.Voxels[GetVoxelIndex(x, y, z)];
+			if(voxel == static_cast<uint8_t>(Material::Air) || material == Material::Wood)
+			{
+				voxel = static_cast<uint8_t>(material);
+			}
+		};
+
+	// Trees rooted in the neighbouring columns may reach into this chunk
+	for(int32_t z = -TreeCanopyRadius; z < ChunkSize + TreeCanopyRadius; ++z)
+	{
+		for(int32_t x = -TreeCanopyRadius; x < ChunkSize + TreeCanopyRadius; ++x)
+		{
+			int32_t tileX = (x < 0) ? 0 : ((x >= ChunkSize) ? 2 : 1);
+			int32_t tileZ = (z < 0) ? 0 : ((z >= ChunkSize) ? 2 : 1);
+			const HeightmapTile& tile = *state.Tiles[GetTileIndex(tileX - 1, tileZ - 1)];
+
+			int32_t columnIndex = (z - (tileZ - 1) * ChunkSize) * ChunkSize + (x - (tileX - 1) * ChunkSize);
+
+			int32_t h = tile.Heights[columnIndex] - bottom;
+			if(h + treeHeight < 0 || h + 1 >= ChunkSize)
+			{
+				continue;
+			}
+
+			glm::ivec2 worldColumn = glm::ivec2(x, z) + glm::ivec2(state.Coordinate.x, state.Coordinate.z) * ChunkSize;
+			if(HashColumn(m_seed, worldColumn.x, worldColumn.y) % 1000u >= TreeDensity[static_cast<size_t>(tile.Biomes[columnIndex])])
+			{
+				continue;
+			}
+
+			for(int32_t y = h + TreeTrunkHeight - 2; y <= h + treeHeight; ++y)
+			{
+				int32_t radius = (y < h + TreeTrunkHeight) ? TreeCanopyRadius : TreeCanopyRadius - 1;
+
+				for(int32_t dz = -radius; dz <= radius; ++dz)
+				{
+					for(int32_t dx = -radius; dx <= radius; ++dx)
+					{
+						setVoxel(x + dx, y, z + dz, Material::Leaves);
+					}
+				}
+			}
+
+			for(int32_t y = h + 1; y <= h + TreeTrunkHeight; ++y)
+			{
+				setVoxel(x, y, z, Material::Wood);
+			}
+		}
+	}
+
+	return true;
+}
+
+auto WorldGenerator::BuildChunk(ChunkGenerationState& state) const -> bool
+{
+	state.Result.Build(state.Voxels);
+
+	state.Voxels.clear();
+	state.Voxels.shrink_to_fit();
+
+	return true;
+}
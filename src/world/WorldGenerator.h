@@ -0,0 +1,248 @@
+#pragma once
+
+#include "Chunk.h"
+#include "Heightmap.h"
+#include "../utility/JobSystem.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <fastnoiselite/FastNoiseLite.h>
+
+/**
+ * @brief The steps of generating a chunk, in the order they run.
+ */
+enum class GenerationStage : uint8_t
+{
+	Height,
+	Fill,
+	Caves,
+	Surface,
+	Decoration,
+	Build,
+	Count,
+};
+
+/**
+ * @brief The accumulated cost of a generation stage.
+ */
+struct GenerationStageStatistics
+{
+	/**
+	 * @brief The number of chunks the stage did work on.
+	 */
+	uint64_t RunCount;
+
+	/**
+	 * @brief The number of chunks the stage skipped because it couldn't change them.
+	 */
+	uint64_t SkipCount;
+
+	/**
+	 * @brief The total time spent in the stage in milliseconds, including the skipped runs.
+	 */
+	double TotalTime;
+};
+
+/**
+ * @brief Generates chunks in stages which run as separate jobs.
+ *
+ * Every stage declares the radius of neighbouring chunk columns it reads, the height stage prepares all of them up front.
+ */
+class WorldGenerator
+{
+public:
+	/**
+	 * @brief Sets up the noise of every stage.
+	 *
+	 * @param seed The seed of the world.
+	 * @param terrainHeight The height of the terrain in voxels.
+	 * @param heightmapCacheSize The maximum number of cached heightmap tiles.
+	 */
+	WorldGenerator(int32_t seed, int32_t terrainHeight, size_t heightmapCacheSize);
+
+	/**
+	 * @brief Schedules the stages of a chunk as a chain of jobs.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 * @param priority The priority of every stage.
+	 * @param token Cancels the stages which haven't started yet.
+	 * @param onGenerated Called from the last job with the finished chunk, which it may take.
+	 *
+	 * @return A handle to the last job.
+	 */
+	auto Schedule(
+		const glm::ivec3& coordinate,
+		JobPriority priority,
+		const CancellationToken& token,
+		std::function<void(Chunk&&)> onGenerated) -> JobHandle;
+
+	/**
+	 * @brief Runs every stage of a chunk on the calling thread.
+	 *
+	 * @param coordinate The coordinate of the chunk.
+	 *
+	 * @return The generated chunk.
+	 */
+	[[nodiscard]] auto Generate(const glm::ivec3& coordinate) -> Chunk;
+
+	/**
+	 * @brief Retrieves the accumulated cost of a stage.
+	 *
+	 * @param stage The stage.
+	 *
+	 * @return The statistics of the stage.
+	 */
+	[[nodiscard]] auto GetStageStatistics(GenerationStage stage) const noexcept -> GenerationStageStatistics;
+
+	/**
+	 * @brief Retrieves the display name of a stage.
+	 *
+	 * @param stage The stage.
+	 *
+	 * @return The name of the stage.
+	 */
+	[[nodiscard]] static auto GetStageName(GenerationStage stage) noexcept -> const char*;
+
+private:
+	/**
+	 * @brief The largest radius of neighbouring chunk columns a stage may read, see @ref StageDescription::NeighbourRadius.
+	 */
+	static constexpr int32_t MaxNeighbourRadius = 1;
+	static constexpr int32_t NeighbourTileWidth = 2 * MaxNeighbourRadius + 1;
+
+	/**
+	 * @brief The intermediate result of a chunk passed between the stages.
+	 */
+	struct ChunkGenerationState
+	{
+		glm::ivec3 Coordinate;
+
+		/**
+		 * @brief The heightmap tiles of the surrounding columns, indexed by @ref GetTileIndex.
+		 */
+		std::array<std::shared_ptr<const HeightmapTile>, static_cast<size_t>(NeighbourTileWidth * NeighbourTileWidth)> Tiles;
+
+		/**
+		 * @brief The dense voxels of the chunk, indexed by '(z * Chunk::Size + y) * Chunk::Size + x'.
+		 */
+		std::vector<uint8_t> Voxels;
+
+		Chunk Result;
+	};
+
+	/**
+	 * @brief Describes a stage.
+	 */
+	struct StageDescription
+	{
+		const char* Name;
+
+		/**
+		 * @brief The radius of the neighbouring chunk columns whose heightmap the stage reads, at most @ref MaxNeighbourRadius.
+		 */
+		int32_t NeighbourRadius;
+
+		/**
+		 * @brief Runs the stage, returns 'false' if it was skipped.
+		 */
+		bool (WorldGenerator::*Run)(ChunkGenerationState&) const;
+	};
+
+	/**
+	 * @brief The accumulated cost of a stage, updated from the worker threads.
+	 */
+	struct StageCounters
+	{
+		std::atomic<uint64_t> RunCount = 0u;
+		std::atomic<uint64_t> SkipCount = 0u;
+		std::atomic<uint64_t> TotalNanoseconds = 0u;
+	};
+
+	static const std::array<StageDescription, static_cast<size_t>(GenerationStage::Count)> s_stages;
+
+	int32_t m_seed;
+	std::unique_ptr<HeightmapGenerator> m_heightmap;
+	FastNoiseLite m_caveNoise;
+	std::array<StageCounters, static_cast<size_t>(GenerationStage::Count)> m_counters;
+
+	/**
+	 * @brief Runs a stage and records its cost.
+	 *
+	 * @param stage The stage.
+	 * @param state The chunk the stage works on.
+	 */
+	auto RunStage(GenerationStage stage, ChunkGenerationState& state) -> void;
+
+	/**
+	 * @brief Retrieves the index of a neighbouring column in @ref ChunkGenerationState::Tiles.
+	 *
+	 * @param dx The offset on the x axis, within @ref MaxNeighbourRadius.
+	 * @param dz The offset on the z axis, within @ref MaxNeighbourRadius.
+	 *
+	 * @return The index.
+	 */
+	[[nodiscard]] static constexpr auto GetTileIndex(int32_t dx, int32_t dz) noexcept -> size_t
+	{
+		return static_cast<size_t>((dz + MaxNeighbourRadius) * NeighbourTileWidth + (dx + MaxNeighbourRadius));
+	}
+
+	/**
+	 * @brief Fetches the heightmap tiles of the chunk column and its neighbours.
+	 *
+	 * @param state The chunk the stage works on.
+	 *
+	 * @return Always 'true'.
+	 */
+	auto GenerateHeight(ChunkGenerationState& state) const -> bool;
+
+	/**
+	 * @brief Fills everything below the surface with stone.
+	 *
+	 * @param state The chunk the stage works on.
+	 *
+	 * @return 'false' if the chunk is above the surface.
+	 */
+	auto FillTerrain(ChunkGenerationState& state) const -> bool;
+
+	/**
+	 * @brief Carves caves using 3D noise sampled on a coarse lattice.
+	 *
+	 * @param state The chunk the stage works on.
+	 *
+	 * @return 'false' if the chunk is too close to or above the surface to have caves.
+	 */
+	auto CarveCaves(ChunkGenerationState& state) const -> bool;
+
+	/**
+	 * @brief Replaces the top layers of the terrain by the materials of the biome.
+	 *
+	 * @param state The chunk the stage works on.
+	 *
+	 * @return 'false' if the chunk doesn't contain the surface.
+	 */
+	auto PaintSurface(ChunkGenerationState& state) const -> bool;
+
+	/**
+	 * @brief Places trees, including the parts of trees rooted in the neighbouring columns.
+	 *
+	 * @param state The chunk the stage works on.
+	 *
+	 * @return 'false' if no tree can reach the chunk.
+	 */
+	auto PlaceDecorations(ChunkGenerationState& state) const -> bool;
+
+	/**
+	 * @brief Builds the octree from the voxels.
+	 *
+	 * @param state The chunk the stage works on.
+	 *
+	 * @return Always 'true'.
+	 */
+	auto BuildChunk(ChunkGenerationState& state) const -> bool;
+};
@@ -0,0 +1,222 @@
+#include "Tests.h"
+
+#include "../src/utility/ChunkAllocator.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace
+{
+	constexpr size_t ChunkSize = Chunk::Size;
+	constexpr uint32_t FramesInFlight = 3u;
+
+	auto GetVoxelIndex(size_t x, size_t y, size_t z) noexcept -> size_t
+	{
+		return (z * ChunkSize + y) * ChunkSize + x;
+	}
+
+	/**
+	 * @brief Creates rolling stone terrain with a layer of grass on top.
+	 */
+	auto CreateTerrain() -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> voxels(ChunkSize * ChunkSize * ChunkSize, static_cast<uint8_t>(Material::Air));
+
+		for(size_t z = 0u; z < ChunkSize; ++z)
+		{
+			for(size_t x = 0u; x < ChunkSize; ++x)
+			{
+				size_t height = 8u + (x * 7u + z * 3u) % 11u;
+				for(size_t y = 0u; y <= height; ++y)
+				{
+					voxels[GetVoxelIndex(x, y, z)] = static_cast<uint8_t>((y == height) ? Material::Grass : Material::Stone);
+				}
+			}
+		}
+
+		return voxels;
+	}
+
+	/**
+	 * @brief Retrieves the allocation of a chunk.
+	 */
+	auto FindAllocation(const ChunkAllocator& allocator, const glm::ivec3& coordinate) -> std::optional<ChunkAllocation>
+	{
+		for(const auto& [allocatedCoordinate, allocation] : allocator)
+		{
+			if(allocatedCoordinate == coordinate)
+			{
+				return allocation;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Rebuilds a chunk from its extracted voxels like the world applies edits.
+	 */
+	auto RebuildWithEdit(const Chunk& previous, const glm::uvec3& position, Material material) -> Chunk
+	{
+		std::vector<uint8_t> voxels(ChunkSize * ChunkSize * ChunkSize);
+		previous.Extract(voxels);
+		voxels[GetVoxelIndex(position.x, position.y, position.z)] = static_cast<uint8_t>(material);
+
+		Chunk chunk;
+		chunk.Build(voxels);
+
+		return chunk;
+	}
+
+	/**
+	 * @brief Checks that rebuilding an edited chunk gives the same tree as building the edited voxels from scratch.
+	 */
+	auto TestRebuildMatchesFullBuild() -> bool
+	{
+		std::vector<uint8_t> voxels = CreateTerrain();
+
+		Chunk previous;
+		previous.Build(voxels);
+
+		bool hasPassed = true;
+		for(const glm::uvec3& position : { glm::uvec3(3u, 2u, 5u), glm::uvec3(20u, 30u, 11u), glm::uvec3(0u, 0u, 0u) })
+		{
+			Chunk rebuilt = RebuildWithEdit(previous, position, Material::Sand);
+
+			std::vector<uint8_t> editedVoxels = voxels;
+			editedVoxels[GetVoxelIndex(position.x, position.y, position.z)] = static_cast<uint8_t>(Material::Sand);
+
+			Chunk fullBuild;
+			fullBuild.Build(editedVoxels);
+
+			hasPassed &= Expect(std::ranges::equal(rebuilt.Data(), fullBuild.Data()), "RebuildMatchesFullBuild", "the rebuilt tree equals a full build");
+
+			std::vector<uint8_t> extracted(editedVoxels.size());
+			rebuilt.Extract(extracted);
+			hasPassed &= Expect(extracted == editedVoxels, "RebuildMatchesFullBuild", "the rebuilt tree holds the edited voxels");
+		}
+
+		return hasPassed;
+	}
+
+	/**
+	 * @brief Without frames in flight a material change rewrites only the differing bytes of the nodes in place.
+	 */
+	auto TestDirtyRangeInPlace() -> bool
+	{
+		Chunk previous;
+		previous.Build(CreateTerrain());
+
+		Chunk chunk = RebuildWithEdit(previous, glm::uvec3(3u, 2u, 5u), Material::Dirt);
+
+		std::vector<uint8_t> memory(1u << 20u, 0u);
+		ChunkAllocator allocator(memory.size(), memory.data());
+
+		glm::ivec3 coordinate = glm::ivec3(1, 0, -1);
+		bool hasPassed = Expect(allocator.Allocate(coordinate, previous), "DirtyRangeInPlace", "the chunk is allocated");
+
+		std::vector<uint8_t> lighting(previous.GetLeafCount() * ChunkLightingStride, 0x5Au);
+		hasPassed &= Expect(allocator.UpdateLighting(coordinate, lighting), "DirtyRangeInPlace", "the lighting is written");
+
+		std::vector<uint8_t> before = memory;
+		ChunkAllocation allocation = *FindAllocation(allocator, coordinate);
+
+		// The expected range spans the first and the last differing node byte
+		std::span<const uint8_t> data = chunk.Data();
+		std::span<const uint8_t> previousData = previous.Data();
+		size_t begin = static_cast<size_t>(std::ranges::mismatch(data, previousData).in1 - data.begin());
+		size_t end = data.size();
+		while(end > begin && data[end - 1u] == previousData[end - 1u])
+		{
+			--end;
+		}
+
+		std::optional<size_t> uploadSize = allocator.Update(coordinate, previous, chunk);
+		hasPassed &= Expect(uploadSize == end - begin && end > begin, "DirtyRangeInPlace", "the upload size is the range of differing bytes");
+		hasPassed &= Expect(FindAllocation(allocator, coordinate)->Block.Offset == allocation.Block.Offset, "DirtyRangeInPlace", "the chunk keeps its block");
+
+		std::span<const uint8_t> nodes = std::span<const uint8_t>(memory).subspan(allocation.Block.Offset, data.size());
+		hasPassed &= Expect(std::ranges::equal(nodes, data), "DirtyRangeInPlace", "the block holds the edited nodes");
+
+		bool isOutsideUnchanged = true;
+		for(size_t i = 0u; i < memory.size(); ++i)
+		{
+			bool isInRange = i >= allocation.Block.Offset + begin && i < allocation.Block.Offset + end;
+			isOutsideUnchanged &= isInRange || memory[i] == before[i];
+		}
+
+		hasPassed &= Expect(isOutsideUnchanged, "DirtyRangeInPlace", "nothing outside the range is written, the lighting stays");
+		hasPassed &= Expect(allocator.Update(coordinate, chunk, chunk) == 0u, "DirtyRangeInPlace", "an unchanged chunk writes nothing");
+
+		return hasPassed;
+	}
+
+	/**
+	 * @brief With frames in flight an edited chunk moves to a new block and the old one stays untouched until the frames finished.
+	 */
+	auto TestEditWithFramesInFlight() -> bool
+	{
+		Chunk previous;
+		previous.Build(CreateTerrain());
+
+		Chunk chunk = RebuildWithEdit(previous, glm::uvec3(3u, 2u, 5u), Material::Dirt);
+
+		// Room for the chunk, its edited version and one chunk per other frame, the edit keeps the size of the tree
+		size_t blockSize = previous.Data().size() + GetChunkLightingSize(previous);
+		std::vector<uint8_t> memory(blockSize * (FramesInFlight + 1u), 0u);
+		ChunkAllocator allocator(memory.size(), memory.data(), FramesInFlight);
+		allocator.BeginFrame(0u);
+
+		glm::ivec3 coordinate = glm::ivec3(0, 1, 0);
+		bool hasPassed = Expect(allocator.Allocate(coordinate, previous), "EditWithFramesInFlight", "the chunk is allocated");
+
+		ChunkAllocation allocation = *FindAllocation(allocator, coordinate);
+		std::vector<uint8_t> oldBlock(memory.begin() + static_cast<ptrdiff_t>(allocation.Block.Offset), memory.begin() + static_cast<ptrdiff_t>(allocation.Block.Offset + allocation.Block.Size));
+
+		std::optional<size_t> uploadSize = allocator.Update(coordinate, previous, chunk);
+		hasPassed &= Expect(uploadSize == chunk.Data().size() + GetChunkLightingSize(chunk), "EditWithFramesInFlight", "the upload size includes the lighting fill");
+
+		ChunkAllocation moved = *FindAllocation(allocator, coordinate);
+		hasPassed &= Expect(moved.Block.Offset != allocation.Block.Offset, "EditWithFramesInFlight", "the chunk moves to a new block");
+		hasPassed &= Expect(
+			std::ranges::equal(std::span<const uint8_t>(memory).subspan(moved.Block.Offset, chunk.Data().size()), chunk.Data()),
+			"EditWithFramesInFlight",
+			"the new block holds the edited nodes");
+
+		// Frames in flight keep reading the old block while the following ones are recorded
+		for(uint32_t frame = 1u; frame < FramesInFlight; ++frame)
+		{
+			allocator.BeginFrame(frame);
+			hasPassed &= Expect(allocator.Allocate(glm::ivec3(static_cast<int32_t>(frame), 5, 0), previous), "EditWithFramesInFlight", "other chunks are allocated");
+		}
+
+		hasPassed &= Expect(
+			std::ranges::equal(std::span<const uint8_t>(memory).subspan(allocation.Block.Offset, allocation.Block.Size), oldBlock),
+			"EditWithFramesInFlight",
+			"the old block isn't written while frames may read it");
+
+		hasPassed &= Expect(!allocator.Allocate(glm::ivec3(0, 6, 0), previous), "EditWithFramesInFlight", "the old block isn't reused while frames may read it");
+
+		// Once the frame of the edit finished, its old block is reused
+		allocator.BeginFrame(0u);
+		hasPassed &= Expect(allocator.Allocate(glm::ivec3(0, 6, 0), previous), "EditWithFramesInFlight", "a chunk is allocated after the frames finished");
+		hasPassed &= Expect(FindAllocation(allocator, glm::ivec3(0, 6, 0))->Block.Offset == allocation.Block.Offset, "EditWithFramesInFlight", "the old block is reused");
+
+		return hasPassed;
+	}
+}
+
+auto RunChunkAllocatorTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestRebuildMatchesFullBuild();
+	hasPassed &= TestDirtyRangeInPlace();
+	hasPassed &= TestEditWithFramesInFlight();
+
+	return hasPassed;
+}
@@ -0,0 +1,188 @@
+#include "Tests.h"
+
+#include "../src/world/ChunkCompression.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	constexpr size_t ChunkSize = Chunk::Size;
+
+	auto GetVoxelIndex(size_t x, size_t y, size_t z) noexcept -> size_t
+	{
+		return (z * ChunkSize + y) * ChunkSize + x;
+	}
+
+	/**
+	 * @brief Creates layered terrain with long runs and a sprinkle of random voxels that break them up.
+	 */
+	auto CreateChunk(uint32_t seed, float noiseRatio) -> Chunk
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> ratioDistribution(0.0f, 1.0f);
+		std::uniform_int_distribution<uint32_t> materialDistribution(0u, static_cast<uint32_t>(Material::Leaves));
+
+		std::vector<uint8_t> voxels(ChunkSize * ChunkSize * ChunkSize);
+
+		for(size_t z = 0u; z < ChunkSize; ++z)
+		{
+			for(size_t y = 0u; y < ChunkSize; ++y)
+			{
+				for(size_t x = 0u; x < ChunkSize; ++x)
+				{
+					Material material = y < 10u + (x + z) / 8u ? Material::Stone : y < 14u + (x + z) / 8u ? Material::Dirt : Material::Air;
+					if(ratioDistribution(random) < noiseRatio)
+					{
+						material = static_cast<Material>(materialDistribution(random));
+					}
+
+					voxels[GetVoxelIndex(x, y, z)] = static_cast<uint8_t>(material);
+				}
+			}
+		}
+
+		Chunk chunk;
+		chunk.Build(voxels);
+
+		return chunk;
+	}
+
+	auto CreateSingleVoxelChunk() -> Chunk
+	{
+		Chunk chunk;
+		chunk.Fill(static_cast<uint8_t>(Material::Air));
+		chunk.Set(glm::uvec3(31u, 0u, 17u), static_cast<uint8_t>(Material::Wood));
+
+		return chunk;
+	}
+
+	/**
+	 * @brief Stores bytes as literal runs only, the encoder would never produce them for repeated bytes but the decoder accepts them.
+	 */
+	auto EncodeLiterals(const std::vector<uint8_t>& bytes) -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> encoded;
+
+		for(size_t i = 0u; i < bytes.size(); i += 128u)
+		{
+			size_t length = std::min<size_t>(bytes.size() - i, 128u);
+
+			encoded.push_back(static_cast<uint8_t>(length - 1u));
+			encoded.insert(encoded.end(), bytes.begin() + static_cast<ptrdiff_t>(i), bytes.begin() + static_cast<ptrdiff_t>(i + length));
+		}
+
+		return encoded;
+	}
+
+	auto IsRoundTrip(const Chunk& chunk) -> bool
+	{
+		std::optional<Chunk> restored = DecompressChunk(CompressChunk(chunk));
+
+		return
+			restored.has_value() &&
+			restored->IsUniform() == chunk.IsUniform() &&
+			restored->GetUniformValue() == chunk.GetUniformValue() &&
+			std::ranges::equal(restored->Data(), chunk.Data());
+	}
+
+	auto TestRoundTrip() -> bool
+	{
+		bool hasPassed = true;
+
+		// From long runs only to mostly literals, which also splits them at the maximum literal length
+		for(float noiseRatio : { 0.0f, 0.01f, 0.2f, 1.0f })
+		{
+			hasPassed &= Expect(IsRoundTrip(CreateChunk(3u, noiseRatio)), "RoundTrip", "a chunk decompresses to its original nodes");
+		}
+
+		Chunk uniformChunk;
+		uniformChunk.Fill(static_cast<uint8_t>(Material::Stone));
+
+		hasPassed &= Expect(IsRoundTrip(uniformChunk), "RoundTrip", "a uniform chunk keeps its value");
+		hasPassed &= Expect(CompressChunk(uniformChunk).Data.empty(), "RoundTrip", "a uniform chunk stores no data");
+
+		hasPassed &= Expect(IsRoundTrip(CreateSingleVoxelChunk()), "RoundTrip", "a nearly empty chunk decompresses to its original nodes");
+
+		CompressedChunk compressedTerrain = CompressChunk(CreateChunk(5u, 0.0f));
+		hasPassed &= Expect(compressedTerrain.Data.size() < compressedTerrain.NodeCount / 4u, "RoundTrip", "runs compress layered terrain");
+
+		return hasPassed;
+	}
+
+	auto TestAcceptsLiterals() -> bool
+	{
+		const Chunk chunk = CreateChunk(11u, 0.01f);
+		std::vector<uint8_t> nodes(chunk.Data().begin(), chunk.Data().end());
+
+		std::optional<Chunk> restored = DecompressChunk(
+			CompressedChunk{
+				.Data = EncodeLiterals(nodes),
+				.NodeCount = static_cast<uint32_t>(nodes.size()),
+				.UniformValue = 0u,
+			});
+
+		return Expect(restored.has_value() && std::ranges::equal(restored->Data(), nodes), "AcceptsLiterals", "a valid octree stored as literals decodes");
+	}
+
+	auto TestRejectsCorruptData() -> bool
+	{
+		const CompressedChunk original = CompressChunk(CreateChunk(9u, 0.05f));
+
+		bool hasPassed = true;
+
+		CompressedChunk truncated = original;
+		truncated.Data.resize(truncated.Data.size() / 2u);
+		hasPassed &= Expect(!DecompressChunk(truncated).has_value(), "RejectsCorruptData", "data decoding to too few nodes is rejected");
+
+		CompressedChunk cutOffRun = original;
+		cutOffRun.Data.push_back(0x80u);
+		hasPassed &= Expect(!DecompressChunk(cutOffRun).has_value(), "RejectsCorruptData", "a run without its value is rejected");
+
+		CompressedChunk overlong = original;
+		overlong.Data.insert(overlong.Data.end(), { 0xFFu, 0x01u });
+		hasPassed &= Expect(!DecompressChunk(overlong).has_value(), "RejectsCorruptData", "data decoding to too many nodes is rejected");
+
+		CompressedChunk tooLarge = original;
+		tooLarge.NodeCount = 0xFFFFFFFFu;
+		hasPassed &= Expect(!DecompressChunk(tooLarge).has_value(), "RejectsCorruptData", "a node count larger than a full chunk is rejected");
+
+		// Rewrites the root's child mask so that the levels no longer add up to the node count, with fewer and with more children
+		const Chunk terrainChunk = CreateChunk(9u, 0.05f);
+		const Chunk singleVoxelChunk = CreateSingleVoxelChunk();
+
+		for(const auto& [chunk, mask] : { std::pair(&terrainChunk, 0x00u), std::pair(&terrainChunk, 0x7Fu), std::pair(&singleVoxelChunk, 0xFFu) })
+		{
+			std::vector<uint8_t> nodes(chunk->Data().begin(), chunk->Data().end());
+			nodes[0] = static_cast<uint8_t>(mask);
+
+			CompressedChunk corruptOctree{
+				.Data = EncodeLiterals(nodes),
+				.NodeCount = static_cast<uint32_t>(nodes.size()),
+				.UniformValue = 0u,
+			};
+
+			hasPassed &= Expect(!DecompressChunk(corruptOctree).has_value(), "RejectsCorruptData", "an octree whose child masks don't match its size is rejected");
+		}
+
+		return hasPassed;
+	}
+}
+
+auto RunChunkCompressionTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestRoundTrip();
+	hasPassed &= TestAcceptsLiterals();
+	hasPassed &= TestRejectsCorruptData();
+
+	return hasPassed;
+}
@@ -0,0 +1,207 @@
+#include "Tests.h"
+
+#include "../src/utility/Math.h"
+#include "../src/world/ChunkGrid.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr glm::ivec3 GridOrigin = glm::ivec3(-3, 0, -2);
+	constexpr glm::ivec3 GridSize = glm::ivec3(6, 3, 5);
+	constexpr float ChunkSize = static_cast<float>(Chunk::Size);
+
+	constexpr uint32_t RayCount = 3000u;
+
+	/**
+	 * @brief The step of the brute-force walk, cells the ray only clips by less are allowed to be missed by it.
+	 */
+	constexpr float WalkStep = 0.05f;
+
+	/**
+	 * @brief Samples the ray densely and collects every cell of the grid it passes through in order.
+	 */
+	auto WalkCells(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float minDistance) -> std::vector<glm::ivec3>
+	{
+		glm::vec3 boundsMin = glm::vec3(GridOrigin) * ChunkSize;
+		glm::vec2 intersectTest = RayBoxIntersection(rayOrigin, rayDirection, boundsMin, boundsMin + glm::vec3(GridSize) * ChunkSize);
+
+		std::vector<glm::ivec3> cells;
+		if(intersectTest.y < 0.0f)
+		{
+			return cells;
+		}
+
+		for(float distance = glm::max(intersectTest.x, minDistance); distance <= intersectTest.y; distance += WalkStep)
+		{
+			glm::ivec3 cell = glm::ivec3(glm::floor((rayOrigin + rayDirection * distance) / ChunkSize));
+			if(glm::any(glm::lessThan(cell, GridOrigin)) || glm::any(glm::greaterThanEqual(cell, GridOrigin + GridSize)))
+			{
+				continue;
+			}
+
+			if(cells.empty() || cells.back() != cell)
+			{
+				cells.push_back(cell);
+			}
+		}
+
+		return cells;
+	}
+
+	/**
+	 * @brief Picks a random direction, some of them parallel to one or two axes.
+	 */
+	auto GetRandomDirection(std::mt19937& random, uint32_t index) -> glm::vec3
+	{
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		glm::vec3 direction = glm::vec3(unit(random), unit(random), unit(random));
+		switch(index % 4u)
+		{
+		case 1u:
+			direction[index % 3u] = 0.0f;
+			break;
+		case 2u:
+			direction[index % 3u] = 0.0f;
+			direction[(index + 1u) % 3u] = 0.0f;
+			break;
+		default:
+			break;
+		}
+
+		return glm::normalize(direction);
+	}
+
+	/**
+	 * @brief Compares the traversal with a dense walk along random rays, starting inside and outside the grid and at a minimum distance.
+	 */
+	auto TestMatchesCellWalk() -> bool
+	{
+		std::mt19937 random(1u);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> fraction(0.0f, 1.0f);
+
+		glm::vec3 center = (glm::vec3(GridOrigin) + glm::vec3(GridSize) * 0.5f) * ChunkSize;
+
+		uint32_t failureCount = 0u;
+		uint32_t hitCount = 0u;
+
+		for(uint32_t ray = 0u; ray < RayCount; ++ray)
+		{
+			// Half of the rays start outside the grid
+			float spread = (ray % 2u == 0u) ? 80.0f : 400.0f;
+			glm::vec3 rayOrigin = center + glm::vec3(unit(random), unit(random), unit(random)) * spread;
+			glm::vec3 rayDirection = GetRandomDirection(random, ray);
+			float minDistance = (ray % 3u == 0u) ? fraction(random) * 300.0f : 0.0f;
+
+			std::vector<glm::ivec3> cells;
+			TraverseChunkGrid(rayOrigin, rayDirection, minDistance, GridOrigin, GridSize,
+				[&] (const glm::ivec3& cell) -> bool
+				{
+					cells.push_back(cell);
+
+					return false;
+				});
+
+			std::vector<glm::ivec3> walkedCells = WalkCells(rayOrigin, rayDirection, minDistance);
+			hitCount += walkedCells.empty() ? 0u : 1u;
+
+			// Every walked cell is visited in the same order
+			size_t walkedIndex = 0u;
+			for(const glm::ivec3& cell : cells)
+			{
+				if(walkedIndex < walkedCells.size() && cell == walkedCells[walkedIndex])
+				{
+					++walkedIndex;
+				}
+			}
+
+			bool isMatching = walkedIndex == walkedCells.size();
+
+			// Any other visited cell is a neighbour of the previous one the ray clips past the minimum distance
+			for(size_t i = 0u; i < cells.size(); ++i)
+			{
+				glm::vec3 boundsMin = glm::vec3(cells[i]) * ChunkSize;
+				glm::vec2 cellIntersectTest = RayBoxIntersection(rayOrigin, rayDirection, boundsMin - 1e-3f, boundsMin + ChunkSize + 1e-3f);
+
+				isMatching &= cellIntersectTest.y >= minDistance - 1e-3f;
+				isMatching &= i == 0u || glm::dot(glm::vec3(glm::abs(cells[i] - cells[i - 1u])), glm::vec3(1.0f)) == 1.0f;
+			}
+
+			if(!isMatching)
+			{
+				++failureCount;
+			}
+		}
+
+		bool hasPassed = Expect(failureCount == 0u, "MatchesCellWalk", "the traversal visits the cells a dense walk along the ray passes, in order");
+		hasPassed &= Expect(hitCount > RayCount / 4u, "MatchesCellWalk", "many rays pass through the grid");
+
+		return hasPassed;
+	}
+
+	auto TestStopsAtVisitor() -> bool
+	{
+		uint32_t visitedCount = 0u;
+		bool isStopped = TraverseChunkGrid(
+			glm::vec3(-200.0f, 40.0f, 10.0f),
+			glm::vec3(1.0f, 0.0f, 0.0f),
+			0.0f,
+			GridOrigin,
+			GridSize,
+			[&] (const glm::ivec3& cell) -> bool
+			{
+				++visitedCount;
+
+				return cell.x == 0;
+			});
+
+		bool hasPassed = Expect(isStopped && visitedCount == 4u, "StopsAtVisitor", "the traversal stops once the visitor returns true");
+
+		bool isMissed = !TraverseChunkGrid(
+			glm::vec3(-200.0f, 40.0f, 10.0f),
+			glm::vec3(-1.0f, 0.0f, 0.0f),
+			0.0f,
+			GridOrigin,
+			GridSize,
+			[] (const glm::ivec3&) -> bool
+			{
+				return true;
+			});
+
+		hasPassed &= Expect(isMissed, "StopsAtVisitor", "a ray pointing away from the grid visits nothing");
+
+		return hasPassed;
+	}
+
+	auto TestChunkColumn() -> bool
+	{
+		constexpr float chunkSize = static_cast<float>(Chunk::Size);
+
+		bool hasPassed = true;
+
+		hasPassed &= Expect(GetChunkColumn(glm::vec3(0.0f, 50.0f, chunkSize - 0.01f)) == glm::ivec2(0, 0), "ChunkColumn", "the first chunk spans [0, size)");
+		hasPassed &= Expect(GetChunkColumn(glm::vec3(chunkSize, 0.0f, 0.0f)) == glm::ivec2(1, 0), "ChunkColumn", "the next chunk starts at its edge");
+		hasPassed &= Expect(GetChunkColumn(glm::vec3(-0.01f, 0.0f, -chunkSize + 0.5f)) == glm::ivec2(-1, -1), "ChunkColumn", "positions just below zero are in chunk -1");
+		hasPassed &= Expect(GetChunkColumn(glm::vec3(-chunkSize, 0.0f, -chunkSize - 0.5f)) == glm::ivec2(-1, -2), "ChunkColumn", "negative positions round toward negative infinity");
+		hasPassed &= Expect(GetChunkColumn(glm::vec3(-5.5f * chunkSize, -100.0f, 3.5f * chunkSize)) == glm::ivec2(-6, 3), "ChunkColumn", "the height is ignored");
+
+		return hasPassed;
+	}
+}
+
+auto RunChunkGridTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestMatchesCellWalk();
+	hasPassed &= TestStopsAtVisitor();
+	hasPassed &= TestChunkColumn();
+
+	return hasPassed;
+}
@@ -0,0 +1,139 @@
+#include "Tests.h"
+
+#include "../src/world/ChunkLoadQueue.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	auto TestPriorityOrder() -> bool
+	{
+		std::mt19937 random(7u);
+		std::uniform_real_distribution<float> priorityDistribution(-100.0f, 100.0f);
+
+		ChunkLoadQueue queue;
+		std::vector<std::pair<float, glm::ivec3>> expected;
+
+		for(int32_t i = 0; i < 500; ++i)
+		{
+			glm::ivec3 coordinate = glm::ivec3(i % 23 - 11, i % 3, i / 23 - 10);
+			float priority = priorityDistribution(random);
+
+			queue.Push(coordinate, priority);
+			expected.emplace_back(priority, coordinate);
+		}
+
+		std::ranges::sort(expected, [] (const auto& a, const auto& b) -> bool { return a.first < b.first; });
+
+		bool hasPassed = Expect(queue.GetSize() == expected.size(), "PriorityOrder", "every pushed chunk is queued");
+
+		for(const auto& [priority, coordinate] : expected)
+		{
+			std::optional<glm::ivec3> popped = queue.Pop();
+
+			hasPassed &= Expect(popped == coordinate, "PriorityOrder", "chunks are popped lowest priority first");
+		}
+
+		hasPassed &= Expect(queue.IsEmpty() && !queue.Pop().has_value(), "PriorityOrder", "the queue is empty afterwards");
+
+		return hasPassed;
+	}
+
+	auto TestPushAgain() -> bool
+	{
+		ChunkLoadQueue queue;
+		queue.Push(glm::ivec3(0, 0, 0), 1.0f);
+		queue.Push(glm::ivec3(1, 0, 0), 2.0f);
+		queue.Push(glm::ivec3(2, 0, 0), 3.0f);
+
+		// Moves the first chunk behind the others, then the last one in front
+		queue.Push(glm::ivec3(0, 0, 0), 4.0f);
+		queue.Push(glm::ivec3(2, 0, 0), 0.0f);
+		queue.Push(glm::ivec3(2, 0, 0), 0.0f);
+
+		bool hasPassed = Expect(queue.GetSize() == 3u, "PushAgain", "pushing a queued chunk doesn't add it twice");
+
+		hasPassed &= Expect(queue.Pop() == glm::ivec3(2, 0, 0), "PushAgain", "a lowered priority takes effect");
+		hasPassed &= Expect(queue.Pop() == glm::ivec3(1, 0, 0), "PushAgain", "untouched chunks keep their priority");
+		hasPassed &= Expect(queue.Pop() == glm::ivec3(0, 0, 0), "PushAgain", "a raised priority takes effect");
+		hasPassed &= Expect(!queue.Pop().has_value(), "PushAgain", "the stale entries are never popped");
+
+		return hasPassed;
+	}
+
+	auto TestRemove() -> bool
+	{
+		ChunkLoadQueue queue;
+		for(int32_t i = 0; i < 10; ++i)
+		{
+			queue.Push(glm::ivec3(i, 0, 0), static_cast<float>(i));
+		}
+
+		queue.Remove(glm::ivec3(0, 0, 0));
+		queue.Remove(glm::ivec3(5, 0, 0));
+		queue.Remove(glm::ivec3(42, 0, 0));
+
+		bool hasPassed = Expect(queue.GetSize() == 8u, "Remove", "removed chunks are no longer counted");
+		hasPassed &= Expect(!queue.Contains(glm::ivec3(5, 0, 0)) && queue.Contains(glm::ivec3(6, 0, 0)), "Remove", "only the removed chunks leave the queue");
+
+		// A cancelled chunk pushed again is queued with its new priority only
+		queue.Push(glm::ivec3(5, 0, 0), 100.0f);
+
+		std::vector<int32_t> popped;
+		while(std::optional<glm::ivec3> coordinate = queue.Pop())
+		{
+			popped.push_back(coordinate->x);
+		}
+
+		hasPassed &= Expect(popped == std::vector<int32_t>{ 1, 2, 3, 4, 6, 7, 8, 9, 5 }, "Remove", "cancelled chunks are skipped");
+
+		return hasPassed;
+	}
+
+	auto TestReprioritize() -> bool
+	{
+		ChunkLoadQueue queue;
+		for(int32_t i = -5; i <= 5; ++i)
+		{
+			queue.Push(glm::ivec3(i, 0, 0), static_cast<float>(i));
+		}
+
+		// Reverses the order and drops the chunks right of the origin
+		queue.Reprioritize(
+			[] (const glm::ivec3& coordinate) -> std::optional<float>
+			{
+				return coordinate.x > 0 ? std::nullopt : std::optional<float>(-static_cast<float>(coordinate.x));
+			});
+
+		bool hasPassed = Expect(queue.GetSize() == 6u, "Reprioritize", "chunks without a priority are dropped");
+		hasPassed &= Expect(!queue.Contains(glm::ivec3(1, 0, 0)), "Reprioritize", "dropped chunks are no longer queued");
+
+		for(int32_t i = 0; i >= -5; --i)
+		{
+			hasPassed &= Expect(queue.Pop() == glm::ivec3(i, 0, 0), "Reprioritize", "chunks are popped by their new priority");
+		}
+
+		hasPassed &= Expect(!queue.Pop().has_value(), "Reprioritize", "dropped chunks are never popped");
+
+		return hasPassed;
+	}
+}
+
+auto RunChunkLoadQueueTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestPriorityOrder();
+	hasPassed &= TestPushAgain();
+	hasPassed &= TestRemove();
+	hasPassed &= TestReprioritize();
+
+	return hasPassed;
+}
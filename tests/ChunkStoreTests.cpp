@@ -0,0 +1,150 @@
+#include "Tests.h"
+
+#include "../src/world/ChunkStore.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief Creates an empty directory for a test.
+	 */
+	auto CreateTestDirectory(const char* name) -> std::filesystem::path
+	{
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / "voxel-game-tests" / name;
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+
+		return directory;
+	}
+
+	auto CreateChunk(uint8_t value, const glm::uvec3& coordinate) -> CompressedChunk
+	{
+		Chunk chunk;
+		chunk.Fill(static_cast<uint8_t>(Material::Air));
+		chunk.Set(coordinate, value);
+
+		return CompressChunk(chunk);
+	}
+
+	auto IsEqual(const CompressedChunk* chunk, const CompressedChunk& expected) -> bool
+	{
+		return
+			chunk != nullptr &&
+			chunk->NodeCount == expected.NodeCount &&
+			chunk->UniformValue == expected.UniformValue &&
+			chunk->Data == expected.Data;
+	}
+
+	auto TestPersists() -> bool
+	{
+		std::filesystem::path directory = CreateTestDirectory("Persists");
+
+		CompressedChunk first = CreateChunk(static_cast<uint8_t>(Material::Wood), glm::uvec3(1u, 2u, 3u));
+		CompressedChunk second = CreateChunk(static_cast<uint8_t>(Material::Sand), glm::uvec3(31u, 0u, 31u));
+		CompressedChunk uniform{
+			.Data = {},
+			.NodeCount = 0u,
+			.UniformValue = static_cast<uint8_t>(Material::Stone),
+		};
+
+		bool hasPassed = true;
+		{
+			ChunkStore store(directory);
+
+			hasPassed &= Expect(store.GetCount() == 0u, "Persists", "a new directory holds no chunks");
+			hasPassed &= Expect(store.Store(glm::ivec3(-3, 0, 12), first), "Persists", "a chunk is saved");
+			hasPassed &= Expect(store.Store(glm::ivec3(4, 2, -7), second), "Persists", "a chunk is saved");
+			hasPassed &= Expect(store.Store(glm::ivec3(-1, 1, -1), uniform), "Persists", "a uniform chunk is saved");
+			hasPassed &= Expect(store.Find(glm::ivec3(4, 2, 7)) == nullptr, "Persists", "chunks that weren't stored aren't found");
+		}
+
+		{
+			ChunkStore store(directory);
+
+			hasPassed &= Expect(store.GetCount() == 3u, "Persists", "every saved chunk is loaded again");
+			hasPassed &= Expect(IsEqual(store.Find(glm::ivec3(-3, 0, 12)), first), "Persists", "a loaded chunk equals the saved one");
+			hasPassed &= Expect(IsEqual(store.Find(glm::ivec3(4, 2, -7)), second), "Persists", "a loaded chunk equals the saved one");
+			hasPassed &= Expect(IsEqual(store.Find(glm::ivec3(-1, 1, -1)), uniform), "Persists", "a loaded uniform chunk keeps its value");
+
+			store.Store(glm::ivec3(-3, 0, 12), second);
+		}
+
+		ChunkStore store(directory);
+		hasPassed &= Expect(store.GetCount() == 3u && IsEqual(store.Find(glm::ivec3(-3, 0, 12)), second), "Persists", "saving a chunk again replaces its file");
+
+		bool hasTemporaryFile = std::ranges::any_of(
+			std::filesystem::directory_iterator(directory),
+			[] (const std::filesystem::directory_entry& entry) -> bool
+			{
+				return entry.path().extension() != ".chunk";
+			});
+
+		hasPassed &= Expect(!hasTemporaryFile, "Persists", "no temporary files are left behind");
+
+		return hasPassed;
+	}
+
+	auto TestSkipsBrokenFiles() -> bool
+	{
+		std::filesystem::path directory = CreateTestDirectory("SkipsBrokenFiles");
+
+		CompressedChunk chunk = CreateChunk(static_cast<uint8_t>(Material::Leaves), glm::uvec3(7u, 8u, 9u));
+		{
+			ChunkStore store(directory);
+			store.Store(glm::ivec3(0, 0, 0), chunk);
+			store.Store(glm::ivec3(1, 0, 0), chunk);
+		}
+
+		auto write = [&] (const char* name, const std::vector<uint8_t>& bytes) -> void
+			{
+				std::ofstream file(directory / name, std::ios::binary);
+				file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			};
+
+		// Cut short by a crash, with data that doesn't decode and with names that aren't coordinates
+		std::filesystem::resize_file(directory / "1_0_0.chunk", 3u);
+		write("2_0_0.chunk", { 0x10u, 0x00u, 0x00u, 0x00u, 0x00u, 0x85u });
+		write("notes.chunk", { 0x00u, 0x00u, 0x00u, 0x00u, 0x02u });
+		write("3_0.chunk", { 0x00u, 0x00u, 0x00u, 0x00u, 0x02u });
+		write("3_0_0_1.chunk", { 0x00u, 0x00u, 0x00u, 0x00u, 0x02u });
+
+		ChunkStore store(directory);
+
+		bool hasPassed = Expect(store.GetCount() == 1u, "SkipsBrokenFiles", "only the valid chunk is loaded");
+		hasPassed &= Expect(IsEqual(store.Find(glm::ivec3(0, 0, 0)), chunk), "SkipsBrokenFiles", "the valid chunk is intact");
+
+		return hasPassed;
+	}
+
+	auto TestMemoryOnly() -> bool
+	{
+		CompressedChunk chunk = CreateChunk(static_cast<uint8_t>(Material::Dirt), glm::uvec3(0u, 0u, 0u));
+
+		ChunkStore store({});
+
+		bool hasPassed = Expect(store.Store(glm::ivec3(5, 1, 5), chunk), "MemoryOnly", "a store without a directory accepts chunks");
+		hasPassed &= Expect(IsEqual(store.Find(glm::ivec3(5, 1, 5)), chunk), "MemoryOnly", "a store without a directory keeps the chunks");
+
+		return hasPassed;
+	}
+}
+
+auto RunChunkStoreTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestPersists();
+	hasPassed &= TestSkipsBrokenFiles();
+	hasPassed &= TestMemoryOnly();
+
+	return hasPassed;
+}
@@ -0,0 +1,239 @@
+#include "Tests.h"
+
+#include "../src/utility/Math.h"
+#include "../src/world/CoarseDepth.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr glm::ivec3 GridOrigin = glm::ivec3(-1, 0, -1);
+	constexpr glm::ivec3 GridSize = glm::ivec3(3, 2, 3);
+	constexpr int32_t ChunkSize = static_cast<int32_t>(Chunk::Size);
+
+	constexpr uint32_t BundleCount = 4000u;
+	constexpr uint32_t RaysPerBundle = 16u;
+
+	/**
+	 * @brief A grid of chunks with a dense copy of the voxels to trace against.
+	 */
+	struct TestGrid
+	{
+		std::vector<Chunk> Chunks;
+		std::vector<uint8_t> Voxels;
+
+		[[nodiscard]] auto GetChunkIndex(const glm::ivec3& localChunk) const noexcept -> size_t
+		{
+			return static_cast<size_t>((localChunk.y * GridSize.z + localChunk.z) * GridSize.x + localChunk.x);
+		}
+
+		[[nodiscard]] auto IsSolid(const glm::ivec3& localVoxel) const noexcept -> bool
+		{
+			glm::ivec3 size = GridSize * ChunkSize;
+
+			return Voxels[static_cast<size_t>((localVoxel.z * size.y + localVoxel.y) * size.x + localVoxel.x)] != 0u;
+		}
+
+		auto Set(const glm::ivec3& localVoxel) -> void
+		{
+			glm::ivec3 size = GridSize * ChunkSize;
+
+			Voxels[static_cast<size_t>((localVoxel.z * size.y + localVoxel.y) * size.x + localVoxel.x)] = 1u;
+			Chunks[GetChunkIndex(localVoxel / ChunkSize)].Set(glm::uvec3(localVoxel % ChunkSize), static_cast<uint8_t>(Material::Stone));
+		}
+	};
+
+	/**
+	 * @brief Fills a grid with random boxes and scattered voxels, leaving most of it empty.
+	 */
+	auto CreateGrid(std::mt19937& random) -> TestGrid
+	{
+		glm::ivec3 size = GridSize * ChunkSize;
+
+		TestGrid grid;
+		grid.Chunks.resize(static_cast<size_t>(GridSize.x * GridSize.y * GridSize.z));
+		grid.Voxels.resize(static_cast<size_t>(size.x * size.y * size.z), 0u);
+
+		std::uniform_int_distribution<int32_t> x(0, size.x - 1);
+		std::uniform_int_distribution<int32_t> y(0, size.y - 1);
+		std::uniform_int_distribution<int32_t> z(0, size.z - 1);
+		std::uniform_int_distribution<int32_t> extent(1, 6);
+
+		for(uint32_t box = 0u; box < 12u; ++box)
+		{
+			glm::ivec3 boxMin = glm::ivec3(x(random), y(random), z(random));
+			glm::ivec3 boxMax = glm::min(boxMin + glm::ivec3(extent(random), extent(random), extent(random)), size);
+
+			for(int32_t vz = boxMin.z; vz < boxMax.z; ++vz)
+			{
+				for(int32_t vy = boxMin.y; vy < boxMax.y; ++vy)
+				{
+					for(int32_t vx = boxMin.x; vx < boxMax.x; ++vx)
+					{
+						grid.Set(glm::ivec3(vx, vy, vz));
+					}
+				}
+			}
+		}
+
+		for(uint32_t voxel = 0u; voxel < 40u; ++voxel)
+		{
+			grid.Set(glm::ivec3(x(random), y(random), z(random)));
+		}
+
+		return grid;
+	}
+
+	/**
+	 * @brief Marches the voxels along a ray.
+	 *
+	 * @return The distance the ray enters the first solid voxel at, or -1 if it hits nothing.
+	 */
+	auto TraceVoxels(const TestGrid& grid, const glm::vec3& rayOrigin, const glm::vec3& rayDirection) -> float
+	{
+		glm::vec3 boundsMin = glm::vec3(GridOrigin * ChunkSize);
+		glm::ivec3 size = GridSize * ChunkSize;
+
+		glm::vec2 intersectTest = RayBoxIntersection(rayOrigin, rayDirection, boundsMin, boundsMin + glm::vec3(size));
+		if(intersectTest.x < 0.0f)
+		{
+			return -1.0f;
+		}
+
+		float distance = intersectTest.x;
+		glm::ivec3 voxel = glm::clamp(glm::ivec3(glm::floor(rayOrigin + rayDirection * distance - boundsMin)), glm::ivec3(0), size - 1);
+
+		glm::ivec3 stepDirection = glm::ivec3(glm::sign(rayDirection));
+		glm::vec3 deltaDistance = glm::abs(1.0f / rayDirection);
+		glm::vec3 nextDistance = (glm::vec3(voxel + glm::max(stepDirection, glm::ivec3(0))) + boundsMin - rayOrigin) / rayDirection;
+		nextDistance = glm::mix(nextDistance, glm::vec3(INFINITY), glm::equal(stepDirection, glm::ivec3(0)));
+
+		while(glm::all(glm::greaterThanEqual(voxel, glm::ivec3(0))) && glm::all(glm::lessThan(voxel, size)))
+		{
+			if(grid.IsSolid(voxel))
+			{
+				return distance;
+			}
+
+			glm::length_t axis = (nextDistance.x < nextDistance.y)
+				? ((nextDistance.x < nextDistance.z) ? 0 : 2)
+				: ((nextDistance.y < nextDistance.z) ? 1 : 2);
+
+			distance = nextDistance[axis];
+			nextDistance[axis] += deltaDistance[axis];
+			voxel[axis] += stepDirection[axis];
+		}
+
+		return -1.0f;
+	}
+
+	auto TestOccupancy(const TestGrid& grid) -> bool
+	{
+		bool isMatching = true;
+
+		for(int32_t chunk = 0; chunk < GridSize.x * GridSize.y * GridSize.z; ++chunk)
+		{
+			glm::ivec3 localChunk = glm::ivec3(chunk % GridSize.x, chunk / (GridSize.x * GridSize.z), (chunk / GridSize.x) % GridSize.z);
+			uint64_t occupancy = GetCoarseOccupancy(grid.Chunks[grid.GetChunkIndex(localChunk)]);
+
+			for(int32_t cell = 0; cell < CoarseCellsPerChunk * CoarseCellsPerChunk * CoarseCellsPerChunk; ++cell)
+			{
+				glm::ivec3 cellOrigin = localChunk * ChunkSize + glm::ivec3(
+					cell % CoarseCellsPerChunk,
+					(cell / CoarseCellsPerChunk) % CoarseCellsPerChunk,
+					cell / (CoarseCellsPerChunk * CoarseCellsPerChunk)) * CoarseCellSize;
+
+				bool isOccupied = false;
+				for(int32_t voxel = 0; voxel < CoarseCellSize * CoarseCellSize * CoarseCellSize; ++voxel)
+				{
+					isOccupied |= grid.IsSolid(cellOrigin + glm::ivec3(voxel % CoarseCellSize, (voxel / CoarseCellSize) % CoarseCellSize, voxel / (CoarseCellSize * CoarseCellSize)));
+				}
+
+				isMatching &= isOccupied == ((occupancy >> static_cast<uint32_t>(cell)) & 1u);
+			}
+		}
+
+		return Expect(isMatching, "Occupancy", "a cell is occupied exactly if it contains a solid voxel");
+	}
+
+	/**
+	 * @brief Traces bundles of rays, none of them may hit a voxel before the coarse distance of its bundle.
+	 */
+	auto TestConservativeDistance(const TestGrid& grid, std::mt19937& random) -> bool
+	{
+		std::vector<uint64_t> occupancy(grid.Chunks.size());
+		for(size_t i = 0u; i < grid.Chunks.size(); ++i)
+		{
+			occupancy[i] = GetCoarseOccupancy(grid.Chunks[i]);
+		}
+
+		std::vector<uint64_t> dilated(occupancy.size());
+		DilateCoarseOccupancy(occupancy, dilated, GridSize);
+
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> fraction(0.0f, 1.0f);
+
+		glm::vec3 center = glm::vec3(GridOrigin * ChunkSize) + glm::vec3(GridSize * ChunkSize) * 0.5f;
+
+		uint32_t failureCount = 0u;
+		uint32_t hitCount = 0u;
+
+		for(uint32_t bundle = 0u; bundle < BundleCount; ++bundle)
+		{
+			glm::vec3 rayOrigin = center + glm::vec3(unit(random), unit(random), unit(random)) * 120.0f;
+			glm::vec3 rayDirection = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+			float halfAngle = fraction(random) * 0.2f;
+
+			float coarseDistance = TraceCoarseDistance(rayOrigin, rayDirection, std::sin(halfAngle), GridOrigin, GridSize, dilated);
+
+			glm::vec3 tangent = glm::normalize(glm::cross(rayDirection, (std::abs(rayDirection.y) < 0.9f) ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f)));
+			glm::vec3 bitangent = glm::cross(rayDirection, tangent);
+
+			for(uint32_t ray = 0u; ray < RaysPerBundle; ++ray)
+			{
+				// Half of the rays lie on the edge of the cone, where the bound is tightest
+				float angle = halfAngle * ((ray % 2u == 0u) ? 1.0f : fraction(random));
+				float rotation = fraction(random) * 6.2831853f;
+
+				glm::vec3 direction = glm::normalize(
+					rayDirection * std::cos(angle) +
+					(tangent * std::cos(rotation) + bitangent * std::sin(rotation)) * std::sin(angle));
+
+				float hitDistance = TraceVoxels(grid, rayOrigin, direction);
+				if(hitDistance < 0.0f)
+				{
+					continue;
+				}
+
+				++hitCount;
+				if(coarseDistance < 0.0f || coarseDistance > hitDistance + 1e-3f)
+				{
+					++failureCount;
+				}
+			}
+		}
+
+		bool hasPassed = Expect(failureCount == 0u, "ConservativeDistance", "no ray hits a voxel before the coarse distance of its bundle");
+		hasPassed &= Expect(hitCount > 0u, "ConservativeDistance", "some rays hit the grid");
+
+		return hasPassed;
+	}
+}
+
+auto RunCoarseDepthTests() -> bool
+{
+	std::mt19937 random(1u);
+	TestGrid grid = CreateGrid(random);
+
+	bool hasPassed = true;
+
+	hasPassed &= TestOccupancy(grid);
+	hasPassed &= TestConservativeDistance(grid, random);
+
+	return hasPassed;
+}
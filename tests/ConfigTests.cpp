@@ -0,0 +1,66 @@
+#include "Tests.h"
+
+#include "../src/utility/Config.h"
+
+#include <cstdint>
+
+namespace
+{
+	/**
+	 * @brief Callbacks changing the subscriptions while a value is notified must not break the iteration.
+	 */
+	auto TestSubscriptionsChangedByCallbacks() -> bool
+	{
+		int64_t value = 0;
+		int32_t first = 0;
+		int32_t second = 0;
+		int32_t third = 0;
+		uint32_t firstCallCount = 0u;
+		uint32_t secondCallCount = 0u;
+		uint32_t thirdCallCount = 0u;
+
+		Config::Subscribe(&first, &value, [&] () -> void
+			{
+				++firstCallCount;
+
+				// Removes the next subscription and adds enough new ones to move the existing ones
+				Config::Unsubscribe(&second);
+				for(uint32_t i = 0u; i < 64u; ++i)
+				{
+					Config::Subscribe(&third, &value, [&] () -> void
+						{
+							++thirdCallCount;
+						});
+				}
+			});
+
+		Config::Subscribe(&second, &value, [&] () -> void
+			{
+				++secondCallCount;
+			});
+
+		Config::NotifyChanged(&value);
+
+		bool hasPassed = Expect(firstCallCount == 1u, "SubscriptionsChangedByCallbacks", "the notifying subscription is called once");
+		hasPassed &= Expect(secondCallCount == 0u, "SubscriptionsChangedByCallbacks", "a subscription removed by a callback isn't called");
+		hasPassed &= Expect(thirdCallCount == 0u, "SubscriptionsChangedByCallbacks", "subscriptions added by a callback wait for the next change");
+
+		Config::Unsubscribe(&first);
+		Config::NotifyChanged(&value);
+
+		hasPassed &= Expect(firstCallCount == 1u && thirdCallCount == 64u, "SubscriptionsChangedByCallbacks", "only the remaining subscriptions are called afterwards");
+
+		Config::Unsubscribe(&third);
+
+		return hasPassed;
+	}
+}
+
+auto RunConfigTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestSubscriptionsChangedByCallbacks();
+
+	return hasPassed;
+}
@@ -0,0 +1,126 @@
+#include "Tests.h"
+
+#include "../src/utility/Frustum.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstdint>
+#include <random>
+
+namespace
+{
+	constexpr uint32_t CameraCount = 100u;
+	constexpr uint32_t BoxCount = 200u;
+	constexpr uint32_t PointCount = 250u;
+	constexpr glm::uvec2 ScreenSize = glm::uvec2(1280u, 720u);
+
+	/**
+	 * @brief Samples points in random boxes around random cameras, a visible point must never be culled or projected outside its box's rect.
+	 */
+	auto TestVisiblePointsArePreserved() -> bool
+	{
+		std::mt19937 random(1u);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> fraction(0.0f, 1.0f);
+
+		uint32_t culledCount = 0u;
+		uint32_t failureCount = 0u;
+
+		for(uint32_t camera = 0u; camera < CameraCount; ++camera)
+		{
+			glm::vec3 position = glm::vec3(unit(random), unit(random), unit(random)) * 100.0f;
+			glm::vec3 forward = glm::normalize(glm::vec3(unit(random), unit(random) * 0.5f, unit(random)));
+
+			glm::mat4 view = glm::lookAt(position, position + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::mat4 projection = glm::perspective(glm::radians(70.0f), static_cast<float>(ScreenSize.x) / static_cast<float>(ScreenSize.y), 0.1f, 1000.0f);
+			glm::mat4 viewProjection = projection * view;
+
+			Frustum frustum(viewProjection);
+
+			for(uint32_t box = 0u; box < BoxCount; ++box)
+			{
+				glm::vec3 boundsMin = position + glm::vec3(unit(random), unit(random), unit(random)) * 200.0f;
+				glm::vec3 boundsMax = boundsMin + glm::vec3(32.0f);
+
+				bool isVisible = frustum.Intersects(boundsMin, boundsMax);
+				ScreenRect rect = ProjectBox(viewProjection, boundsMin, boundsMax, ScreenSize);
+				culledCount += isVisible ? 0u : 1u;
+
+				for(uint32_t point = 0u; point < PointCount; ++point)
+				{
+					glm::vec3 sample = glm::mix(boundsMin, boundsMax, glm::vec3(fraction(random), fraction(random), fraction(random)));
+					glm::vec4 clip = viewProjection * glm::vec4(sample, 1.0f);
+					if(clip.w <= 0.0f || glm::any(glm::greaterThan(glm::abs(glm::vec3(clip)), glm::vec3(clip.w))))
+					{
+						continue;
+					}
+
+					glm::vec2 pixel = (glm::vec2(clip) / clip.w * 0.5f + 0.5f) * glm::vec2(ScreenSize);
+					glm::ivec2 coveredPixel = glm::min(glm::ivec2(pixel), glm::ivec2(ScreenSize) - 1);
+
+					bool isInRect =
+						glm::all(glm::greaterThanEqual(coveredPixel, rect.Min)) &&
+						glm::all(glm::lessThan(coveredPixel, rect.Max));
+
+					if(!isVisible || !isInRect)
+					{
+						++failureCount;
+					}
+				}
+			}
+		}
+
+		bool hasPassed = Expect(failureCount == 0u, "VisiblePointsArePreserved", "no visible point lies in a culled box or outside its rect");
+		hasPassed &= Expect(culledCount > 0u, "VisiblePointsArePreserved", "boxes outside the view are culled");
+
+		return hasPassed;
+	}
+
+	auto TestBoxBehindTheCamera() -> bool
+	{
+		glm::mat4 viewProjection =
+			glm::perspective(glm::radians(70.0f), 1.0f, 0.1f, 1000.0f) *
+			glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		Frustum frustum(viewProjection);
+
+		bool hasPassed = Expect(!frustum.Intersects(glm::vec3(-1.0f, -1.0f, 10.0f), glm::vec3(1.0f, 1.0f, 12.0f)), "BoxBehindTheCamera", "a box behind the camera is culled");
+		hasPassed &= Expect(frustum.Intersects(glm::vec3(-1.0f, -1.0f, -12.0f), glm::vec3(1.0f, 1.0f, -10.0f)), "BoxBehindTheCamera", "a box in front of the camera is kept");
+
+		ScreenRect rect = ProjectBox(viewProjection, glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f), ScreenSize);
+		hasPassed &= Expect(rect.Min == glm::ivec2(0) && rect.Max == glm::ivec2(ScreenSize), "BoxBehindTheCamera", "a box around the camera covers the screen");
+
+		return hasPassed;
+	}
+
+	auto TestMergeRects() -> bool
+	{
+		ScreenRect rect = {
+			.Min = glm::ivec2(0),
+			.Max = glm::ivec2(0),
+		};
+
+		rect.Merge(ScreenRect{ .Min = glm::ivec2(10, 20), .Max = glm::ivec2(30, 40) });
+		bool hasPassed = Expect(rect.Min == glm::ivec2(10, 20) && rect.Max == glm::ivec2(30, 40), "MergeRects", "merging into an empty rect copies the other one");
+
+		rect.Merge(ScreenRect{ .Min = glm::ivec2(5, 50), .Max = glm::ivec2(5, 60) });
+		hasPassed &= Expect(rect.Min == glm::ivec2(10, 20) && rect.Max == glm::ivec2(30, 40), "MergeRects", "empty rects are ignored");
+
+		rect.Merge(ScreenRect{ .Min = glm::ivec2(0, 30), .Max = glm::ivec2(20, 50) });
+		hasPassed &= Expect(rect.Min == glm::ivec2(0, 20) && rect.Max == glm::ivec2(30, 50), "MergeRects", "the merged rect covers both");
+
+		return hasPassed;
+	}
+}
+
+auto RunFrustumTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestVisiblePointsArePreserved();
+	hasPassed &= TestBoxBehindTheCamera();
+	hasPassed &= TestMergeRects();
+
+	return hasPassed;
+}
@@ -0,0 +1,161 @@
+#include "Tests.h"
+
+#include "../src/utility/JobSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t WorkerCount = 4u;
+	constexpr uint32_t ProducerCount = 4u;
+	constexpr uint32_t JobCount = 5000u;
+
+	auto TestRunsEveryJob() -> bool
+	{
+		std::atomic<uint32_t> runCount = 0u;
+		std::atomic<uint32_t> nestedRunCount = 0u;
+		std::atomic<uint32_t> continuationRunCount = 0u;
+
+		std::mutex handleMutex;
+		std::vector<JobHandle> handles;
+
+		// Pushes from threads outside the pool, from the workers and through continuations all at once
+		std::vector<std::thread> producers;
+		for(uint32_t producer = 0u; producer < ProducerCount; ++producer)
+		{
+			producers.emplace_back(
+				[&, producer] () -> void
+				{
+					std::vector<JobHandle> producedHandles;
+
+					for(uint32_t i = 0u; i < JobCount; ++i)
+					{
+						JobPriority priority = static_cast<JobPriority>((producer + i) % 3u);
+
+						JobHandle handle = JobSystem::Schedule(
+							[&, i] () -> void
+							{
+								runCount.fetch_add(1u, std::memory_order_relaxed);
+
+								if(i % 7u == 0u)
+								{
+									JobHandle nested = JobSystem::Schedule(
+										[&] () -> void
+										{
+											nestedRunCount.fetch_add(1u, std::memory_order_relaxed);
+										},
+										JobPriority::High);
+
+									JobSystem::Wait(nested);
+								}
+							},
+							priority);
+
+						if(i % 5u == 0u)
+						{
+							producedHandles.push_back(JobSystem::Then(
+								handle,
+								[&] () -> void
+								{
+									continuationRunCount.fetch_add(1u, std::memory_order_relaxed);
+								},
+								priority));
+						}
+
+						producedHandles.push_back(std::move(handle));
+					}
+
+					std::scoped_lock lock(handleMutex);
+					handles.insert(handles.end(), producedHandles.begin(), producedHandles.end());
+				});
+		}
+
+		for(std::thread& producer : producers)
+		{
+			producer.join();
+		}
+
+		for(const JobHandle& handle : handles)
+		{
+			JobSystem::Wait(handle);
+		}
+
+		constexpr uint32_t totalCount = ProducerCount * JobCount;
+
+		bool hasPassed = Expect(runCount == totalCount, "RunsEveryJob", "every scheduled job runs once");
+		hasPassed &= Expect(nestedRunCount == ProducerCount * ((JobCount + 6u) / 7u), "RunsEveryJob", "every job scheduled by a worker runs once");
+		hasPassed &= Expect(continuationRunCount == ProducerCount * ((JobCount + 4u) / 5u), "RunsEveryJob", "every continuation runs once");
+
+		return hasPassed;
+	}
+
+	auto TestCancellation() -> bool
+	{
+		CancellationToken token;
+		token.Cancel();
+
+		std::atomic<bool> hasRun = false;
+		std::atomic<bool> hasContinuationRun = false;
+
+		JobHandle handle = JobSystem::Schedule([&] () -> void { hasRun = true; }, JobPriority::Normal, token);
+		JobHandle continuation = JobSystem::Then(handle, [&] () -> void { hasContinuationRun = true; });
+
+		JobSystem::Wait(continuation);
+
+		bool hasPassed = Expect(handle.IsFinished() && !hasRun, "Cancellation", "a cancelled job finishes without running");
+		hasPassed &= Expect(hasContinuationRun, "Cancellation", "the continuation of a cancelled job still runs");
+
+		return hasPassed;
+	}
+
+	auto TestIdleAfterBursts() -> bool
+	{
+		bool hasPassed = true;
+
+		// Workers going to sleep between the bursts must still be woken up by the next one
+		for(uint32_t burst = 0u; burst < 200u; ++burst)
+		{
+			std::atomic<uint32_t> runCount = 0u;
+
+			std::vector<JobHandle> handles;
+			for(uint32_t i = 0u; i < WorkerCount; ++i)
+			{
+				handles.push_back(JobSystem::Schedule([&] () -> void { runCount.fetch_add(1u, std::memory_order_relaxed); }));
+			}
+
+			for(const JobHandle& handle : handles)
+			{
+				JobSystem::Wait(handle);
+			}
+
+			hasPassed &= runCount == WorkerCount;
+
+			if(burst % 50u == 0u)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+		}
+
+		return Expect(hasPassed, "IdleAfterBursts", "jobs pushed to sleeping workers run");
+	}
+}
+
+auto RunJobSystemTests() -> bool
+{
+	JobSystem::Initialize(WorkerCount);
+
+	bool hasPassed = true;
+
+	hasPassed &= TestRunsEveryJob();
+	hasPassed &= TestCancellation();
+	hasPassed &= TestIdleAfterBursts();
+
+	JobSystem::Shutdown();
+
+	return hasPassed;
+}
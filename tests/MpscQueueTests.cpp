@@ -0,0 +1,161 @@
+#include "Tests.h"
+
+#include "../src/utility/MpscQueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t ProducerCount = 8u;
+	constexpr uint32_t PushCount = 200'000u;
+
+	/**
+	 * @brief Counts its live instances to find leaked or doubly destroyed values.
+	 */
+	struct Tracked
+	{
+		static inline std::atomic<int32_t> s_liveCount = 0;
+
+		Tracked()
+		{
+			s_liveCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Tracked(const Tracked&)
+		{
+			s_liveCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		~Tracked()
+		{
+			s_liveCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+	};
+
+	auto TestSingleThreadOrder() -> bool
+	{
+		MpscQueue<uint32_t> queue;
+		bool hasPassed = Expect(!queue.TryPop().has_value(), "SingleThreadOrder", "a new queue is empty");
+
+		for(uint32_t i = 0u; i < 100u; ++i)
+		{
+			queue.Push(i);
+		}
+
+		uint32_t expected = 0u;
+		size_t count = queue.Drain(
+			[&] (uint32_t value) -> void
+			{
+				hasPassed &= Expect(value == expected++, "SingleThreadOrder", "values are popped in push order");
+			});
+
+		hasPassed &= Expect(count == 100u, "SingleThreadOrder", "every value is drained");
+		hasPassed &= Expect(!queue.TryPop().has_value(), "SingleThreadOrder", "a drained queue is empty");
+
+		return hasPassed;
+	}
+
+	auto TestMoveOnlyValues() -> bool
+	{
+		MpscQueue<std::unique_ptr<uint32_t>> queue;
+		queue.Push(std::make_unique<uint32_t>(7u));
+
+		std::optional<std::unique_ptr<uint32_t>> value = queue.TryPop();
+
+		return Expect(value.has_value() && *value != nullptr && **value == 7u, "MoveOnlyValues", "move-only values pass through");
+	}
+
+	auto TestDestroysUnpoppedValues() -> bool
+	{
+		bool hasPassed = true;
+		{
+			MpscQueue<Tracked> queue;
+			for(uint32_t i = 0u; i < 10u; ++i)
+			{
+				queue.Push(Tracked());
+			}
+
+			hasPassed &= Expect(queue.TryPop().has_value(), "DestroysUnpoppedValues", "a pushed value can be popped");
+		}
+
+		hasPassed &= Expect(Tracked::s_liveCount.load() == 0, "DestroysUnpoppedValues", "the queue destroys every value exactly once");
+
+		return hasPassed;
+	}
+
+	/**
+	 * @brief Pushes from many threads while one thread pops, every value must arrive once and in order per producer.
+	 */
+	auto TestConcurrentProducers() -> bool
+	{
+		MpscQueue<uint64_t> queue;
+		std::atomic<uint32_t> finishedCount = 0u;
+
+		std::vector<std::thread> producers;
+		for(uint32_t producer = 0u; producer < ProducerCount; ++producer)
+		{
+			producers.emplace_back(
+				[&queue, &finishedCount, producer] () -> void
+				{
+					for(uint32_t i = 0u; i < PushCount; ++i)
+					{
+						queue.Push((static_cast<uint64_t>(producer) << 32u) | i);
+					}
+
+					finishedCount.fetch_add(1u, std::memory_order_release);
+				});
+		}
+
+		std::vector<uint32_t> nextValues(ProducerCount, 0u);
+		bool isOrdered = true;
+		uint64_t popCount = 0u;
+
+		auto consume = [&] (uint64_t value) -> void
+			{
+				uint32_t producer = static_cast<uint32_t>(value >> 32u);
+				uint32_t index = static_cast<uint32_t>(value);
+
+				isOrdered &= producer < ProducerCount && index == nextValues[producer];
+				if(producer < ProducerCount)
+				{
+					nextValues[producer] = index + 1u;
+				}
+
+				++popCount;
+			};
+
+		while(finishedCount.load(std::memory_order_acquire) < ProducerCount)
+		{
+			queue.Drain(consume);
+		}
+
+		for(std::thread& producer : producers)
+		{
+			producer.join();
+		}
+
+		queue.Drain(consume);
+
+		bool hasPassed = Expect(isOrdered, "ConcurrentProducers", "the values of each producer arrive in push order");
+		hasPassed &= Expect(popCount == static_cast<uint64_t>(ProducerCount) * PushCount, "ConcurrentProducers", "every value arrives exactly once");
+
+		return hasPassed;
+	}
+}
+
+auto RunMpscQueueTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestSingleThreadOrder();
+	hasPassed &= TestMoveOnlyValues();
+	hasPassed &= TestDestroysUnpoppedValues();
+	hasPassed &= TestConcurrentProducers();
+
+	return hasPassed;
+}
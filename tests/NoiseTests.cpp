@@ -0,0 +1,148 @@
+#include "Tests.h"
+
+#include "../src/utility/Noise.h"
+
+#include <fastnoiselite/FastNoiseLite.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief A grid of sample points straddling the origin, its extents aren't multiples of the 8 lanes of the AVX2 path.
+	 */
+	struct SampleGrid
+	{
+		std::vector<float> Xs;
+		std::vector<float> Ys;
+	};
+
+	auto CreateSampleGrid(int32_t minX, int32_t minY, int32_t width, int32_t height, float spacing) -> SampleGrid
+	{
+		SampleGrid grid;
+
+		for(int32_t y = minY; y < minY + height; ++y)
+		{
+			for(int32_t x = minX; x < minX + width; ++x)
+			{
+				grid.Xs.push_back(static_cast<float>(x) * spacing);
+				grid.Ys.push_back(static_cast<float>(y) * spacing);
+			}
+		}
+
+		return grid;
+	}
+
+	auto IsBitIdentical(float a, float b) noexcept -> bool
+	{
+		return std::memcmp(&a, &b, sizeof(float)) == 0;
+	}
+
+	/**
+	 * @brief Compares both instruction sets and FastNoiseLite on every point of the grid.
+	 */
+	auto CompareImplementations(const FractalNoiseSettings& settings, const SampleGrid& grid, const char* test) -> bool
+	{
+		FractalNoise noise(settings);
+
+		FastNoiseLite reference(settings.Seed);
+		reference.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+		reference.SetFractalType(FastNoiseLite::FractalType_FBm);
+		reference.SetFrequency(settings.Frequency);
+		reference.SetFractalOctaves(settings.Octaves);
+		reference.SetFractalGain(settings.Gain);
+		reference.SetFractalLacunarity(settings.Lacunarity);
+
+		std::vector<float> scalar(grid.Xs.size());
+		std::vector<float> avx2(grid.Xs.size());
+		noise.GetNoise(grid.Xs, grid.Ys, scalar, SimdLevel::Scalar);
+		noise.GetNoise(grid.Xs, grid.Ys, avx2, SimdLevel::Avx2);
+
+		size_t scalarMismatches = 0u;
+		size_t avx2Mismatches = 0u;
+		size_t singleMismatches = 0u;
+
+		for(size_t i = 0u; i < grid.Xs.size(); ++i)
+		{
+			float expected = reference.GetNoise(grid.Xs[i], grid.Ys[i]);
+
+			scalarMismatches += IsBitIdentical(scalar[i], expected) ? 0u : 1u;
+			avx2Mismatches += IsBitIdentical(avx2[i], expected) ? 0u : 1u;
+			singleMismatches += IsBitIdentical(noise.GetNoise(grid.Xs[i], grid.Ys[i]), expected) ? 0u : 1u;
+		}
+
+		bool hasPassed = true;
+
+		hasPassed &= Expect(scalarMismatches == 0u, test, "the scalar path matches FastNoiseLite bit for bit");
+		hasPassed &= Expect(avx2Mismatches == 0u, test, "the AVX2 path matches FastNoiseLite bit for bit");
+		hasPassed &= Expect(singleMismatches == 0u, test, "single points match FastNoiseLite bit for bit");
+
+		return hasPassed;
+	}
+
+	auto TestTerrainSettings() -> bool
+	{
+		FractalNoiseSettings settings{
+			.Seed = 1337,
+			.Frequency = 0.01f,
+			.Octaves = 8,
+			.Gain = 0.5f,
+			.Lacunarity = 2.0f,
+		};
+
+		return CompareImplementations(settings, CreateSampleGrid(-61, -45, 123, 91, 1.0f), "TerrainSettings");
+	}
+
+	auto TestUnusualSettings() -> bool
+	{
+		FractalNoiseSettings settings{
+			.Seed = -7,
+			.Frequency = 0.173f,
+			.Octaves = 3,
+			.Gain = 0.65f,
+			.Lacunarity = 2.3f,
+		};
+
+		return CompareImplementations(settings, CreateSampleGrid(-1003, -517, 37, 29, 3.7f), "UnusualSettings");
+	}
+
+	auto TestShortBatches() -> bool
+	{
+		FractalNoiseSettings settings{
+			.Seed = 42,
+			.Frequency = 0.05f,
+			.Octaves = 4,
+			.Gain = 0.5f,
+			.Lacunarity = 2.0f,
+		};
+
+		bool hasPassed = true;
+
+		// Batches shorter than, equal to and just above one vector
+		for(int32_t width : { 1, 7, 8, 9, 15, 17 })
+		{
+			hasPassed &= CompareImplementations(settings, CreateSampleGrid(-width, -3, width, 1, 11.3f), "ShortBatches");
+		}
+
+		return hasPassed;
+	}
+}
+
+auto RunNoiseTests() -> bool
+{
+	if(FractalNoise::GetSupportedSimdLevel() != SimdLevel::Avx2)
+	{
+		std::printf("[Noise] AVX2 isn't supported, its path falls back to the scalar one\n");
+	}
+
+	bool hasPassed = true;
+
+	hasPassed &= TestTerrainSettings();
+	hasPassed &= TestUnusualSettings();
+	hasPassed &= TestShortBatches();
+
+	return hasPassed;
+}
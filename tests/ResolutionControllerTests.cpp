@@ -0,0 +1,131 @@
+#include "Tests.h"
+
+#include "../src/renderer/ResolutionController.h"
+
+#include <cstdint>
+
+namespace
+{
+	constexpr uint32_t FrameCount = 600u;
+
+	constexpr ResolutionControllerSettings Settings = {
+		.TargetFrameTime = 1.0f / 60.0f,
+		.MinScale = 0.25f,
+		.MaxScale = 1.0f,
+	};
+
+	/**
+	 * @brief The result of feeding a synthetic load to a controller.
+	 */
+	struct Trace
+	{
+		float Scale;
+		float FrameTime;
+		uint32_t ChangeCount;
+	};
+
+	/**
+	 * @brief Feeds frame times proportional to the traced pixels.
+	 *
+	 * @param controller The controller.
+	 * @param fullScaleFrameTime The frame time at a scale of 1.
+	 * @param frameCount The number of frames.
+	 *
+	 * @return The state after the last frame.
+	 */
+	auto RunTrace(ResolutionController& controller, float fullScaleFrameTime, uint32_t frameCount = FrameCount) -> Trace
+	{
+		Trace trace = {
+			.Scale = controller.GetScale(),
+			.FrameTime = 0.0f,
+			.ChangeCount = 0u,
+		};
+
+		for(uint32_t frame = 0u; frame < frameCount; ++frame)
+		{
+			trace.FrameTime = fullScaleFrameTime * trace.Scale * trace.Scale;
+
+			float scale = controller.Update(trace.FrameTime);
+			trace.ChangeCount += (scale != trace.Scale) ? 1u : 0u;
+			trace.Scale = scale;
+		}
+
+		return trace;
+	}
+
+	auto TestHeavyLoad() -> bool
+	{
+		ResolutionController controller(Settings);
+		Trace trace = RunTrace(controller, Settings.TargetFrameTime * 2.0f);
+
+		float load = trace.FrameTime / Settings.TargetFrameTime;
+
+		bool hasPassed = Expect(load >= 0.8f && load <= 1.05f, "HeavyLoad", "the frame time settles near the target");
+		hasPassed &= Expect(trace.Scale < Settings.MaxScale, "HeavyLoad", "the resolution drops");
+		hasPassed &= Expect(trace.ChangeCount <= 10u, "HeavyLoad", "the scale settles in a few steps");
+
+		return hasPassed;
+	}
+
+	auto TestLightLoad() -> bool
+	{
+		ResolutionController controller(Settings);
+		Trace trace = RunTrace(controller, Settings.TargetFrameTime * 0.5f);
+
+		return Expect(trace.Scale == Settings.MaxScale && trace.ChangeCount == 0u, "LightLoad", "the scale stays at the maximum with headroom");
+	}
+
+	auto TestImpossibleLoad() -> bool
+	{
+		ResolutionController controller(Settings);
+		Trace trace = RunTrace(controller, Settings.TargetFrameTime * 100.0f);
+
+		return Expect(trace.Scale == Settings.MinScale, "ImpossibleLoad", "the scale bottoms out at the minimum");
+	}
+
+	auto TestRecovery() -> bool
+	{
+		ResolutionController controller(Settings);
+		RunTrace(controller, Settings.TargetFrameTime * 3.0f);
+		Trace trace = RunTrace(controller, Settings.TargetFrameTime * 0.5f);
+
+		return Expect(trace.Scale == Settings.MaxScale, "Recovery", "the scale returns to the maximum once the load drops");
+	}
+
+	auto TestSingleHitch() -> bool
+	{
+		ResolutionController controller(Settings);
+
+		// Inside the band at full scale, a single slow frame must not change the resolution
+		RunTrace(controller, Settings.TargetFrameTime * 0.95f);
+		float scale = controller.Update(Settings.TargetFrameTime * 20.0f);
+		Trace trace = RunTrace(controller, Settings.TargetFrameTime * 0.95f, 60u);
+
+		return Expect(scale == Settings.MaxScale && trace.ChangeCount == 0u, "SingleHitch", "a single hitch leaves the scale unchanged");
+	}
+
+	auto TestDisabled() -> bool
+	{
+		ResolutionControllerSettings settings = Settings;
+		settings.TargetFrameTime = 0.0f;
+
+		ResolutionController controller(settings);
+		Trace trace = RunTrace(controller, 1.0f);
+
+		return Expect(trace.Scale == settings.MaxScale, "Disabled", "no target keeps the maximum scale");
+	}
+}
+
+auto RunResolutionControllerTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestHeavyLoad();
+	hasPassed &= TestLightLoad();
+	hasPassed &= TestImpossibleLoad();
+	hasPassed &= TestRecovery();
+	hasPassed &= TestSingleHitch();
+	hasPassed &= TestDisabled();
+
+	return hasPassed;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdio>
+
+/**
+ * @brief Reports a failed expectation of a test.
+ *
+ * @param condition The expectation.
+ * @param test The name of the test.
+ * @param message Describes what was expected.
+ *
+ * @return The condition.
+ */
+inline auto Expect(bool condition, const char* test, const char* message) -> bool
+{
+	if(!condition)
+	{
+		std::printf("[%s] Failed: %s\n", test, message);
+	}
+
+	return condition;
+}
+
+/**
+ * @brief Runs the tests of @ref ChunkAllocator and of rebuilding edited chunks.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunChunkAllocatorTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref CompressChunk and @ref DecompressChunk.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunChunkCompressionTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref TraverseChunkGrid and @ref GetChunkColumn.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunChunkGridTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref ChunkLoadQueue.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunChunkLoadQueueTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref ChunkStore.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunChunkStoreTests() -> bool;
+
+/**
+ * @brief Runs the tests of the config subscriptions.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunConfigTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref JobSystem.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunJobSystemTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref MpscQueue.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunMpscQueueTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref Frustum and @ref ProjectBox.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunFrustumTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref ResolutionController.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunResolutionControllerTests() -> bool;
+
+/**
+ * @brief Runs the tests of the coarse occupancy and @ref TraceCoarseDistance.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunCoarseDepthTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref ToroidalGrid.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunToroidalGridTests() -> bool;
+
+/**
+ * @brief Runs the tests of @ref FractalNoise.
+ *
+ * @return 'true' if every test passed, otherwise 'false'.
+ */
+auto RunNoiseTests() -> bool;
@@ -0,0 +1,128 @@
+#include "Tests.h"
+
+#include "../src/utility/ToroidalGrid.h"
+#include "../src/world/ChunkGrid.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	constexpr int32_t GridSize = 5;
+
+	/**
+	 * @brief A cell remembering the coordinate it was filled for, default constructed cells are unfilled.
+	 */
+	struct Cell
+	{
+		bool IsFilled = false;
+		glm::ivec2 Coordinate = glm::ivec2(0);
+	};
+
+	/**
+	 * @brief Fills the unfilled cells of the window and checks that the filled ones kept their coordinate.
+	 */
+	auto CheckAndFill(ToroidalGrid<Cell>& grid, const char* test) -> bool
+	{
+		bool hasPassed = true;
+
+		grid.ForEach(
+			[&] (const glm::ivec2& coordinate, Cell& cell) -> void
+			{
+				if(cell.IsFilled)
+				{
+					hasPassed &= Expect(cell.Coordinate == coordinate, test, "a cell staying in the window keeps its value");
+				}
+
+				cell = Cell{ .IsFilled = true, .Coordinate = coordinate };
+			});
+
+		return hasPassed;
+	}
+
+	auto TestNegativeCoordinates() -> bool
+	{
+		ToroidalGrid<Cell> grid(GridSize, glm::ivec2(-7, -12));
+		bool hasPassed = CheckAndFill(grid, "NegativeCoordinates");
+
+		std::vector<const Cell*> cells;
+		grid.ForEach(
+			[&] (const glm::ivec2& coordinate, Cell& cell) -> void
+			{
+				hasPassed &= Expect(grid.Find(coordinate) == &cell, "NegativeCoordinates", "every cell of the window can be found");
+				cells.push_back(&cell);
+			});
+
+		std::ranges::sort(cells);
+		hasPassed &= Expect(std::ranges::adjacent_find(cells) == cells.end(), "NegativeCoordinates", "every cell of the window has its own storage");
+
+		hasPassed &= Expect(grid.Find(glm::ivec2(-8, -12)) == nullptr, "NegativeCoordinates", "the cell before the origin is outside");
+		hasPassed &= Expect(grid.Find(glm::ivec2(-7, -7)) == nullptr, "NegativeCoordinates", "the cell after the last one is outside");
+		hasPassed &= Expect(grid.Find(glm::ivec2(-3, -8)) != nullptr, "NegativeCoordinates", "the last cell is inside");
+
+		return hasPassed;
+	}
+
+	auto TestRecentring() -> bool
+	{
+		constexpr float chunkSize = static_cast<float>(Chunk::Size);
+
+		glm::vec3 position = glm::vec3(3.0f * chunkSize + 1.0f, 0.0f, 2.0f * chunkSize + 5.0f);
+		ToroidalGrid<Cell> grid(GridSize, GetChunkColumn(position) - GridSize / 2);
+		bool hasPassed = CheckAndFill(grid, "Recentring");
+
+		// Walks the camera across the world origin on both axes, including steps of more than the window
+		const glm::vec3 steps[] = {
+			glm::vec3(-0.75f * chunkSize, 0.0f, -0.5f * chunkSize),
+			glm::vec3(-2.5f * chunkSize, 0.0f, 0.25f * chunkSize),
+			glm::vec3(-7.0f * chunkSize, 0.0f, -6.0f * chunkSize),
+			glm::vec3(0.1f * chunkSize, 0.0f, -1.3f * chunkSize),
+			glm::vec3(9.0f * chunkSize, 0.0f, 11.0f * chunkSize),
+		};
+
+		for(uint32_t i = 0u; i < 40u; ++i)
+		{
+			position += steps[i % std::size(steps)];
+
+			glm::ivec2 center = GetChunkColumn(position);
+			glm::ivec2 previousOrigin = grid.GetOrigin();
+			glm::ivec2 origin = center - GridSize / 2;
+
+			uint32_t leftCount = 0u;
+			grid.Move(
+				origin,
+				[&] (const glm::ivec2& coordinate, Cell& cell) -> void
+				{
+					bool wasInside = glm::all(glm::greaterThanEqual(coordinate, previousOrigin)) && glm::all(glm::lessThan(coordinate, previousOrigin + GridSize));
+					bool isInside = glm::all(glm::greaterThanEqual(coordinate, origin)) && glm::all(glm::lessThan(coordinate, origin + GridSize));
+
+					hasPassed &= Expect(wasInside && !isInside, "Recentring", "only cells leaving the window are reported");
+					hasPassed &= Expect(cell.IsFilled && cell.Coordinate == coordinate, "Recentring", "a leaving cell still holds its value");
+					leftCount++;
+				});
+
+			glm::ivec2 overlap = glm::max(glm::min(previousOrigin, origin) + GridSize - glm::max(previousOrigin, origin), glm::ivec2(0));
+
+			hasPassed &= Expect(grid.GetOrigin() == origin, "Recentring", "the window moves to the new origin");
+			hasPassed &= Expect(grid.Contains(center), "Recentring", "the window contains the camera's chunk");
+			hasPassed &= Expect(leftCount == static_cast<uint32_t>(GridSize * GridSize - overlap.x * overlap.y), "Recentring", "every cell leaving the window is reported once");
+			hasPassed &= CheckAndFill(grid, "Recentring");
+		}
+
+		return hasPassed;
+	}
+}
+
+auto RunToroidalGridTests() -> bool
+{
+	bool hasPassed = true;
+
+	hasPassed &= TestNegativeCoordinates();
+	hasPassed &= TestRecentring();
+
+	return hasPassed;
+}
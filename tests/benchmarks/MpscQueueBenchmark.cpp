@@ -0,0 +1,150 @@
+#include "../../src/utility/MpscQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t PushCount = 1'000'000u;
+	constexpr uint32_t RepeatCount = 5u;
+
+	/**
+	 * @brief The queue the chunks were handed over with before @ref MpscQueue, a deque behind a mutex.
+	 *
+	 * @tparam T The type of the values.
+	 */
+	template<typename T>
+	class MutexQueue
+	{
+	public:
+		auto Push(T value) -> void
+		{
+			std::scoped_lock lock(m_mutex);
+
+			m_values.push_back(std::move(value));
+		}
+
+		template<typename TFunction>
+		auto Drain(TFunction&& function) -> size_t
+		{
+			std::deque<T> values;
+			{
+				std::scoped_lock lock(m_mutex);
+
+				values.swap(m_values);
+			}
+
+			for(T& value : values)
+			{
+				function(std::move(value));
+			}
+
+			return values.size();
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::deque<T> m_values;
+	};
+
+	/**
+	 * @brief Pushes from several threads while one thread drains the queue.
+	 *
+	 * @return The number of values passed through the queue per second.
+	 */
+	template<typename TQueue>
+	auto Measure(uint32_t producerCount) -> double
+	{
+		TQueue queue;
+		std::atomic<bool> isStarted = false;
+
+		std::vector<std::thread> producers;
+		for(uint32_t producer = 0u; producer < producerCount; ++producer)
+		{
+			producers.emplace_back(
+				[&queue, &isStarted] () -> void
+				{
+					while(!isStarted.load(std::memory_order_acquire))
+					{
+						std::this_thread::yield();
+					}
+
+					for(uint32_t i = 0u; i < PushCount; ++i)
+					{
+						queue.Push(static_cast<uint64_t>(i));
+					}
+				});
+		}
+
+		uint64_t totalCount = static_cast<uint64_t>(producerCount) * PushCount;
+		uint64_t popCount = 0u;
+		uint64_t checksum = 0u;
+
+		auto start = std::chrono::steady_clock::now();
+		isStarted.store(true, std::memory_order_release);
+
+		while(popCount < totalCount)
+		{
+			popCount += queue.Drain(
+				[&] (uint64_t value) -> void
+				{
+					checksum += value;
+				});
+		}
+
+		auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for(std::thread& producer : producers)
+		{
+			producer.join();
+		}
+
+		if(checksum != static_cast<uint64_t>(producerCount) * (static_cast<uint64_t>(PushCount) * (PushCount - 1u) / 2u))
+		{
+			std::printf("Lost values in the queue\n");
+		}
+
+		return static_cast<double>(totalCount) / duration;
+	}
+
+	/**
+	 * @brief Keeps the best of several runs to filter out scheduling noise.
+	 */
+	template<typename TQueue>
+	auto MeasureBest(uint32_t producerCount) -> double
+	{
+		double best = 0.0;
+		for(uint32_t i = 0u; i < RepeatCount; ++i)
+		{
+			best = std::max(best, Measure<TQueue>(producerCount));
+		}
+
+		return best;
+	}
+}
+
+auto main() -> int
+{
+	uint32_t maxProducerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+
+	std::printf("%-10s %16s %16s\n", "Producers", "MpscQueue op/s", "MutexQueue op/s");
+
+	for(uint32_t producerCount = 1u; producerCount <= maxProducerCount; producerCount *= 2u)
+	{
+		double lockFree = MeasureBest<MpscQueue<uint64_t>>(producerCount);
+		double locked = MeasureBest<MutexQueue<uint64_t>>(producerCount);
+
+		std::printf("%-10u %16.0f %16.0f\n", producerCount, lockFree, locked);
+	}
+
+	return 0;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @brief The directory holding the capture cases, a camera path '<name>.toml' whose first keyframe is the view and its golden image '<name>.png'.
+	 */
+	const std::filesystem::path CaseDirectory = "tests/captures";
+
+	/**
+	 * @brief Holds the options given on the command line.
+	 */
+	struct Options
+	{
+#if defined(_WIN32)
+		std::filesystem::path GamePath = "bin/voxel-game.exe";
+#else
+		std::filesystem::path GamePath = "bin/voxel-game";
+#endif
+
+		/**
+		 * @brief The directory the captures, their reports and difference masks are written to.
+		 */
+		std::filesystem::path OutputDirectory = "bin/captures";
+
+		/**
+		 * @brief Whether the captures replace the golden images instead of being compared to them.
+		 */
+		bool IsUpdating = false;
+	};
+
+	auto ParseOptions(int argc, char* argv[]) -> Options
+	{
+		Options options;
+
+		for(int i = 1; i < argc; ++i)
+		{
+			std::string_view argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if(argument == "--game" && hasValue)
+			{
+				options.GamePath = argv[++i];
+			}
+			else if(argument == "--output" && hasValue)
+			{
+				options.OutputDirectory = argv[++i];
+			}
+			else if(argument == "--update")
+			{
+				options.IsUpdating = true;
+			}
+		}
+
+		return options;
+	}
+
+	auto Quote(const std::filesystem::path& path) -> std::string
+	{
+		return "\"" + path.string() + "\"";
+	}
+
+	/**
+	 * @brief Runs the game in capture mode.
+	 *
+	 * @return 'true' if the game exited successfully, which includes matching the golden image if one is given.
+	 */
+	auto RunCapture(const Options& options, const std::filesystem::path& viewPath, const std::filesystem::path& capturePath, const std::filesystem::path& goldenPath) -> bool
+	{
+		std::string command = Quote(options.GamePath) + " --replay " + Quote(viewPath) + " --capture " + Quote(capturePath);
+		if(!goldenPath.empty())
+		{
+			command += " --golden " + Quote(goldenPath);
+		}
+
+#if defined(_WIN32)
+		// 'cmd' strips the first and the last quote of a command starting with one
+		command = "\"" + command + "\"";
+#endif
+
+		std::fflush(stdout);
+
+		return std::system(command.c_str()) == 0;
+	}
+}
+
+/**
+ * @brief Renders every capture case with the game and compares it to its golden image.
+ *
+ * Runs from the repository root, the game loads its config and resources from there.
+ * '--update' records the golden images instead, they depend on the GL implementation, so CI's is the reference.
+ */
+auto main(int argc, char* argv[]) -> int
+{
+	Options options = ParseOptions(argc, argv);
+
+	if(!std::filesystem::exists(options.GamePath))
+	{
+		std::printf("The game '%s' doesn't exist, build it first\n", options.GamePath.string().c_str());
+
+		return 1;
+	}
+
+	std::vector<std::filesystem::path> viewPaths;
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(CaseDirectory))
+	{
+		if(entry.path().extension() == ".toml")
+		{
+			viewPaths.push_back(entry.path());
+		}
+	}
+
+	std::ranges::sort(viewPaths);
+
+	std::filesystem::create_directories(options.OutputDirectory);
+
+	bool hasPassed = !viewPaths.empty();
+	if(viewPaths.empty())
+	{
+		std::printf("No capture cases in '%s'\n", CaseDirectory.string().c_str());
+	}
+
+	for(const std::filesystem::path& viewPath : viewPaths)
+	{
+		std::string name = viewPath.stem().string();
+		std::filesystem::path goldenPath = std::filesystem::path(viewPath).replace_extension(".png");
+		std::filesystem::path capturePath = options.OutputDirectory / (name + ".png");
+
+		if(options.IsUpdating)
+		{
+			std::error_code error;
+			if(RunCapture(options, viewPath, capturePath, {}) && std::filesystem::copy_file(capturePath, goldenPath, std::filesystem::copy_options::overwrite_existing, error))
+			{
+				std::printf("[%s] Recorded '%s'\n", name.c_str(), goldenPath.string().c_str());
+			}
+			else
+			{
+				std::printf("[%s] Failed: couldn't record the golden image\n", name.c_str());
+				hasPassed = false;
+			}
+
+			continue;
+		}
+
+		if(!std::filesystem::exists(goldenPath))
+		{
+			std::printf("[%s] Failed: the golden image '%s' is missing, record it with '--update'\n", name.c_str(), goldenPath.string().c_str());
+			hasPassed = false;
+
+			continue;
+		}
+
+		if(!RunCapture(options, viewPath, capturePath, goldenPath))
+		{
+			std::filesystem::path reportPath = std::filesystem::path(capturePath).replace_extension(".json");
+			std::filesystem::path maskPath = std::filesystem::path(capturePath).replace_extension(".diff.png");
+
+			std::printf("[%s] Failed: the capture doesn't match, see '%s' and '%s'\n", name.c_str(), reportPath.string().c_str(), maskPath.string().c_str());
+			hasPassed = false;
+		}
+	}
+
+	std::printf(hasPassed ? "All captures passed\n" : "Some captures failed\n");
+
+	return hasPassed ? 0 : 1;
+}
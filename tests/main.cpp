@@ -0,0 +1,26 @@
+#include "Tests.h"
+
+#include <cstdio>
+
+auto main() -> int
+{
+	bool hasPassed = true;
+
+	hasPassed &= RunChunkAllocatorTests();
+	hasPassed &= RunChunkCompressionTests();
+	hasPassed &= RunChunkGridTests();
+	hasPassed &= RunChunkLoadQueueTests();
+	hasPassed &= RunChunkStoreTests();
+	hasPassed &= RunConfigTests();
+	hasPassed &= RunJobSystemTests();
+	hasPassed &= RunMpscQueueTests();
+	hasPassed &= RunFrustumTests();
+	hasPassed &= RunResolutionControllerTests();
+	hasPassed &= RunCoarseDepthTests();
+	hasPassed &= RunToroidalGridTests();
+	hasPassed &= RunNoiseTests();
+
+	std::printf(hasPassed ? "All tests passed\n" : "Some tests failed\n");
+
+	return hasPassed ? 0 : 1;
+}